@@ -0,0 +1,215 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LOGERR BENCHMARKS
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+//
+/// @file	logerrBenchmarks.cpp
+/// @brief	Wall-clock benchmarks of the logging front end.
+/// @details
+///		Each benchmark runs its body a fixed number of times and reports nanoseconds per operation.
+///		Pass a substring on the command line to run only the benchmarks whose names contain it.
+///		Numbers are only meaningful from a Release build.
+//
+//--------------------------------------------------------------------------------------------------
+
+//----------------------------
+//  INCLUDES
+//----------------------------
+
+#include <FlightRecorder.h>
+#include <LineBuffer.h>
+#include <LogFileWriter.h>
+#include <LogStream.h>
+#include <logerrMacros.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+	constexpr int charactersPerLine = 64;
+
+	struct Benchmark
+	{
+		std::string_view                 name;
+		std::size_t                      iterations;
+		std::function<void(std::size_t)> run;    ///< runs the measured operation `iterations` times.
+	};
+
+	struct Result
+	{
+		std::string_view name;
+		double           nanosecondsPerOperation;
+	};
+
+	Result measure(const Benchmark& benchmark)
+	{
+		benchmark.run(benchmark.iterations / 10);    // warm-up: first-use allocations, thread rings, caches
+
+		const auto start = std::chrono::steady_clock::now();
+		benchmark.run(benchmark.iterations);
+		const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+		return {benchmark.name, elapsed.count() / static_cast<double>(benchmark.iterations)};
+	}
+
+	std::string benchmarkFile()
+	{
+		return (std::filesystem::temp_directory_path() / "logerrBenchmark.log").string();
+	}
+
+	void removeBenchmarkFile()
+	{
+		std::error_code ignored;
+		std::filesystem::remove(benchmarkFile(), ignored);
+	}
+
+	// Includes the writer's shutdown, so the time covers every line reaching the file.
+	void writeLogFile(std::size_t iterations, LogFileWriter::Backend backend)
+	{
+		{
+			LogFileWriter::Options options;
+			options.backend = backend;
+			LogFileWriter writer(benchmarkFile(), options);
+			for (std::size_t i = 0; i < iterations; ++i)
+				writer.write(std::string(charactersPerLine - 1, 'x') + '\n');
+		}
+		removeBenchmarkFile();
+	}
+
+	// One line of single-character inserts, the way `<< ' '` and `<< '\n'` reach a stream buffer.
+	void writeCharacters(std::ostream& os)
+	{
+		for (int i = 0; i < charactersPerLine - 1; ++i)
+			os << 'x';
+		os << '\n';
+	}
+}    // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+//  main
+//----------------------------------------------------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+	const std::string_view filter = argc > 1 ? argv[1] : "";
+
+	const std::vector<Benchmark> benchmarks{
+	    {"chars/LogStream (shared, no put area)", 100'000,
+	     [](std::size_t iterations)
+	     {
+		     std::ostringstream target;
+		     LogStream          logger(target);
+		     logger.registerLogFunction("null", [](std::string_view) {});
+		     for (std::size_t i = 0; i < iterations; ++i)
+			     writeCharacters(target);
+		     logger.flush();
+	     }},
+	    {"chars/LineBuffer (thread-owned put area)", 100'000,
+	     [](std::size_t iterations)
+	     {
+		     LineBuffer   buffer;
+		     std::ostream os(&buffer);
+		     for (std::size_t i = 0; i < iterations; ++i)
+		     {
+			     writeCharacters(os);
+			     buffer.discard(buffer.pending().size());
+		     }
+	     }},
+	    {"line/LOGINFO (per-thread logerr::stream)", 100'000,
+	     [](std::size_t iterations)
+	     {
+		     LogStream logger(std::cout);
+		     logger.registerLogFunction("null", [](std::string_view) {});
+		     for (std::size_t i = 0; i < iterations; ++i)
+			     LOGINFO << "iteration " << i << ' ' << 3.25 << std::endl;
+		     logger.flush();
+	     }},
+	    {"file/std::ofstream flush per line", 200'000,
+	     [](std::size_t iterations)
+	     {
+		     // the writer's original path: an unbuffered stream, one write(2) per line
+		     std::ofstream file;
+		     file.rdbuf()->pubsetbuf(nullptr, 0);
+		     file.open(benchmarkFile(), std::ios::out | std::ios::app);
+		     for (std::size_t i = 0; i < iterations; ++i)
+		     {
+			     file << std::string(charactersPerLine - 1, 'x') + '\n';
+			     file.flush();
+		     }
+		     file.close();
+		     removeBenchmarkFile();
+	     }},
+	    {"file/LogFileWriter group commit (Append)", 200'000,
+	     [](std::size_t iterations) { writeLogFile(iterations, LogFileWriter::Backend::Append); }},
+	    {"file/LogFileWriter group commit (Mapped)", 200'000,
+	     [](std::size_t iterations) { writeLogFile(iterations, LogFileWriter::Backend::Mapped); }},
+	    {"file/LogFileWriter group commit (Uring)", 200'000,
+	     [](std::size_t iterations) { writeLogFile(iterations, LogFileWriter::Backend::Uring); }},
+	    {"file/FlightRecorder record", 1'000'000,
+	     [](std::size_t iterations)
+	     {
+		     const std::string line(charactersPerLine - 1, 'x');
+		     {
+			     FlightRecorder recorder(benchmarkFile());
+			     for (std::size_t i = 0; i < iterations; ++i)
+				     recorder.record(line);
+		     }
+		     removeBenchmarkFile();
+	     }},
+	    {"line/logerr::stream (no prefix)", 100'000,
+	     [](std::size_t iterations)
+	     {
+		     LogStream     logger(std::cout);
+		     std::ostream& os = logerr::stream(logerr::Level::Info);
+		     logger.registerLogFunction("null", [](std::string_view) {});
+		     for (std::size_t i = 0; i < iterations; ++i)
+			     os << "iteration " << i << ' ' << 3.25 << std::endl;
+		     logger.flush();
+	     }},
+	    {"line/std::cout captured by LogStream (no prefix)", 100'000,
+	     [](std::size_t iterations)
+	     {
+		     LogStream logger(std::cout);
+		     logger.registerLogFunction("null", [](std::string_view) {});
+		     for (std::size_t i = 0; i < iterations; ++i)
+			     std::cout << "iteration " << i << ' ' << 3.25 << std::endl;
+		     logger.flush();
+	     }},
+	};
+
+	std::vector<Result> results;
+	for (const Benchmark& benchmark : benchmarks)
+	{
+		if (benchmark.name.find(filter) != std::string_view::npos)
+			results.push_back(measure(benchmark));
+	}
+
+	for (const Result& result : results)
+		std::printf("%-48.*s %10.1f ns/op\n", static_cast<int>(result.name.size()), result.name.data(), result.nanosecondsPerOperation);
+	return 0;
+}
@@ -0,0 +1,127 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LOGERR STARTUP BENCHMARK
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+//
+/// @file	logerrStartupBenchmark.cpp
+/// @brief	The latency of a process's first stack trace, with and without logerr::prewarmSymbols().
+/// @details
+///		Symbol tables, once loaded, stay loaded, so every sample is a fresh process: the benchmark runs
+///		itself with `--child cold` or `--child prewarm`. The child optionally starts the prewarm, spends
+///		a simulated start-up doing its own work, then takes one stack trace - what the first ERR of a
+///		process pays - and reports how long it took. Pass the start-up in milliseconds on the command
+///		line (250 by default). POSIX only.
+//
+//--------------------------------------------------------------------------------------------------
+
+//----------------------------
+//  INCLUDES
+//----------------------------
+
+#include <StackTrace.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	constexpr int samples = 7;
+
+	struct Sample
+	{
+		double microseconds = 0;
+		bool   ready        = false;    ///< the prewarm had finished when the trace was taken.
+	};
+
+	// The child: start-up, then the first trace.
+	int runChild(std::string_view mode, int startupMilliseconds)
+	{
+		if (mode == "prewarm")
+			logerr::prewarmSymbols();
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(startupMilliseconds));
+
+		const bool                                      ready = logerr::symbolsReady();
+		const auto                                      start = std::chrono::steady_clock::now();
+		const StackTrace                                trace;
+		const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+		std::printf("%f %d %zu\n", elapsed.count(), ready ? 1 : 0, std::string(trace).size());
+		return 0;
+	}
+
+	std::vector<Sample> runChildren(const std::filesystem::path& self, std::string_view mode, int startupMilliseconds)
+	{
+		const std::string   command = '"' + self.string() + "\" --child " + std::string(mode) + ' ' + std::to_string(startupMilliseconds);
+		std::vector<Sample> results;
+		for (int i = 0; i < samples; ++i)
+		{
+			FILE* child = ::popen(command.c_str(), "r");
+			if (!child)
+				break;
+			Sample      sample;
+			int         ready = 0;
+			std::size_t bytes = 0;
+			if (std::fscanf(child, "%lf %d %zu", &sample.microseconds, &ready, &bytes) == 3 && bytes != 0)
+			{
+				sample.ready = ready != 0;
+				results.push_back(sample);
+			}
+			::pclose(child);
+		}
+		return results;
+	}
+
+	void report(std::string_view name, std::vector<Sample> results)
+	{
+		if (results.empty())
+		{
+			std::printf("%-32.*s %s\n", static_cast<int>(name.size()), name.data(), "no samples");
+			return;
+		}
+		std::sort(results.begin(), results.end(), [](const Sample& a, const Sample& b) { return a.microseconds < b.microseconds; });
+		const auto ready = std::count_if(results.begin(), results.end(), [](const Sample& sample) { return sample.ready; });
+		std::printf("%-32.*s %10.1f us median %10.1f us min   (%td/%zu ready)\n", static_cast<int>(name.size()), name.data(),
+		            results[results.size() / 2].microseconds, results.front().microseconds, ready, results.size());
+	}
+}    // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+//  main
+//----------------------------------------------------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+	if (argc > 3 && std::string_view(argv[1]) == "--child")
+		return runChild(argv[2], std::atoi(argv[3]));
+
+	const int                   startupMilliseconds = argc > 1 ? std::atoi(argv[1]) : 250;
+	const std::filesystem::path self                = std::filesystem::read_symlink("/proc/self/exe");
+
+	report("first trace (cold)", runChildren(self, "cold", startupMilliseconds));
+	report("first trace (prewarmed)", runChildren(self, "prewarm", startupMilliseconds));
+	return 0;
+}
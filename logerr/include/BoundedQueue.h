@@ -0,0 +1,331 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	BOUNDED QUEUE
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+//
+/// @file	BoundedQueue.h
+/// @brief	A multi-producer, single-consumer log queue with a capacity and an overflow policy.
+/// @details
+///		When the consumer (a disk, a symbolizer) falls behind, an unbounded queue turns a logging
+///		burst into an unbounded allocation. A BoundedQueue caps the entries and bytes it holds and,
+///		once full, applies its QueueLimits::policy to each new entry: wait for room, drop it, drop
+///		the oldest entry instead, or drop it only if it is below a level. No wait is unbounded: a
+///		producer may be a sink on the LogStream backend, and a wait there stalls every other sink and,
+///		once their rings fill, every logging thread. Every drop is counted; the
+///		consumer collects the count with takeDroppedIfEmpty() once it has caught up and logs it
+///		(see logerr::droppedLinesNotice), so a gap in the log is never silent.
+//
+//--------------------------------------------------------------------------------------------------
+
+#pragma once
+#ifndef BoundedQueue_h_
+#define BoundedQueue_h_
+
+//-------------------------
+//	INCLUDES
+//-------------------------
+
+#include <logLevel.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <utility>
+
+//--------------------------------------------------------------------------------------------------
+//	OverflowPolicy / QueueLimits
+//--------------------------------------------------------------------------------------------------
+
+/// What a producer does with a new entry when the queue is full.
+enum class OverflowPolicy
+{
+	Block,             ///< wait up to QueueLimits::blockTimeout for room, then drop the new entry.
+	DropNewest,        ///< drop the new entry.
+	DropOldest,        ///< drop the oldest queued entry to make room.
+	/// drop the new entry if it is below QueueLimits::keepFrom, else treat it as Block does. An ERROR is never waited for
+	/// and never dropped: it is queued past the limits.
+	DropBelowLevel,
+};
+
+/// A queue's capacity and overflow policy. A zero limit is no limit.
+struct QueueLimits
+{
+	std::size_t               maxEntries   = 0;                                ///< entries held at most.
+	std::size_t               maxBytes     = 0;                                ///< payload bytes held at most.
+	OverflowPolicy            policy       = OverflowPolicy::Block;
+	std::chrono::milliseconds blockTimeout = std::chrono::milliseconds(100);   ///< the longest a push waits for room.
+	logerr::Level             keepFrom     = logerr::Level::Warning;           ///< OverflowPolicy::DropBelowLevel's floor.
+};
+
+namespace logerr
+{
+	/// @brief		The synthetic record a consumer writes after catching up: "[ts] [app] [WARNING]  N lines dropped (...)".
+	/// @param[in]	dropped	how many entries were dropped.
+	/// @param[in]	where	which queue dropped them, e.g. "log file queue full".
+	std::string droppedLinesNotice(std::size_t dropped, std::string_view where);
+}    // namespace logerr
+
+//--------------------------------------------------------------------------------------------------
+//	BoundedQueue
+//--------------------------------------------------------------------------------------------------
+template<class T>
+class BoundedQueue
+{
+public:
+	explicit BoundedQueue(QueueLimits limits = {})
+	    : m_limits(limits)
+	{
+	}
+
+	BoundedQueue(const BoundedQueue&)            = delete;
+	BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+	/// Change the capacity and policy. Applies to entries pushed from now on.
+	void setLimits(const QueueLimits& limits)
+	{
+		{
+			const std::lock_guard lock(m_mutex);
+			m_limits = limits;
+		}
+		m_notFull.notify_all();
+	}
+
+	[[nodiscard]] QueueLimits limits() const
+	{
+		const std::lock_guard lock(m_mutex);
+		return m_limits;
+	}
+
+	//----------------------------
+	//  PRODUCERS
+	//----------------------------
+
+	/// @brief		Queue @p item, applying the overflow policy if the queue is full.
+	/// @param[in]	bytes	the item's payload size, counted against QueueLimits::maxBytes.
+	/// @param[in]	level	the item's level, for OverflowPolicy::DropBelowLevel.
+	/// @return		false if @p item was dropped (or the queue is closed).
+	/// @details	An item larger than maxBytes is still accepted into an otherwise empty queue, so it cannot wait forever.
+	///				Once a wait has timed out, later pushes that would wait are dropped at once until the consumer takes
+	///				an entry: a stalled consumer costs its producers one timeout, not one per entry.
+	bool push(T item, std::size_t bytes, logerr::Level level)
+	{
+		std::unique_lock lock(m_mutex);
+		if (m_closed)
+			return false;
+
+		if (!fits(bytes))
+		{
+			switch (m_limits.policy)
+			{
+				case OverflowPolicy::Block:
+					if (!waitForRoom(lock, bytes))
+						return drop();
+					break;
+				case OverflowPolicy::DropNewest: return drop();
+				case OverflowPolicy::DropOldest:
+					while (!fits(bytes) && evictOldest())
+						++m_dropped;
+					break;
+				case OverflowPolicy::DropBelowLevel:
+					if (level >= logerr::Level::Error)
+						break;
+					if (level < m_limits.keepFrom || !waitForRoom(lock, bytes))
+						return drop();
+					break;
+			}
+		}
+
+		m_queue.push_back({std::move(item), bytes, false});
+		++m_entries;
+		m_bytes += bytes;
+		lock.unlock();
+		m_notEmpty.notify_one();
+		return true;
+	}
+
+	/// @brief		Queue @p item outside the limits: it is never waited for, dropped or counted. For control entries such
+	///				as flush barriers, which must reach the consumer no matter how full the queue is.
+	void pushPinned(T item)
+	{
+		{
+			const std::lock_guard lock(m_mutex);
+			m_queue.push_back({std::move(item), 0, true});
+		}
+		m_notEmpty.notify_one();
+	}
+
+	/// @brief		Stop accepting entries: every later push() is dropped, and producers waiting for room give up.
+	/// @details	For a consumer that exits early, so that nobody waits on it forever. Queued entries can still be popped.
+	void close()
+	{
+		{
+			const std::lock_guard lock(m_mutex);
+			m_closed = true;
+		}
+		m_notFull.notify_all();
+	}
+
+	//----------------------------
+	//  CONSUMER
+	//----------------------------
+
+	/// @brief		Block until an item is available or stop is requested, then pop one item.
+	/// @details	Queued data wins over stop, so repeated calls drain everything accepted before shutdown.
+	bool wait_pop(T& destination, std::stop_token stop)
+	{
+		std::unique_lock lock(m_mutex);
+		if (!m_notEmpty.wait(lock, stop, [this] { return !m_queue.empty(); }))
+			return false;
+		popFront(destination, lock);
+		return true;
+	}
+
+	/// @brief		Like wait_pop(), but also gives up at @p deadline.
+	template<class Clock, class Duration>
+	bool wait_pop_until(T& destination, std::stop_token stop, const std::chrono::time_point<Clock, Duration>& deadline)
+	{
+		std::unique_lock lock(m_mutex);
+		if (!m_notEmpty.wait_until(lock, stop, deadline, [this] { return !m_queue.empty(); }))
+			return false;
+		popFront(destination, lock);
+		return true;
+	}
+
+	/// @brief		Dequeue everything queued, appending it to @p destination in order, under one lock. Does not block.
+	/// @return		the number of items dequeued.
+	template<class Container>
+	std::size_t pop_all(Container& destination)
+	{
+		std::unique_lock  lock(m_mutex);
+		const std::size_t count = m_queue.size();
+		for (Slot& slot : m_queue)
+			destination.push_back(std::move(slot.item));
+		m_queue.clear();
+		m_entries = 0;
+		m_bytes   = 0;
+		m_stalled = false;
+		lock.unlock();
+		if (count != 0)
+			m_notFull.notify_all();
+		return count;
+	}
+
+	/// @brief		The number of entries dropped since the last call, once the queue has drained; 0 while it still holds
+	///				entries (the pressure has not cleared yet) or when nothing was dropped.
+	std::size_t takeDroppedIfEmpty()
+	{
+		const std::lock_guard lock(m_mutex);
+		return m_queue.empty() ? std::exchange(m_dropped, 0) : 0;
+	}
+
+	[[nodiscard]] std::size_t size() const
+	{
+		const std::lock_guard lock(m_mutex);
+		return m_queue.size();
+	}
+
+	[[nodiscard]] bool empty() const
+	{
+		const std::lock_guard lock(m_mutex);
+		return m_queue.empty();
+	}
+
+private:
+	struct Slot
+	{
+		T           item;
+		std::size_t bytes;
+		bool        pinned;    ///< outside the limits (pushPinned).
+	};
+
+	/// Whether an item of @p bytes fits now. Caller holds m_mutex.
+	[[nodiscard]] bool fits(std::size_t bytes) const noexcept
+	{
+		const bool entriesFit = m_limits.maxEntries == 0 || m_entries < m_limits.maxEntries;
+		const bool bytesFit   = m_limits.maxBytes == 0 || m_bytes + bytes <= m_limits.maxBytes || m_entries == 0;
+		return entriesFit && bytesFit;
+	}
+
+	/// @brief		Wait up to blockTimeout for room for @p bytes, unless an earlier wait has already timed out on the
+	///				same stall. Caller holds m_mutex through @p lock.
+	/// @return		false if there is still no room (or the queue was closed).
+	bool waitForRoom(std::unique_lock<std::mutex>& lock, std::size_t bytes)
+	{
+		if (m_stalled)
+			return false;
+		if (!m_notFull.wait_for(lock, m_limits.blockTimeout, [&] { return m_closed || fits(bytes); }))
+			m_stalled = true;
+		return !m_closed && fits(bytes);
+	}
+
+	/// Count a dropped new entry. Caller holds m_mutex.
+	bool drop() noexcept
+	{
+		++m_dropped;
+		return false;
+	}
+
+	/// Remove the oldest counted entry. Caller holds m_mutex. Returns false if there is none.
+	bool evictOldest()
+	{
+		const auto oldest = std::find_if(m_queue.begin(), m_queue.end(), [](const Slot& slot) { return !slot.pinned; });
+		if (oldest == m_queue.end())
+			return false;
+		--m_entries;
+		m_bytes -= oldest->bytes;
+		m_queue.erase(oldest);
+		return true;
+	}
+
+	void popFront(T& destination, std::unique_lock<std::mutex>& lock)
+	{
+		Slot& front = m_queue.front();
+		destination = std::move(front.item);
+		if (!front.pinned)
+		{
+			--m_entries;
+			m_bytes -= front.bytes;
+		}
+		m_queue.pop_front();
+		m_stalled = false;
+		lock.unlock();
+		m_notFull.notify_all();    // waiting producers may need different amounts of room
+	}
+
+	mutable std::mutex          m_mutex;
+	std::condition_variable_any m_notEmpty;
+	std::condition_variable_any m_notFull;
+	std::deque<Slot>            m_queue;
+	QueueLimits                 m_limits;
+	std::size_t                 m_entries = 0;        ///< unpinned entries queued.
+	std::size_t                 m_bytes   = 0;        ///< their payload bytes.
+	std::size_t                 m_dropped = 0;        ///< drops not yet collected by takeDroppedIfEmpty().
+	bool                        m_closed  = false;
+	bool                        m_stalled = false;    ///< a wait for room timed out and the consumer has not taken an entry since.
+};
+
+#endif    // BoundedQueue_h_
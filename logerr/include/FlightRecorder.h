@@ -0,0 +1,116 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	FLIGHT RECORDER
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+//
+/// @file	FlightRecorder.h
+/// @brief	The most recent log records, kept in a file-backed ring that outlives a crash.
+/// @details
+///		A crash loses whatever the log file writer and the trace worker still had queued. The flight
+///		recorder is a LogStream sink that copies every record, as the backend dispatches it, into a
+///		fixed-size circular buffer in a shared file mapping: a memcpy, no syscall and no flush. The
+///		pages belong to the kernel's page cache, so the records are still in the file after the
+///		process dies however it dies (not after the machine does).
+///
+///		The crash handler appends the last seconds of the ring to its crash dump, and
+///		`logerr-recover <file>.flight [seconds]` prints them after the fact - from
+///		`<file>.flight.prev` once the application has been restarted. The file is
+///
+///			header (64 bytes):  "LOGERRF1", ring capacity, head, tail
+///			ring:               records of  length (u32), unused (u32), time (i64 ns), text, padded to 8 bytes
+///
+///		head and tail are byte counts that only grow; a record lives at (position % capacity). A
+///		record that would straddle the end of the ring is preceded by a pad marker (length
+///		0xFFFFFFFF) and starts over at 0. The writer moves the tail past the records it is about to
+///		overwrite before it writes, and publishes a record by moving the head once it is complete,
+///		so a reader never sees a torn record. Integers are in the writer's byte order. POSIX only:
+///		elsewhere the recorder never opens and recording is a no-op.
+//
+//--------------------------------------------------------------------------------------------------
+
+#pragma once
+#ifndef FlightRecorder_h_
+#define FlightRecorder_h_
+
+//-------------------------
+//	INCLUDES
+//-------------------------
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+//--------------------------------------------------------------------------------------------------
+//	FlightRecorder
+//--------------------------------------------------------------------------------------------------
+class FlightRecorder
+{
+public:
+	static constexpr std::size_t      defaultCapacity = 4 * 1024 * 1024;
+	static constexpr std::string_view previousSuffix  = ".prev";    ///< appended to the path of the previous run's file.
+
+	/// @brief		Open (or create) the recorder file and map it.
+	/// @param[in]	path			the file; empty for "<logDir><app>.flight", or "<logDir><app>_<pid>.flight" while
+	///								another live process of the same application holds that one.
+	/// @param[in]	capacityBytes	the ring's size.
+	/// @details	Every run starts with an empty ring. A file an earlier run left records in is first renamed to
+	///				"<path>.prev" (replacing the one before it), so a crash's records survive the restart after it. The
+	///				most recently opened recorder becomes active() for the crash handler.
+	explicit FlightRecorder(std::string path = "", std::size_t capacityBytes = defaultCapacity);
+	~FlightRecorder();
+
+	FlightRecorder(const FlightRecorder&)            = delete;
+	FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+	/// false if the file could not be created or mapped; record() then does nothing.
+	[[nodiscard]] bool isOpen() const noexcept { return m_map != nullptr; }
+
+	/// The recorder file.
+	[[nodiscard]] const std::string& path() const noexcept { return m_path; }
+
+	/// @brief		Copy @p record into the ring, stamped now, overwriting the oldest records as needed.
+	/// @details	Single writer: call it from one thread at a time (as a LogStream sink, the backend). Text beyond a
+	///				quarter of the ring is cut off.
+	void record(std::string_view record) noexcept;
+
+	/// @brief		The records stamped within @p window of the newest one, oldest first, as one string.
+	/// @details	Safe to call while another thread records; this is what the crash handler calls.
+	[[nodiscard]] std::string recent(std::chrono::nanoseconds window) const;
+
+	/// @brief		recent() for a recorder file another process left behind.
+	/// @return		empty if @p path is missing or is not a flight recorder.
+	static std::string recover(const std::filesystem::path& path, std::chrono::nanoseconds window);
+
+	/// The recorder the crash handler reads: the most recently opened one still alive, or nullptr.
+	static const FlightRecorder* active() noexcept;
+
+private:
+	std::string    m_path;
+	int            m_fd       = -1;
+	std::byte*     m_map      = nullptr;
+	std::size_t    m_mapBytes = 0;
+	std::uint64_t  m_capacity = 0;
+};
+
+#endif    // FlightRecorder_h_
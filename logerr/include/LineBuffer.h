@@ -0,0 +1,88 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LINE BUFFER
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+//
+/// @file	LineBuffer.h
+/// @brief	A growable, single-thread stream buffer that stages a log line before it becomes a record.
+/// @details
+///		A LineBuffer has a real put area, so a std::ostream writing to it stores single characters
+///		and short strings with an inline pointer bump - the virtual overflow() runs only when the
+///		buffer has to grow, which it does geometrically and never shrinks below its start size.
+///		The owner decides where records end and takes the staged bytes with take() or discard().
+///
+///		A LineBuffer belongs to exactly one thread. A stream buffer's put-area pointers are plain
+///		members, so one that several threads write to concurrently (std::cout's LogStream) cannot
+///		have a put area at all; it stages into its caller's thread-local LineBuffer instead.
+//
+//--------------------------------------------------------------------------------------------------
+
+#pragma once
+#ifndef LineBuffer_h_
+#define LineBuffer_h_
+
+//-------------------------
+//	INCLUDES
+//-------------------------
+
+#include <cstddef>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+//--------------------------------------------------------------------------------------------------
+//	LineBuffer
+//--------------------------------------------------------------------------------------------------
+class LineBuffer : public std::basic_streambuf<char>
+{
+public:
+	static constexpr std::size_t defaultCapacity = 256;    ///< bytes staged before the first growth.
+
+	explicit LineBuffer(std::size_t capacity = defaultCapacity);
+
+	LineBuffer(const LineBuffer&)            = delete;
+	LineBuffer& operator=(const LineBuffer&) = delete;
+
+	/// The bytes written and not yet taken or discarded.
+	[[nodiscard]] std::string_view pending() const noexcept
+	{
+		return {pbase(), static_cast<std::size_t>(pptr() - pbase())};
+	}
+
+	/// Drop the first @p length pending bytes, keeping the rest (and the buffer's allocation).
+	void discard(std::size_t length) noexcept;
+
+	/// @brief		Remove the first @p length pending bytes and return them as a string.
+	/// @details	Taking everything hands the buffer itself over, with no copy; the LineBuffer starts a new one.
+	std::string take(std::size_t length);
+
+protected:
+	int_type        overflow(int_type v) override;
+	std::streamsize xsputn(const char* p, std::streamsize n) override;
+
+private:
+	void reserve(std::size_t size);
+
+	std::size_t m_capacity;
+	std::string m_buffer;    ///< the put area's storage: [pbase(), epptr()) is m_buffer's full length.
+};
+
+#endif    // LineBuffer_h_
@@ -0,0 +1,143 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LOG ARCHIVER
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+//
+/// @file	LogArchiver.h
+/// @brief	Compresses closed log segments and enforces a retention budget, off the writer's thread.
+/// @details
+///		A rotating LogFileWriter closes a segment and moves straight on to the next one; the closed
+///		segment is handed to a LogArchiver, whose own low-priority thread compresses it and then
+///		deletes the oldest segments of the series until the budget holds. A series is every file in
+///		the live segment's directory whose name starts with the series prefix and carries the log
+///		extension, compressed or not, so the segments of earlier runs count against the budget too.
+///		The live segment itself is never touched, nor is any segment another writer holds a
+///		SegmentLock on - the live segment of another instance sharing the directory.
+//
+//--------------------------------------------------------------------------------------------------
+
+#pragma once
+#ifndef LogArchiver_h_
+#define LogArchiver_h_
+
+//-------------------------
+//	INCLUDES
+//-------------------------
+
+#include <concurrent_queue.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <thread>
+
+//--------------------------------------------------------------------------------------------------
+//	Compression / RetentionLimits
+//--------------------------------------------------------------------------------------------------
+
+/// How closed segments are compressed. A compressor this build lacks falls back to the next one down.
+enum class Compression
+{
+	None,    ///< closed segments stay plain text.
+	Gzip,    ///< `.gz`, when built with zlib.
+	Zstd,    ///< `.zst`, when built with zstd; else Gzip.
+};
+
+/// How much of a series is kept. A zero limit is no limit.
+struct RetentionLimits
+{
+	std::uint64_t maxBytes = 0;    ///< total bytes of the closed segments kept.
+	std::size_t   maxFiles = 0;    ///< closed segments kept.
+};
+
+//--------------------------------------------------------------------------------------------------
+//	LogArchiver
+//--------------------------------------------------------------------------------------------------
+class LogArchiver
+{
+public:
+	/// @param[in]	directory	where the series lives.
+	/// @param[in]	prefix		the file-name prefix every segment of the series shares.
+	/// @param[in]	extension	the plain segments' extension, e.g. ".log.txt".
+	/// @param[in]	liveSegment	the segment being written, which the first retention pass must leave alone.
+	/// @details	Starts the archiving thread, which begins with a retention pass over what earlier runs left.
+	LogArchiver(std::filesystem::path directory, std::string prefix, std::string extension, Compression compression,
+	            RetentionLimits retention, std::filesystem::path liveSegment);
+
+	/// Finishes every segment already handed over, then stops.
+	~LogArchiver();
+
+	LogArchiver(const LogArchiver&)            = delete;
+	LogArchiver& operator=(const LogArchiver&) = delete;
+
+	/// @brief		Queue a closed segment for compression and a retention pass. Does not block.
+	/// @param[in]	liveSegment	the segment now being written, which retention must leave alone.
+	void archive(std::filesystem::path closedSegment, std::filesystem::path liveSegment);
+
+	/// @brief		Held by a writer on its live segment for as long as it writes it, so no archiver - its own, or
+	///				another process's sharing the directory - deletes the segment under it.
+	/// @details	An advisory lock (flock) on POSIX. Elsewhere it does nothing: a file another writer has open
+	///				cannot be deleted there anyway.
+	class SegmentLock
+	{
+	public:
+		SegmentLock() = default;
+		explicit SegmentLock(const std::filesystem::path& segment);
+		SegmentLock(SegmentLock&& other) noexcept;
+		SegmentLock& operator=(SegmentLock&& other) noexcept;
+		~SegmentLock();
+
+	private:
+		int m_fd = -1;
+	};
+
+	/// The compression this build actually applies when @p requested is asked for.
+	static Compression available(Compression requested) noexcept;
+
+	/// The extension a segment compressed with @p compression gains: ".gz", ".zst", or "" for None.
+	static std::string_view extension(Compression compression) noexcept;
+
+	/// @brief		Compress @p segment into a sibling with the compression's extension, then remove the original.
+	/// @return		the path of the compressed file; @p segment itself if it was left as it is (None, or a failure).
+	static std::filesystem::path compress(const std::filesystem::path& segment, Compression compression);
+
+private:
+	struct Job
+	{
+		std::filesystem::path closedSegment;
+		std::filesystem::path liveSegment;
+	};
+
+	/// Delete the series' oldest closed segments until the retention limits hold.
+	void enforceRetention(const std::filesystem::path& liveSegment) const;
+
+	std::filesystem::path  m_directory;
+	std::string            m_prefix;
+	std::string            m_extension;
+	Compression            m_compression;
+	RetentionLimits        m_retention;
+	concurrent_queue<Job>  m_jobs;
+	std::jthread           m_thread;
+};
+
+#endif    // LogArchiver_h_
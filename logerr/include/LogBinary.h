@@ -0,0 +1,158 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LOG BINARY
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+//
+/// @file	LogBinary.h
+/// @brief	A compact binary log: call-site metadata once per file, then a few varint bytes per record.
+/// @details
+///		A text line repeats its timestamp, application name, level label and, for a warning, the
+///		file and function on every record. A binary log states each of those once, in a string
+///		table and a site table written the first time an entry needs them, and stores per record
+///		only what changes: the site id, the thread id, the timestamp as a delta from the previous
+///		record's, and the message - for a deferred (LOG*_FMT) record, the raw arguments alone.
+///
+///			"LOGERRB1"
+///			session:   0x01 version                          forget every earlier definition
+///			string:    0x02 id length bytes
+///			site:      0x03 id level prefix format signature file line function    (string ids; 0 = none)
+///			text:      0x04 site thread timeDelta length message
+///			deferred:  0x05 site thread timeDelta length arguments
+///			raw:       0x06 length bytes                     a line kept as it is
+///
+///		Numbers are LEB128 varints and time deltas (nanoseconds) zigzag varints. A site's prefix
+///		is the constant text between a line's timestamp and its message, "] [app] [INFO]     ".
+///		Deferred arguments are re-encoded against the site's signature (deferredFormat.h): integers
+///		as varints, strings as a varint length and bytes, floating point as its raw bytes.
+///
+///		LogBinaryDecoder turns the entries back into the exact text the records held, so the
+///		decoded log is what a Format::Text log would have been, byte for byte. The encoder checks
+///		that before relying on it: a line whose timestamp would not render back identically is
+///		kept raw, and a deferred site whose arguments would not format back identically is stored
+///		as text. Timestamps render in the decoding machine's local time zone, so decode with the
+///		TZ the log was written in.
+//
+//--------------------------------------------------------------------------------------------------
+
+#pragma once
+#ifndef LogBinary_h_
+#define LogBinary_h_
+
+//-------------------------
+//	INCLUDES
+//-------------------------
+
+#include <LogRecord.h>
+#include <logSite.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------
+//	LogBinaryEncoder
+//--------------------------------------------------------------------------------------------------
+/// @brief		Encodes records for one binary log file. Not thread-safe; the LogFileWriter worker owns it.
+class LogBinaryEncoder
+{
+public:
+	static constexpr std::string_view magic = "LOGERRB1";
+
+	/// @brief		Start a new file, or a session appended to an existing one: the next encode() begins with the magic
+	///				(if @p emptyFile) and a session entry, and defines every string and site again as it first uses it.
+	void restart(bool emptyFile) noexcept;
+
+	/// Append @p record's entry to @p out, preceded by the definitions it is the first to need.
+	void encode(const LogRecord& record, std::string& out);
+
+private:
+	/// A hash usable with string_view lookups into a map keyed by std::string.
+	struct StringHash
+	{
+		using is_transparent = void;
+		std::size_t operator()(std::string_view text) const noexcept { return std::hash<std::string_view>{}(text); }
+	};
+
+	template<class Value>
+	using StringMap = std::unordered_map<std::string, Value, StringHash, std::equal_to<>>;
+
+	struct DeferredSite
+	{
+		std::uint32_t id      = 0;        ///< 0 while unchecked, or if its arguments do not format back to its records' text.
+		bool          checked = false;
+	};
+
+	bool          encodeDeferred(const LogRecord& record, std::string& out);
+	bool          encodeText(const LogRecord& record, std::string& out);
+	void          encodeRaw(std::string_view text, std::string& out);
+	void          beginEntry(std::string& out);
+	std::uint32_t stringId(std::string_view text, std::string& out);
+	std::uint32_t textSite(std::string_view prefix, logerr::Level level, std::string& out);
+
+	StringMap<std::uint32_t>                              m_strings;
+	StringMap<std::uint32_t>                              m_textSites;    ///< by prefix.
+	std::unordered_map<const logerr::Site*, DeferredSite> m_deferredSites;
+	std::uint32_t                                         m_nextString   = 1;
+	std::uint32_t                                         m_nextSite     = 1;
+	std::int64_t                                          m_previousTime = 0;
+	bool                                                  m_magicDue     = true;
+	bool                                                  m_sessionDue   = true;
+	std::string                                           m_scratch;    ///< a deferred record's arguments, re-encoded.
+};
+
+//--------------------------------------------------------------------------------------------------
+//	LogBinaryDecoder
+//--------------------------------------------------------------------------------------------------
+/// @brief		Turns a binary log back into its text, a chunk at a time.
+class LogBinaryDecoder
+{
+public:
+	/// @brief		Decode the whole entries at the start of @p data, appending their lines to @p out.
+	/// @return		the bytes consumed. The rest is an entry cut off by the end of @p data; pass it again, followed by the
+	///				next chunk of the file.
+	std::size_t decode(std::string_view data, std::string& out);
+
+	/// false once decode() met bytes that are not a binary log; it consumes nothing from then on.
+	[[nodiscard]] bool ok() const noexcept { return m_ok; }
+
+private:
+	struct Site
+	{
+		std::string prefix;
+		std::string format;
+		std::string signature;
+	};
+
+	/// 1 if an entry was decoded, 0 if @p data ends inside it, -1 if it is damaged.
+	int decodeEntry(const char*& in, const char* end, std::string& out);
+
+	std::vector<std::string> m_strings{std::string()};    ///< by id; id 0 is the empty string.
+	std::vector<Site>        m_sites{Site()};
+	std::int64_t             m_previousTime = 0;
+	bool                     m_started      = false;    ///< the magic has been read.
+	bool                     m_ok           = true;
+};
+
+#endif    // LogBinary_h_
@@ -0,0 +1,152 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LOG BLOCKS
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+//
+/// @file	LogBlocks.h
+/// @brief	A seekable, compressed log file: independently compressed blocks plus a time index.
+/// @details
+///		The file is a magic, a run of blocks, and, once the writer closes it, an index footer:
+///
+///			"LOGERRZ1"
+///			block:  header (40 bytes) + the block's records, compressed on their own
+///			...
+///			index:  one 32-byte entry per block: its offset, earliest and latest timestamp, record count
+///			trailer: the index offset, the entry count, "LIDX"
+///
+///		A block header carries the same time range and count, the codec, the raw and stored sizes and
+///		a checksum, so a file whose writer never closed it (a crash) is still readable: the reader,
+///		and a writer reopening the file, rebuild the index by walking the headers and drop a torn last
+///		block. Timestamps are the records' own "[YYYY-mm-dd HH:MM:SS.nnnnnnnnn" stamps, in the writer's
+///		local time; a reader asked for a time window decompresses only the blocks whose range overlaps
+///		it. Integers are little-endian.
+//
+//--------------------------------------------------------------------------------------------------
+
+#pragma once
+#ifndef LogBlocks_h_
+#define LogBlocks_h_
+
+//-------------------------
+//	INCLUDES
+//-------------------------
+
+#include <LogArchiver.h>
+#include <LogFileWriter.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------
+//	LogBlockIndexEntry
+//--------------------------------------------------------------------------------------------------
+
+/// One block of a block log, as its index records it.
+struct LogBlockIndexEntry
+{
+	std::uint64_t                         offset  = 0;    ///< of the block header, from the start of the file.
+	std::chrono::system_clock::time_point first;          ///< the earliest record timestamp in the block.
+	std::chrono::system_clock::time_point last;           ///< the latest.
+	std::uint32_t                         records = 0;
+};
+
+//--------------------------------------------------------------------------------------------------
+//	LogBlockWriter
+//--------------------------------------------------------------------------------------------------
+/// @brief		LogFileWriter's output for Format::Blocks: batches collect into a block, which is compressed and handed
+///				to the underlying output once it holds blockBytes, on sync(), and on close.
+/// @details	A batch is therefore on disk once its block is sealed; Durability::SyncBatch and SyncOnError seal on every
+///				sync, at the cost of smaller blocks. Opening an existing block log strips its index (rebuilt from the
+///				block headers if its writer crashed) and appends; the index is written again on close.
+class LogBlockWriter : public LogFileWriter::Output
+{
+public:
+	using OpenOutput = std::function<std::unique_ptr<LogFileWriter::Output>(const std::string& path)>;
+
+	/// @param[in]	open	opens the underlying output for @p path, once any recovery has trimmed the file.
+	LogBlockWriter(const std::string& path, Compression compression, std::size_t blockBytes, const OpenOutput& open);
+	~LogBlockWriter() override;
+
+	LogBlockWriter(const LogBlockWriter&)            = delete;
+	LogBlockWriter& operator=(const LogBlockWriter&) = delete;
+
+	[[nodiscard]] bool isOpen() const noexcept override;
+	bool               write(std::string_view batch) noexcept override;
+	bool               sync() noexcept override;
+	bool               writeAndSync(std::string_view batch) noexcept override;
+
+private:
+	/// Compress the pending records into a block and write it, syncing after if asked.
+	bool seal(bool syncAfter) noexcept;
+
+	std::unique_ptr<LogFileWriter::Output> m_output;
+	Compression                            m_compression;
+	std::size_t                            m_blockBytes;
+	std::vector<LogBlockIndexEntry>        m_index;
+	std::uint64_t                          m_offset = 0;        ///< where the next block goes.
+	std::string                            m_pending;           ///< the records of the block being filled.
+	LogBlockIndexEntry                     m_block;             ///< its time range and record count.
+	bool                                   m_failed = false;    ///< a block write failed: the offsets no longer hold.
+};
+
+//--------------------------------------------------------------------------------------------------
+//	LogBlockReader
+//--------------------------------------------------------------------------------------------------
+/// @brief		Reads a block log: the index up front, then only the blocks a caller asks for.
+/// @details	Read-only; safe to use on a file that is still being written, which it sees up to its last whole block.
+class LogBlockReader
+{
+public:
+	using time_point = std::chrono::system_clock::time_point;
+
+	explicit LogBlockReader(const std::filesystem::path& path);
+
+	/// false if the file is missing or is not a block log.
+	[[nodiscard]] bool isOpen() const noexcept { return m_open; }
+
+	/// Every block, in file order.
+	[[nodiscard]] const std::vector<LogBlockIndexEntry>& blocks() const noexcept { return m_index; }
+
+	/// @brief		The records of one block, decompressed.
+	/// @throws		std::runtime_error if the block is damaged or uses a codec this build cannot decompress.
+	[[nodiscard]] std::string read(const LogBlockIndexEntry& block) const;
+
+	/// @brief		The records stamped within [@p from, @p to], in file order. Decompresses only the blocks that overlap
+	///				the window. Continuation lines (a trace footer) go with the record they follow.
+	[[nodiscard]] std::string read(time_point from, time_point to) const;
+
+	/// The whole log, decompressed.
+	[[nodiscard]] std::string readAll() const;
+
+private:
+	std::filesystem::path           m_path;
+	std::vector<LogBlockIndexEntry> m_index;
+	bool                            m_open = false;
+};
+
+#endif    // LogBlocks_h_
@@ -45,13 +45,20 @@
 //	INCLUDES
 //-------------------------
 
-#include <concurrent_queue.h>
+#include <BoundedQueue.h>
+#include <LogArchiver.h>
+#include <LogRecord.h>
+#include <logLevel.h>
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
 #include <thread>
-#include <unordered_set>
 
 //-------------------------
 //	FORWARD DECLARATIONS
@@ -66,38 +73,121 @@ class LogFileWriter
 {
 public:
 
+	/// @brief		How far each batch is pushed toward the disk before the worker takes the next one.
+	enum class Durability
+	{
+		None,           ///< batches accumulate in the writer's buffer and reach the OS only when it fills, or on close.
+		Flush,          ///< every batch is written to the OS: it survives the process crashing, not the machine.
+		SyncBatch,      ///< every batch is also fdatasync'ed: it survives a power loss.
+		SyncOnError,    ///< like Flush, and a batch holding an [ERROR] line is also fdatasync'ed.
+		ByLevel,        ///< an [ERROR] line is written and fdatasync'ed as soon as the worker takes it, together with every
+		                ///< line queued ahead of it; other lines wait for a full batch or for Options::lazyCommitInterval.
+	};
+
+	/// @brief		How the log file itself is written.
+	enum class Backend
+	{
+		Append,    ///< one write(2) per batch to an O_APPEND descriptor.
+		Mapped,    ///< batches are copied into a shared mapping of a preallocated file: no syscall per batch. POSIX only;
+		           ///< elsewhere this falls back to Append.
+		Uring,     ///< batches are submitted through io_uring and the worker moves on while they complete. Linux only;
+		           ///< falls back to Append at runtime when a ring cannot be set up (old kernel, seccomp).
+	};
+
+	/// @brief		What the log file holds.
+	enum class Format
+	{
+		Text,      ///< the records as they are: "<name>.log.txt".
+		Blocks,    ///< the records in independently compressed blocks with a time index (see LogBlocks.h): "<name>.logz".
+		Binary,    ///< compact binary records, with call-site metadata written once (see LogBinary.h): "<name>.logb".
+		           ///< `logerr-decode` turns the file back into the Text layout.
+	};
+
+	/// @brief		Where the worker writes its batches. The default appends to the log file itself; Options::openOutput can
+	///				substitute another (a slow or failing device in a test, for one).
+	class Output
+	{
+	public:
+		virtual ~Output() = default;
+
+		/// false if the output could not be opened. The writer reports it and writes nothing.
+		[[nodiscard]] virtual bool isOpen() const noexcept = 0;
+		/// Write all of @p batch. Returns false, with errno set, on failure.
+		virtual bool write(std::string_view batch) noexcept = 0;
+		/// Make everything written so far durable. Returns false, with errno set, on failure.
+		virtual bool sync() noexcept = 0;
+		/// write() then sync(): when it returns true, all of @p batch and everything before it is durable.
+		virtual bool writeAndSync(std::string_view batch) noexcept { return write(batch) && sync(); }
+	};
+
+	/// @brief		Group-commit settings. The worker takes everything queued at once and writes it as one batch.
+	struct Options
+	{
+		std::size_t               batchBytes    = 64 * 1024;                     ///< write as soon as this much is buffered.
+		std::chrono::milliseconds flushInterval = std::chrono::milliseconds(0);  ///< how long a drained batch waits for more.
+		Durability                durability    = Durability::ByLevel;
+		/// ByLevel: the longest a line below ERROR is held back before it is written (not synced). A crash can lose up to
+		/// this much of INFO and DEBUG from the file; the flight recorder still has them.
+		std::chrono::milliseconds lazyCommitInterval = std::chrono::milliseconds(250);
+		/// How much the queue may hold while the disk falls behind, and what happens beyond that. By default INFO and
+		/// DEBUG lines are dropped past 64 MiB, a WARNING waits up to blockTimeout for room before it is dropped too,
+		/// and an ERROR is always kept. write() runs on the LogStream backend, so it never waits longer than that.
+		QueueLimits queueLimits = {.maxBytes = 64 * 1024 * 1024, .policy = OverflowPolicy::DropBelowLevel};
+		Format                    format             = Format::Text;
+		std::size_t               blockBytes         = 128 * 1024;             ///< Blocks: records per block, uncompressed.
+		Backend                   backend            = Backend::Append;
+		std::size_t               mappedExtentBytes  = 16 * 1024 * 1024;        ///< Mapped: preallocation and window size.
+		std::chrono::milliseconds mappedSyncInterval = std::chrono::seconds(1);  ///< Mapped: background writeback cadence.
+		/// Rotation: the worker closes the current segment between batches and carries on in a new one, "<name>.1.log.txt",
+		/// "<name>.2.log.txt" and so on, once a batch would take it past rotateBytes or it has been open rotateInterval.
+		/// Zero: never. A LogArchiver thread compresses each closed segment and enforces `retention` on the series.
+		std::uint64_t             rotateBytes    = 0;
+		std::chrono::seconds      rotateInterval = std::chrono::seconds(0);
+		Compression               compression    = Compression::Gzip;    ///< for closed segments, or each block of a Blocks log.
+		RetentionLimits           retention      = {};                   ///< closed segments kept, this run's and earlier ones'.
+		/// The file traces a given call stack once and writes a one-line note for each repeat. It remembers this many of
+		/// the most recently written stacks; a stack not seen for longer is traced in full again.
+		std::size_t               traceDedupStacks = 4096;
+		/// Text: also write "<log>.idx", the offset, time range and levels of each indexBlockBytes of records, which
+		/// `logerr-query` uses to go straight to the part of the log it wants (see LogIndex.h).
+		bool                      sidecarIndex    = false;
+		std::size_t               indexBlockBytes = 256 * 1024;
+		/// Opens the output for the resolved log-file path. Empty: the log file itself, written by `backend`.
+		std::function<std::unique_ptr<Output>(const std::string& path)> openOutput = nullptr;
+	};
+
 	explicit LogFileWriter(std::string logFilePath = "");
+	LogFileWriter(std::string logFilePath, Options options);
 	virtual ~LogFileWriter();
 
-	void write(std::string str);
-
-	/// @brief   The absolute path of the log file THIS writer opened.
+	/// @brief		The output the writer opens for @p path when Options::openOutput is empty: the log file itself,
+	///				written by @p options' backend. A custom openOutput can wrap it.
+	[[nodiscard]] static std::unique_ptr<Output> openFile(const std::string& path, const Options& options);
+
+	/// @brief		Queue a record to be written into the log file. Thread-safe.
+	/// @details	The queue holds the handle, not a copy of the text. The overflow policy and Durability::ByLevel go by
+	///				the level the record carries (LogRecord::level), which its producer set; the text is never read for
+	///				it. When the queue is full, Options::queueLimits decides whether the call waits or the record is
+	///				dropped; drops are logged as one "N lines dropped" line once the writer has caught up. A record
+	///				carrying a LogRecord::Trace whose stack the file already holds is written with its footer collapsed
+	///				to a one-line note; the worker does that, by the trace's fingerprint.
+	void write(LogRecord record);
+	/// Queue @p str, logged at @p level, as one record.
+	void write(std::string str, logerr::Level level = logerr::Level::Info);
+
+	/// @brief   The absolute path of the log file THIS writer is writing: with rotation, the current segment.
 	/// @return  the resolved log-file path (the explicit path passed to the constructor, or the auto-generated
-	///          <logDir><repo>_<app>_<UTC>.log.txt). Empty only if the file could not be opened. Thread-safe, and
-	///          populated by the time the constructor returns (the ctor blocks on the worker's readiness), so a caller
-	///          can read the live log's exact path instead of guessing "newest in the directory" - which is wrong when
-	///          several processes share one log directory.
+	///          <logDir><repo>_<app>_<UTC>.log.txt, or a later segment of either). Empty only if the file could not be
+	///          opened. Thread-safe, and populated by the time the constructor returns (the ctor blocks on the worker's
+	///          readiness), so a caller can read the live log's exact path instead of guessing "newest in the
+	///          directory" - which is wrong when several processes share one log directory.
 	std::string filePath() const;
 
-private:
-
-	/// @brief      Collapse a repeated stack-trace footer in an entry bound for the on-disk log.
-	/// @param[in]  entry  the whole log entry (message plus, for an error, a multi-line trace footer).
-	/// @return     the entry unchanged the FIRST time a given trace footer is seen; on a later entry carrying the
-	///             identical footer, the entry with its footer replaced by a one-line "(trace repeated ...)" note.
-	/// @details    Dedup is a FILE-ONLY concern: the live GUI dock always shows every error's full trace, but the
-	///             on-disk log stays lean by tracing a given call stack once and noting subsequent repeats. The footer
-	///             is the trailing run of frame lines ("    [n]   0x... | function"); it is hashed and looked up in
-	///             m_seenTraceFooters (guarded by m_dedupMutex, since write() may be called from several threads).
-	std::string deduplicateTraceFooter(std::string entry);
-
 protected:
 
-	concurrent_queue<std::string>      m_logQueue;
+	BoundedQueue<LogRecord>            m_logQueue;
 	mutable std::mutex                 m_filePathMutex;      ///< guards m_filePath (set on the worker, read by any thread).
-	std::string                        m_filePath;           ///< the resolved log-file path this writer opened.
-	std::mutex                         m_dedupMutex;         ///< guards m_seenTraceFooters against concurrent write() calls.
-	std::unordered_set<std::uint64_t>  m_seenTraceFooters;   ///< hashes of trace footers already written to disk.
+	std::string                        m_filePath;           ///< the segment this writer is writing.
 	std::jthread                       m_thread;
 };
 
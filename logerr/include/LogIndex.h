@@ -0,0 +1,159 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LOG INDEX
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+//
+/// @file	LogIndex.h
+/// @brief	A sidecar time and level index for a text log, and the query that uses it.
+/// @details
+///		With Options::sidecarIndex set, LogFileWriter writes "<log>.idx" beside a Text log. The
+///		records are grouped into blocks of about Options::indexBlockBytes, and each block gets an
+///		entry once it closes:
+///
+///			"LOGERRX1"
+///			entry (40 bytes):  offset, bytes, records, stamped records, level bitmap, earliest and
+///			                   latest timestamp (ns)
+///
+///		A record is a line starting with '[' plus the continuation lines after it (a trace footer),
+///		and a block starts at a record, so a record never spans two. The log itself is unchanged. A
+///		reader scans whatever part of the log the index does not cover (the block the writer had not
+///		closed yet, or a file written without an index) as if it were one more block that nothing
+///		can be ruled out of. Integers are little-endian.
+///
+///		LogQuery maps the log and skips every block whose time range or levels rule it out. Within
+///		the rest it jumps between occurrences of the query's most selective literal with memmem
+///		(SIMD in glibc), and parses only the records around them. `logerr-query` is the command-line
+///		front end.
+//
+//--------------------------------------------------------------------------------------------------
+
+#pragma once
+#ifndef LogIndex_h_
+#define LogIndex_h_
+
+//-------------------------
+//	INCLUDES
+//-------------------------
+
+#include <LogFileWriter.h>
+#include <logLevel.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------
+//	LogIndexEntry
+//--------------------------------------------------------------------------------------------------
+
+/// One block of a text log, as its sidecar index records it.
+struct LogIndexEntry
+{
+	std::uint64_t                         offset  = 0;    ///< of the block's first record, from the start of the log.
+	std::uint32_t                         bytes   = 0;
+	std::uint32_t                         records = 0;
+	std::uint32_t                         stamped = 0;    ///< records with a timestamp; first and last are theirs.
+	std::uint32_t                         levels  = 0;    ///< LogQuery::levelBit() of each level among the records.
+	std::chrono::system_clock::time_point first;          ///< the earliest record timestamp in the block.
+	std::chrono::system_clock::time_point last;           ///< the latest.
+};
+
+//--------------------------------------------------------------------------------------------------
+//	LogIndexWriter
+//--------------------------------------------------------------------------------------------------
+/// @brief		LogFileWriter's output for Options::sidecarIndex: batches go to the underlying output unchanged, and each
+///				block of records they add up to is entered in the sidecar index as it closes.
+/// @details	Opening a log that already has an index keeps its entries and indexes whatever the previous writer
+///				left unindexed; a log without one is indexed from where it ends. A failed write stops the indexing,
+///				since the offsets no longer hold; the rest of the log is then scanned.
+class LogIndexWriter : public LogFileWriter::Output
+{
+public:
+	using OpenOutput = std::function<std::unique_ptr<LogFileWriter::Output>(const std::string& path)>;
+
+	/// @param[in]	open	opens the underlying output for @p path.
+	LogIndexWriter(const std::string& path, std::size_t blockBytes, const OpenOutput& open);
+	~LogIndexWriter() override;
+
+	LogIndexWriter(const LogIndexWriter&)            = delete;
+	LogIndexWriter& operator=(const LogIndexWriter&) = delete;
+
+	[[nodiscard]] bool isOpen() const noexcept override;
+	bool               write(std::string_view batch) noexcept override;
+	bool               sync() noexcept override;
+	bool               writeAndSync(std::string_view batch) noexcept override;
+
+	/// "<log>.idx".
+	static std::filesystem::path sidecarPath(const std::filesystem::path& log);
+
+private:
+	/// Enter @p text, just written at m_offset, into the blocks.
+	void index(std::string_view text);
+	/// Append the block being filled to the index, and start the next one.
+	void close();
+
+	std::unique_ptr<LogFileWriter::Output> m_output;
+	std::ofstream                          m_index;
+	std::size_t                            m_blockBytes;
+	std::uint64_t                          m_offset = 0;        ///< the log's length.
+	LogIndexEntry                          m_block;             ///< the block being filled.
+	bool                                   m_failed = false;
+};
+
+//--------------------------------------------------------------------------------------------------
+//	LogQuery
+//--------------------------------------------------------------------------------------------------
+/// @brief		Finds the records of a text log that fall in a time window, have one of a set of levels, carry a tag
+///				and contain a piece of text, using the log's sidecar index when it has one.
+/// @details	Every criterion left at its default matches everything.
+struct LogQuery
+{
+	using time_point = std::chrono::system_clock::time_point;
+
+	static constexpr std::uint32_t levelBit(logerr::Level level) noexcept { return 1u << static_cast<unsigned>(level); }
+	static constexpr std::uint32_t allLevels = 0xF;
+
+	std::optional<time_point> from;                   ///< the earliest record timestamp wanted.
+	std::optional<time_point> to;                     ///< the latest.
+	std::uint32_t             levels = allLevels;     ///< levelBit() of each level wanted. A record without a label is INFO.
+	std::string               tag;                    ///< the [tag] (or application) field of the record's first line.
+	std::string               text;                   ///< a substring anywhere in the record, continuation lines included.
+	std::size_t               limit = 0;              ///< stop after this many matches; 0 for all of them.
+
+	/// @brief		Call @p visit(record) for each matching record, in file order, continuation lines included.
+	/// @return		the number of matches.
+	/// @throws		std::runtime_error if the log cannot be opened.
+	std::size_t run(const std::filesystem::path& log, const std::function<void(std::string_view record)>& visit) const;
+
+	/// @brief		The entries of @p log's sidecar index that still describe it, given that it is @p logBytes long.
+	/// @return		empty if it has no index, or a damaged one.
+	static std::vector<LogIndexEntry> readIndex(const std::filesystem::path& log, std::uint64_t logBytes);
+};
+
+#endif    // LogIndex_h_
@@ -0,0 +1,204 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LOG RECORD
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+//
+/// @file	LogRecord.h
+/// @brief	An immutable, reference-counted log line shared by every sink it is dispatched to.
+/// @details
+///		The LogStream backend renders each line into a LogRecord once and hands the same handle to
+///		every sink. Copying a handle bumps a reference count instead of copying the text, so a sink
+///		that queues the line for later (the log file writer, the log dock) keeps it alive for free,
+///		and N sinks cost no more than one. The text is never modified after the record is built.
+///
+///		Record buffers are pooled: when the last handle goes away the buffer, with its allocation,
+///		goes back to a free list for the next line, so steady-state logging does not allocate.
+///		Oversized buffers (a multi-kilobyte trace footer or dump) are freed instead of pooled.
+///
+///		The backend also stamps a record with the id of the thread that logged it and, for a deferred
+///		(LOG*_FMT) line, keeps the raw DeferredHeader and arguments it was rendered from, so a binary
+///		sink can store the arguments instead of the text. A traced error carries its Trace - where its
+///		stack-trace footer starts and a fingerprint of the raw stack - so a sink can recognize a
+///		repeated stack without reading the text. Every record carries the level it was logged at, as
+///		its producer knew it, so a sink can act on it without reading the label back out of the text.
+//
+//--------------------------------------------------------------------------------------------------
+
+#pragma once
+#ifndef LogRecord_h_
+#define LogRecord_h_
+
+//-------------------------
+//	INCLUDES
+//-------------------------
+
+// logerr
+#include <logLevel.h>
+
+// std
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+//--------------------------------------------------------------------------------------------------
+//	LogRecord
+//--------------------------------------------------------------------------------------------------
+class LogRecord
+{
+public:
+	static constexpr std::size_t poolSize          = 256;          ///< the most idle buffers kept for reuse.
+	static constexpr std::size_t maxPooledCapacity = 16 * 1024;    ///< larger buffers are freed, not pooled.
+
+	/// @brief		The stack-trace footer at the end of a record's text, as the producer that appended it describes it.
+	struct Trace
+	{
+		std::uint64_t stack  = 0;    ///< a fingerprint of the raw frames the footer was symbolized from; 0: no footer.
+		std::uint32_t offset = 0;    ///< where the footer starts in the text.
+	};
+
+	/// An empty record.
+	LogRecord() noexcept = default;
+
+	/// Copy @p text, logged at @p level, into a pooled buffer.
+	explicit LogRecord(std::string_view text, logerr::Level level = logerr::Level::Info);
+	explicit LogRecord(const char* text, logerr::Level level = logerr::Level::Info)
+	    : LogRecord(std::string_view(text), level)
+	{
+	}
+
+	/// Adopt @p text, logged at @p level, without copying it.
+	explicit LogRecord(std::string&& text, logerr::Level level = logerr::Level::Info);
+
+	/// Adopt @p text, logged at @p level, which ends in the footer @p trace describes.
+	LogRecord(std::string&& text, Trace trace, logerr::Level level);
+
+	/// Adopt @p text, stamped with the logging thread's id, its level and the footer @p trace describes.
+	LogRecord(std::uint32_t thread, logerr::Level level, Trace trace, std::string&& text);
+
+	/// @brief		Build a record logged at @p level in place: @p fill is called as fill(std::string&) on an empty pooled
+	///				buffer, and the record is immutable once it returns.
+	template<class Fill>
+	static LogRecord build(logerr::Level level, Fill&& fill)
+	{
+		LogRecord record(acquire());
+		record.m_block->level = level;
+		std::forward<Fill>(fill)(record.m_block->text);
+		return record;
+	}
+
+	/// @brief		Build a record in place, stamped with the logging thread's id, its level and, for a deferred line,
+	///				the encoded record (see deferredFormat.h) its text was rendered from.
+	template<class Fill>
+	static LogRecord build(std::uint32_t thread, logerr::Level level, std::string_view deferred, Fill&& fill)
+	{
+		LogRecord record(acquire());
+		record.m_block->thread = thread;
+		record.m_block->level  = level;
+		record.m_block->deferred.assign(deferred);
+		std::forward<Fill>(fill)(record.m_block->text);
+		return record;
+	}
+
+	/// @brief		Build a record in place, stamped with the logging thread's id, its level and the footer @p trace
+	///				describes.
+	template<class Fill>
+	static LogRecord build(std::uint32_t thread, logerr::Level level, Trace trace, Fill&& fill)
+	{
+		LogRecord record(acquire());
+		record.m_block->thread = thread;
+		record.m_block->level  = level;
+		record.m_block->trace  = trace;
+		std::forward<Fill>(fill)(record.m_block->text);
+		return record;
+	}
+
+	LogRecord(const LogRecord& other) noexcept
+	    : m_block(other.m_block)
+	{
+		if (m_block != nullptr)
+			m_block->refs.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	LogRecord(LogRecord&& other) noexcept
+	    : m_block(std::exchange(other.m_block, nullptr))
+	{
+	}
+
+	LogRecord& operator=(LogRecord other) noexcept
+	{
+		std::swap(m_block, other.m_block);
+		return *this;
+	}
+
+	~LogRecord()
+	{
+		if (m_block != nullptr && m_block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			release(m_block);
+	}
+
+	[[nodiscard]] std::string_view view() const noexcept { return m_block != nullptr ? std::string_view(m_block->text) : std::string_view(); }
+	[[nodiscard]] const char*      data() const noexcept { return view().data(); }
+	[[nodiscard]] std::size_t      size() const noexcept { return view().size(); }
+	[[nodiscard]] bool             empty() const noexcept { return view().empty(); }
+
+	operator std::string_view() const noexcept { return view(); }    // NOLINT(google-explicit-constructor)
+
+	/// The LogStream id of the thread that logged the line; 0 if unknown.
+	[[nodiscard]] std::uint32_t    thread() const noexcept { return m_block != nullptr ? m_block->thread : 0; }
+	/// The level the line was logged at; INFO for raw output that did not come through a LOG* statement.
+	[[nodiscard]] logerr::Level    level() const noexcept { return m_block != nullptr ? m_block->level : logerr::Level::Info; }
+	/// The encoded deferred record the text was rendered from; empty for a line that was not deferred.
+	[[nodiscard]] std::string_view deferred() const noexcept { return m_block != nullptr ? std::string_view(m_block->deferred) : std::string_view(); }
+	/// The stack-trace footer the text ends in; Trace::stack is 0 for a record without one.
+	[[nodiscard]] Trace            trace() const noexcept { return m_block != nullptr ? m_block->trace : Trace(); }
+
+	/// The number of handles sharing this record's text (0 for an empty record).
+	[[nodiscard]] std::size_t useCount() const noexcept
+	{
+		return m_block != nullptr ? m_block->refs.load(std::memory_order_relaxed) : 0;
+	}
+
+private:
+	struct Block
+	{
+		std::atomic<std::uint32_t> refs{1};
+		std::uint32_t              thread = 0;
+		logerr::Level              level  = logerr::Level::Info;
+		Trace                      trace;
+		std::string                text;
+		std::string                deferred;
+	};
+
+	explicit LogRecord(Block* block) noexcept
+	    : m_block(block)
+	{
+	}
+
+	static Block* acquire();
+	static void   release(Block* block) noexcept;
+
+	Block* m_block = nullptr;
+};
+
+#endif    // LogRecord_h_
@@ -0,0 +1,181 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LOG RING
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+//
+/// @file	LogRing.h
+/// @brief	Lock-free single-producer / single-consumer record ring for the logging front end.
+/// @details
+///		Every logging thread owns one LogRing and is its only writer; the LogStream backend thread is
+///		its only reader. A record is an 8-byte header (payload size + kind) followed by the payload,
+///		padded to 8 bytes, and is always contiguous in memory - a record that would straddle the end
+///		of the buffer is preceded by a padding record and written at the start instead. So the
+///		consumer can hand a record's bytes to a sink in place, with no reassembly copy.
+//
+//--------------------------------------------------------------------------------------------------
+
+#pragma once
+#ifndef LogRing_h_
+#define LogRing_h_
+
+//-------------------------
+//	INCLUDES
+//-------------------------
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+
+//--------------------------------------------------------------------------------------------------
+//	LogRing
+//--------------------------------------------------------------------------------------------------
+class LogRing
+{
+public:
+	static constexpr std::size_t defaultCapacity = 64 * 1024;    ///< per-thread bytes; a power of two.
+	static constexpr std::size_t headerSize      = 8;            ///< bytes of record header (size + kind).
+	static constexpr std::uint32_t paddingKind   = 0xFFFFFFFFu;  ///< the kind of a wrap-around filler record.
+
+	/// @brief		Construct an empty ring.
+	/// @param[in]	capacity	the buffer size in bytes, rounded up to a power of two (minimum 1 KiB).
+	explicit LogRing(std::size_t capacity = defaultCapacity)
+	    : m_capacity(std::bit_ceil(capacity < 1024 ? std::size_t{1024} : capacity))
+	    , m_mask(m_capacity - 1)
+	    , m_buffer(std::make_unique<std::byte[]>(m_capacity))
+	{
+	}
+
+	LogRing(const LogRing&)            = delete;
+	LogRing& operator=(const LogRing&) = delete;
+
+	/// @brief		The largest payload reserve() can ever place in this ring. Larger records must be sent indirectly.
+	[[nodiscard]] std::size_t maxPayload() const noexcept { return m_capacity / 2 - headerSize; }
+
+	/// @brief		The buffer size in bytes.
+	[[nodiscard]] std::size_t capacity() const noexcept { return m_capacity; }
+
+	//----------------------------
+	//  PRODUCER
+	//----------------------------
+
+	/// @brief		Reserve contiguous space for one record. PRODUCER THREAD ONLY.
+	/// @param[in]	kind	the caller-defined record kind, handed back to the consumer.
+	/// @param[in]	size	the payload size in bytes (at most maxPayload()).
+	/// @return		where to write the payload, or nullptr when the ring is currently too full (nothing is reserved).
+	/// @details	The record is invisible to the consumer until commit(). At most one reservation may be open.
+	[[nodiscard]] std::byte* reserve(std::uint32_t kind, std::size_t size) noexcept
+	{
+		if (size > maxPayload())
+			return nullptr;
+
+		const std::size_t  total      = headerSize + align(size);
+		const std::uint64_t head       = m_head.load(std::memory_order_relaxed);
+		const std::size_t  index      = static_cast<std::size_t>(head) & m_mask;
+		const std::size_t  contiguous = m_capacity - index;
+		const std::size_t  needed     = contiguous < total ? contiguous + total : total;
+
+		if (m_capacity - (head - m_cachedTail) < needed)
+		{
+			m_cachedTail = m_tail.load(std::memory_order_acquire);
+			if (m_capacity - (head - m_cachedTail) < needed)
+				return nullptr;
+		}
+
+		std::uint64_t position = head;
+		if (contiguous < total)
+		{
+			writeHeader(index, static_cast<std::uint32_t>(contiguous - headerSize), paddingKind);
+			position += contiguous;
+		}
+
+		const std::size_t recordIndex = static_cast<std::size_t>(position) & m_mask;
+		writeHeader(recordIndex, static_cast<std::uint32_t>(size), kind);
+		m_pendingHead = position + total;
+		return m_buffer.get() + recordIndex + headerSize;
+	}
+
+	/// @brief		Publish the record opened by the last successful reserve(). PRODUCER THREAD ONLY.
+	void commit() noexcept { m_head.store(m_pendingHead, std::memory_order_release); }
+
+	//----------------------------
+	//  CONSUMER
+	//----------------------------
+
+	/// @brief		Hand every committed record to @p visit, in order, and release its space. CONSUMER THREAD ONLY.
+	/// @param[in]	visit	called as visit(kind, std::span<const std::byte> payload). The payload is only valid for
+	///						the duration of the call: the producer may reuse the space as soon as it returns.
+	/// @return		the number of records visited (padding excluded).
+	template<class Visitor>
+	std::size_t drain(Visitor&& visit)
+	{
+		std::size_t         visited = 0;
+		std::uint64_t       tail    = m_tail.load(std::memory_order_relaxed);
+		const std::uint64_t head    = m_head.load(std::memory_order_acquire);
+		while (tail != head)
+		{
+			const std::size_t index = static_cast<std::size_t>(tail) & m_mask;
+			std::uint32_t     size  = 0;
+			std::uint32_t     kind  = 0;
+			std::memcpy(&size, m_buffer.get() + index, sizeof(size));
+			std::memcpy(&kind, m_buffer.get() + index + sizeof(size), sizeof(kind));
+			if (kind != paddingKind)
+			{
+				visit(kind, std::span<const std::byte>(m_buffer.get() + index + headerSize, size));
+				++visited;
+			}
+			tail += headerSize + align(size);
+			m_tail.store(tail, std::memory_order_release);
+		}
+		return visited;
+	}
+
+	/// @brief		Whether a committed record is waiting. Safe from either side.
+	[[nodiscard]] bool empty() const noexcept
+	{
+		return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+	}
+
+private:
+	static constexpr std::size_t align(std::size_t size) noexcept { return (size + 7) & ~std::size_t{7}; }
+
+	void writeHeader(std::size_t index, std::uint32_t size, std::uint32_t kind) noexcept
+	{
+		std::memcpy(m_buffer.get() + index, &size, sizeof(size));
+		std::memcpy(m_buffer.get() + index + sizeof(size), &kind, sizeof(kind));
+	}
+
+	const std::size_t            m_capacity;
+	const std::size_t            m_mask;
+	std::unique_ptr<std::byte[]> m_buffer;
+
+	// The producer and consumer indices live on separate cache lines so the two threads do not false-share. Both are
+	// monotonically increasing byte positions; the buffer index is position & m_mask.
+	alignas(64) std::atomic<std::uint64_t> m_head{0};    ///< committed end; written by the producer.
+	std::uint64_t m_pendingHead = 0;                      ///< end of the open reservation (producer-private).
+	std::uint64_t m_cachedTail  = 0;                      ///< producer's last view of m_tail, refreshed only when full.
+	alignas(64) std::atomic<std::uint64_t> m_tail{0};    ///< consumed end; written by the consumer.
+};
+
+#endif    // LogRing_h_
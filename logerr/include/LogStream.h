@@ -34,6 +34,20 @@
 //
 /// @file	LogStream.h
 /// @brief	Stream that captures std::cout and passes it on to file logging and a log model
+/// @details
+///		Capture is split into a front end and a back end. The front end runs on the logging thread:
+///		a completed line is copied into that thread's own LogRing (a lock-free SPSC buffer) and the
+///		call returns. One backend thread per LogStream drains every thread's ring and fans each
+///		record out to the registered sinks, so independent logging threads never serialize on a
+///		shared lock and never pay for sink work (file I/O, the log dock) themselves.
+///
+///		The backend renders each record into one LogRecord and passes that same handle to every
+///		sink, so registering more sinks adds no copies of the line. A sink that queues the line
+///		keeps a handle rather than a copy.
+///
+///		The sink set is an immutable, name-sorted array published through an atomic pointer. The
+///		backend walks the current snapshot without taking a lock; registering or removing a sink
+///		builds a new snapshot, swaps it in and retires the old one once the backend has let go.
 //
 //--------------------------------------------------------------------------------------------------
 
@@ -45,12 +59,27 @@
 //	INCLUDES
 //-------------------------
 
+// logerr
+#include <LineBuffer.h>
+#include <LogRecord.h>
+#include <LogRing.h>
+#include <logLevel.h>
+
 // std
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
-#include <map>
+#include <memory>
 #include <mutex>
+#include <stop_token>
 #include <streambuf>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 //--------------------------------------------------------------------------------------------------
 //	LogStream
@@ -61,25 +90,152 @@ public:
 	explicit LogStream(std::ostream& stream);
 	~LogStream() noexcept override;
 
+	/// @brief		Add a sink. Sinks are invoked on the LogStream backend thread, one record at a time, in the order
+	///				each producing thread logged them. A name that is already registered is ignored.
+	/// @details	A sink taking `const LogRecord&` or `std::string_view` shares the backend's single copy of the line
+	///				(keep the LogRecord handle to hold on to it). A sink taking `std::string` still works, but is handed
+	///				its own copy.
 	template<typename Function>
 	void registerLogFunction(std::string&& name, Function&& function)
 	{
-		m_callbacks.emplace(std::forward<std::string>(name), std::forward<Function>(function));
+		using Callable = std::decay_t<Function>;
+
+		Callback callback;
+		if constexpr (std::is_invocable_v<Callable&, const LogRecord&>)
+			callback = std::forward<Function>(function);
+		else
+			callback = [function = Callable(std::forward<Function>(function))](const LogRecord& record) mutable
+			{ function(std::string(record.view())); };
+
+		addSink(std::forward<std::string>(name), std::move(callback));
 	}
 
+	/// @brief		Remove one sink (or every sink when @p name is empty).
+	/// @details	Flushes first, so the removed sink still receives every line logged before this call, and returns
+	///				only once no dispatch to it is in flight - its captured state may be destroyed immediately after.
+	///				(Called from inside a sink, the sink set changes from the next record on.)
 	void unregisterLogFunction(const std::string& name = "");
 
+	/// @brief		Block until the backend has dispatched every line this thread logged before the call.
+	/// @details	Lines still waiting for their terminating newline are not part of a record yet and are not flushed.
+	///				A no-op when called from a sink (the backend thread cannot wait on itself).
+	void flush();
+
+	/// @brief		Take everything staged in @p line as if it had been streamed to the captured stream, and empty it.
+	/// @details	This is how logerr::stream() hands a finished statement over without going through the captured
+	///				stream's sentry or this buffer's per-character path: a statement that ends a line becomes a record
+	///				straight from @p line; anything else is staged with the rest of this thread's line. The record is
+	///				tagged with @p level (LogRecord::level), the level of the statement that ends it.
+	void write(LineBuffer& line, logerr::Level level = logerr::Level::Info);
+
+	/// @brief		Tag the line the calling thread is streaming into the captured stream with @p level.
+	/// @details	Raw output carries no level of its own, so its record counts as INFO; the LOGERR_USE_COUT macros,
+	///				which write their lines to std::cout, tag each one as they start it. The tag ends with the line.
+	void tagLine(logerr::Level level) noexcept;
+
+	/// @brief		Queue one complete, newline-terminated @p entry, logged at @p level, that ends in the stack-trace
+	///				footer @p trace describes.
+	/// @details	The record reaches the sinks carrying @p trace (LogRecord::trace), so a sink that collapses repeated
+	///				stacks keys on the fingerprint instead of scanning the text. This is how the trace worker hands over
+	///				a traced error.
+	void write(std::string_view entry, LogRecord::Trace trace, logerr::Level level);
+
+	/// @brief		Queue a deferred-format record (see deferredFormat.h) on this thread's ring.
+	/// @param[in]	size	the exact encoded size in bytes.
+	/// @param[in]	encode	called as encode(std::byte*) to write the record in place; must not throw.
+	/// @return		false when the record cannot be deferred from this thread - it is larger than a ring, or the
+	///				caller is itself a sink - so the caller must format it synchronously instead.
+	template<typename Encoder>
+	bool submitDeferred(std::size_t size, Encoder&& encode)
+	{
+		std::byte* slot = reserveRecord(DeferredRecord, size);
+		if (slot == nullptr)
+			return false;
+		encode(slot);
+		commitRecord();
+		return true;
+	}
+
 protected:
 	int_type        overflow(int_type v) override;
 	std::streamsize xsputn(const char* p, std::streamsize n) override;
 	void            log();
 
 private:
-	std::ostream&                                           m_stream;
-	std::streambuf*                                         m_old_buf;
-	std::map<std::string, std::function<void(std::string)>> m_callbacks;
-	std::mutex                                              m_callbackMutex;
-	static thread_local std::string                         m_string;
+	using Callback = std::function<void(const LogRecord&)>;
+
+	/// One registered sink. The callable is shared between snapshots, so a stateful sink is never duplicated.
+	struct Sink
+	{
+		std::string               name;
+		std::shared_ptr<Callback> callback;
+	};
+
+	/// An immutable sink set, sorted by name. Replaced wholesale, never modified in place.
+	using SinkSet = std::vector<Sink>;
+
+	/// @brief		The record kinds a producer writes into its LogRing.
+	/// @details	A ring record's kind word holds the RecordKind in its low byte and the line's logerr::Level above it
+	///				(see kindWord); a deferred record's level is its DeferredHeader's site's.
+	enum RecordKind : std::uint32_t
+	{
+		TextRecord     = 1,    ///< the payload is the line's bytes.
+		IndirectRecord = 2,    ///< the payload is a std::string* owning a line too large for the ring (moved, not copied).
+		DeferredRecord = 3,    ///< the payload is a logerr::DeferredHeader + encoded arguments, formatted by the backend.
+		TracedRecord   = 4,    ///< a LogRecord::Trace, then the line's bytes.
+		IndirectTraced = 5,    ///< a LogRecord::Trace, then an IndirectRecord's std::string*.
+	};
+
+	/// One producer thread's ring, shared between that thread (the writer) and the backend (the reader).
+	struct Producer
+	{
+		explicit Producer(std::uint32_t id) noexcept
+		    : thread(id)
+		{
+		}
+
+		LogRing             ring;
+		std::atomic_bool    exited{false};    ///< set when the producing thread ends; the backend retires it once drained.
+		const std::uint32_t thread;           ///< the id its records carry (LogRecord::thread), unique in the process.
+	};
+
+	/// The kind word a record of @p kind, logged at @p level, is reserved under.
+	static constexpr std::uint32_t kindWord(RecordKind kind, logerr::Level level) noexcept
+	{
+		return kind | static_cast<std::uint32_t>(level) << 8;
+	}
+
+	void                      submit(LineBuffer& line, logerr::Level level, LogRecord::Trace trace = {});
+	std::byte*                reserveRecord(std::uint32_t kind, std::size_t size);
+	void                      commitRecord();
+	Producer&                 producerForThisThread();
+	bool                      drainOnce();
+	void                      dispatch(const LogRecord& record);
+	void                      addSink(std::string&& name, Callback&& callback);
+	void                      publish(SinkSet&& sinks);
+	void                      wake() noexcept;
+	void                      run(std::stop_token stop);
+
+	std::ostream&                  m_stream;
+	std::streambuf*                m_old_buf;
+	static thread_local LineBuffer    m_line;         ///< the calling thread's unfinished line.
+	static thread_local logerr::Level m_lineLevel;    ///< the level m_line is tagged with (see tagLine).
+
+	std::atomic<const SinkSet*>                 m_sinks;                ///< the current snapshot; never null.
+	std::atomic<const SinkSet*>                 m_sinksInUse{nullptr};  ///< the snapshot the backend is dispatching to.
+	std::mutex                                  m_sinksMutex;           ///< serializes writers only; dispatch never takes it.
+	std::vector<std::unique_ptr<const SinkSet>> m_retiredSinks;         ///< snapshots replaced from inside a sink (m_sinksMutex).
+
+	const std::uint64_t                    m_generation;          ///< distinguishes this stream from earlier ones in a thread's cache.
+	std::mutex                             m_producersMutex;      ///< guards m_producers (taken once per new thread, and per drain pass).
+	std::vector<std::shared_ptr<Producer>> m_producers;           ///< every live producer ring.
+	std::atomic_bool                       m_idle{false};         ///< the backend is (about to be) asleep; producers must wake it.
+	std::atomic<std::uint32_t>             m_wakeups{0};          ///< the backend's wait word; bumped to wake it.
+	std::atomic<std::uint64_t>             m_flushRequested{0};   ///< flush generations requested by callers.
+	std::uint64_t                          m_flushCompleted = 0;  ///< flush generations the backend has satisfied (m_flushMutex).
+	std::mutex                             m_flushMutex;
+	std::condition_variable                m_flushDone;
+	std::jthread                           m_thread;              ///< the backend; declared last so it starts after, and stops before, the rest.
 };
 
 #endif    // LogStream_h_
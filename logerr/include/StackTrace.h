@@ -36,6 +36,7 @@
 //	INCLUDES
 //------------------------------
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -108,9 +109,9 @@ public:
 	/**
 	 * @brief		Symbolize a caller-provided array of raw return addresses into the formatted trace footer.
 	 * @details		Shares the exact per-frame symbolization and text formatting used by the constructor, so a
-	 *				caller that captured its own frames (the async trace-log worker) produces identical output
-	 *				without re-capturing. Serializes access to the process-global symbolizer (DbgHelp / BFD)
-	 *				internally, so it is safe to call from any thread.
+	 *				caller that captured its own frames (the async trace-log workers) produces identical output
+	 *				without re-capturing. Safe to call from any thread: DbgHelp is serialized internally, and the
+	 *				BFD symbolizer locks each module, so concurrent calls only wait on each other within a module.
 	 * @param[in]	frames	the raw return addresses to symbolize, in innermost-first order.
 	 * @param[in]	count	the number of addresses in @p frames.
 	 * @returns		The formatted, newline-terminated trace footer; empty when @p count is zero.
@@ -144,6 +145,15 @@ public:
 	 */
 	[[nodiscard]] static bool firstTimeForStack(void* const* frames, int count);
 
+	/**
+	 * @brief		A fingerprint of the call stack in @p frames: the key firstTimeForStack() records.
+	 * @details		Identical stacks fingerprint identically within a process run. Never 0, so a traced log record
+	 *				can carry it as its LogRecord::Trace::stack.
+	 * @param[in]	frames	the raw return addresses that identify the stack.
+	 * @param[in]	count	the number of addresses in @p frames.
+	 */
+	[[nodiscard]] static std::uint64_t fingerprint(void* const* frames, int count) noexcept;
+
 private:
 	static const size_t MAX_FRAMES = 256;    ///< Arbitrary.
 
@@ -151,4 +161,29 @@ private:
 	bool               m_suppressed = false;    ///< true when deduplicateByStack collapsed this trace as a repeat stack.
 	std::vector<void*> m_frames;                ///< the post-skip return addresses captured (and symbolized) for this trace.
 };
+
+namespace logerr
+{
+	/**
+	 * @brief		Load the symbols of every module in the process on a low-priority background thread.
+	 * @details		The first trace of a process otherwise pays to open and index the symbol table of each module on its
+	 *				stack - hundreds of milliseconds for a large binary, spent while an error is being handled. Returns
+	 *				at once; calls after the first do nothing. Started by LOGERR_CONSOLE_APP_BEGIN and
+	 *				LOGERR_GUI_APP_BEGIN when logerr is configured with LOGERR_PREWARM_SYMBOLS.
+	 */
+	void prewarmSymbols();
+
+	/**
+	 * @brief		Whether prewarmSymbols() has finished, so a trace taken now resolves without opening any module.
+	 */
+	[[nodiscard]] bool symbolsReady() noexcept;
+}    // namespace logerr
+
+/// Start logerr::prewarmSymbols() if logerr was configured with LOGERR_PREWARM_SYMBOLS; used by the application macros.
+#ifdef LOGERR_PREWARM_SYMBOLS
+#define LOGERR_START_SYMBOL_PREWARM() logerr::prewarmSymbols()
+#else
+#define LOGERR_START_SYMBOL_PREWARM() static_cast<void>(0)
+#endif
+
 #endif    // stackTrace_h_
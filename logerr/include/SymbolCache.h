@@ -0,0 +1,150 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	SYMBOL CACHE
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+//
+/// @file	SymbolCache.h
+/// @brief	Resolved stack frames, remembered across every trace the process symbolizes.
+/// @details
+///		Error stacks share most of their frames - the main loop, the dispatcher, the worker lambda -
+///		yet each frame used to go through the symbolizer's section walk and line-table lookup again
+///		for every trace. The cache keeps what a frame resolved to, keyed by the module it lies in and
+///		its offset from that module's load address, so a repeated frame costs a hash lookup.
+///
+///		It is bounded: split into shards, each with its own lock and least-recently-used order, so
+///		symbolizer threads rarely contend and a long-running process keeps the frames it sees most.
+///		stats() reports how often it helped.
+//
+//--------------------------------------------------------------------------------------------------
+
+#pragma once
+#ifndef SymbolCache_h_
+#define SymbolCache_h_
+
+//-------------------------
+//	INCLUDES
+//-------------------------
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+//--------------------------------------------------------------------------------------------------
+//	SymbolCache
+//--------------------------------------------------------------------------------------------------
+class SymbolCache
+{
+public:
+	static constexpr std::size_t defaultCapacity = 16 * 1024;
+
+	/// A frame, as the module it lies in and its offset into it.
+	struct Key
+	{
+		std::uint64_t module = 0;    ///< identifies a loaded module: its path and load address, hashed.
+		std::uint64_t offset = 0;    ///< the frame's address relative to the module's load address.
+
+		bool operator==(const Key&) const noexcept = default;
+	};
+
+	/// What a frame resolved to.
+	struct Symbol
+	{
+		std::string location;    ///< "file:line", or "??:0".
+		std::string function;    ///< demangled; empty if the symbolizer found none.
+	};
+
+	struct Stats
+	{
+		std::uint64_t hits      = 0;
+		std::uint64_t misses    = 0;
+		std::uint64_t evictions = 0;
+		std::size_t   entries   = 0;
+		std::size_t   capacity  = 0;
+
+		/// hits / (hits + misses); 0 before the first lookup.
+		[[nodiscard]] double hitRate() const noexcept
+		{
+			return hits + misses != 0 ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 0.0;
+		}
+	};
+
+	explicit SymbolCache(std::size_t capacity = defaultCapacity);
+
+	SymbolCache(const SymbolCache&)            = delete;
+	SymbolCache& operator=(const SymbolCache&) = delete;
+
+	/// The process-wide cache the symbolizer uses. Never destroyed: traces are symbolized during exit-time teardown too.
+	static SymbolCache& instance();
+
+	/// @brief		The symbol cached for @p key, counted as a hit or a miss. Thread-safe.
+	[[nodiscard]] std::optional<Symbol> find(const Key& key);
+
+	/// @brief		Remember @p symbol for @p key, evicting the shard's least recently used frame if it is full.
+	///				Thread-safe.
+	void insert(const Key& key, Symbol symbol);
+
+	/// @brief		Change the number of frames kept (0: cache nothing); frames over the new limit are evicted.
+	void setCapacity(std::size_t capacity);
+
+	/// @brief		Forget every frame and reset the statistics.
+	void clear();
+
+	[[nodiscard]] Stats stats() const;
+
+private:
+	static constexpr std::size_t shardCount = 16;
+
+	static constexpr std::uint64_t mix(const Key& key) noexcept { return key.module ^ (key.offset * 0x9E3779B97F4A7C15ULL); }
+
+	struct KeyHash
+	{
+		std::size_t operator()(const Key& key) const noexcept { return static_cast<std::size_t>(mix(key)); }
+	};
+
+	struct Shard
+	{
+		using Order = std::list<std::pair<Key, Symbol>>;    ///< most recently used first.
+
+		mutable std::mutex                                mutex;
+		Order                                             order;
+		std::unordered_map<Key, Order::iterator, KeyHash> index;
+	};
+
+	Shard& shardFor(const Key& key) noexcept { return m_shards[(mix(key) >> 32) % shardCount]; }
+	/// The most frames one shard holds.
+	[[nodiscard]] std::size_t shardCapacity() const noexcept;
+	/// Drop the least recently used frames until @p shard holds at most @p limit. Call with the shard locked.
+	void trim(Shard& shard, std::size_t limit);
+
+	std::array<Shard, shardCount> m_shards;
+	std::atomic<std::size_t>      m_capacity;
+	std::atomic<std::uint64_t>    m_hits{0};
+	std::atomic<std::uint64_t>    m_misses{0};
+	std::atomic<std::uint64_t>    m_evictions{0};
+};
+
+#endif    // SymbolCache_h_
@@ -37,45 +37,49 @@
 //----------------------------------------------------------------------------------------------------------------------
 //      NAMESPACE: APPINFO
 //----------------------------------------------------------------------------------------------------------------------
+/// @brief		Build, host and running-process identity.
+/// @details	Everything about the build and the running process is resolved once, on first use, into immutable storage
+///				that lives for the rest of the process, and returned by reference - a log prefix pays no lookup and no
+///				copy. Only the Path Info accessors are computed per call, because they follow the environment.
 namespace APPINFO
 {
 	// Application Info
-	std::string name();
-	std::string organization();
-	std::string organizationDomain();
-	std::string version();
+	const std::string& name();
+	const std::string& organization();
+	const std::string& organizationDomain();
+	const std::string& version();
 
 	// Git Info
-	std::string gitBranch();
-	std::string gitCommitShort();
-	std::string gitCommitLong();
-	std::string gitTag();
-	std::string gitDirty();
-	std::string gitOrigin();
-	std::string gitDirectory();
-	std::string gitRepo();
-	std::string gitUser();
-	std::string gitEmail();
+	const std::string& gitBranch();
+	const std::string& gitCommitShort();
+	const std::string& gitCommitLong();
+	const std::string& gitTag();
+	const std::string& gitDirty();
+	const std::string& gitOrigin();
+	const std::string& gitDirectory();
+	const std::string& gitRepo();
+	const std::string& gitUser();
+	const std::string& gitEmail();
 
 	// Build Host Info
-	std::string buildHostname();
-	std::string buildOSName();
-	std::string buildOSVersion();
-	std::string buildOSProcessor();
-	std::string cmakeVersion();
-	std::string compilerName();
-	std::string compilerVersion();
-	std::string qtVersion();
+	const std::string& buildHostname();
+	const std::string& buildOSName();
+	const std::string& buildOSVersion();
+	const std::string& buildOSProcessor();
+	const std::string& cmakeVersion();
+	const std::string& compilerName();
+	const std::string& compilerVersion();
+	const std::string& qtVersion();
 
 	// Runtime Host Info
-	std::string hostCPUArchitecture();
-	std::string hostKernelType();
-	std::string hostKernelVersion();
-	std::string hostName();
-	std::string hostUniqueID();
-	std::string hostPrettyProductName();
-	std::string hostProductType();
-	std::string hostProductVersion();
+	const std::string& hostCPUArchitecture();
+	const std::string& hostKernelType();
+	const std::string& hostKernelVersion();
+	const std::string& hostName();
+	const std::string& hostUniqueID();
+	const std::string& hostPrettyProductName();
+	const std::string& hostProductType();
+	const std::string& hostProductVersion();
 
 	// Path Info
 	std::string home();
@@ -87,10 +91,10 @@ namespace APPINFO
 	std::string configDir();
 
 	// Current Application Instance Info
-	std::string applicationStartTime();
+	const std::string& applicationStartTime();
 
 	// Full System Details
-	std::string systemDetails();
+	const std::string& systemDetails();
 }    // namespace APPINFO
 
 #endif    // appinfo_h__
@@ -26,10 +26,11 @@
 /// @details
 ///		A LOGERR footer's stack trace is symbolized on a background worker, not on the thread that
 ///		logged the error. The logging thread only captures the raw return addresses (microseconds)
-///		and hands them off; it never blocks on the tens-of-milliseconds symbol resolution. The
-///		worker writes the WHOLE entry - the error line and its trace footer - as one atomic unit, so
-///		message and trace are always contiguous in the log and no error line ever waits on its own
-///		trace. This keeps an error on a latency-sensitive thread (a GUI thread, a worker loop that
+///		and hands them off; it never blocks on the tens-of-milliseconds symbol resolution. A few
+///		worker threads symbolize entries concurrently, and an ordered output stage writes each WHOLE
+///		entry - the error line and its trace footer - as one atomic unit, in the order the entries
+///		were enqueued, so message and trace are always contiguous in the log and no error line ever
+///		waits on its own trace. This keeps an error on a latency-sensitive thread (a GUI thread, a worker loop that
 ///		must then emit a signal) from stalling on symbolization.
 //
 //--------------------------------------------------------------------------------------------------
@@ -41,6 +42,7 @@
 #include <vector>
 
 class StackTraceException;
+struct QueueLimits;
 
 namespace logerr
 {
@@ -78,6 +80,12 @@ namespace logerr
 	/// @param[in]	error	the caught exception whose errorMessage() and frames() (throw site) are logged.
 	void logCaughtError(const StackTraceException& error);
 
+	/// @brief		Bound the queue of errors waiting for symbolization (see BoundedQueue.h).
+	/// @details	Unbounded by default: symbolization keeps up with any sane error rate, and an error is the last line
+	///				to lose. A process that can produce error storms sets entry/byte limits and a policy here; dropped
+	///				errors are reported as one "N lines dropped" warning once the worker catches up.
+	void setTracedErrorQueueLimits(const QueueLimits& limits);
+
 	/// @brief		Synchronously drain every pending trace entry and stop the worker.
 	/// @details	Called at process exit so no error entry is lost, and by the fatal-crash handler BEFORE it exits the
 	///				process (an async worker would not otherwise drain before std::exit/abort). Safe to call more than
@@ -4,6 +4,7 @@
 #error "this file should only be used on linux"
 #endif
 
+#include <cstddef>
 #include <string>
 #include <utility>
 #include <vector>
@@ -11,5 +12,11 @@
 /// @brief Backtrace symbols returning file and function names
 /// @param addrList The output of the linux `backtrace` function
 /// @param numAddr The size returned by the linux `backtrace` function
-/// @return a vector of string pairs, where the first is the filename:line, and the second is the function name
+/// @return a vector of string pairs, where the first is the filename:line, and the second is the demangled function name.
+///         Frames resolved before come from SymbolCache::instance().
 std::vector<std::pair<std::string, std::string>>        backtraceSymbols(void* const* addrList, int numAddr);
+
+/// @brief Open, and index, the symbol table of every module loaded in the process, so a later backtraceSymbols call
+///        finds them ready. A module opened before costs nothing; blocks until the others are done.
+/// @return the number of modules whose symbols are ready.
+std::size_t                                             prewarmSymbolTables();
@@ -449,6 +449,37 @@ public:
 		return true;
 	}
 
+	/// @brief Block until an item is available, stop is requested, or @p deadline passes, then pop one item.
+	/// @details Like `wait_pop`, queued data wins over both stop and the deadline.
+	/// @return true if an item was dequeued into @p destination.
+	template<class Clock, class Duration>
+	bool wait_pop_until(T& destination, std::stop_token stop, const std::chrono::time_point<Clock, Duration>& deadline)
+	{
+		write_lock_type lock_this(this->mutex);
+		if (!new_element.wait_until(lock_this, stop, deadline, [this] { return !queue.empty(); }))
+			return false;
+
+		destination = std::move(queue.front());
+		queue.pop_front();
+		return true;
+	}
+
+	/// @brief Dequeue every item queued at the moment of the call, appending them to @p destination in order.
+	/// @details One lock acquisition for the whole batch, where a loop of `try_pop` takes one per item (and may give up
+	///          early under contention). Does not block.
+	/// @param[out] destination Any container with `push_back(T&&)`.
+	/// @return the number of items dequeued.
+	template<class Container>
+	size_t pop_all(Container& destination)
+	{
+		write_lock_type lock_this(this->mutex);
+		const size_t    count = queue.size();
+		for (T& item : queue)
+			destination.push_back(std::move(item));
+		queue.clear();
+		return count;
+	}
+
 	/// @}
 
 	//----------------------------
@@ -0,0 +1,331 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	DEFERRED FORMAT
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+//
+/// @file	deferredFormat.h
+/// @brief	Binary capture at the call site, std::format-style rendering on the LogStream backend.
+/// @details
+///		`LOGINFO_FMT("x={} y={}", x, y)` does no formatting on the logging thread. It copies a pointer
+///		to the call site's static logerr::Site, the raw system_clock timestamp and the argument bytes
+///		into the thread's LogRing, and returns. The LogStream backend decodes the arguments and does
+///		the timestamp, prefix and format work before fanning the line out to the sinks, so the line
+///		that reaches a sink is byte-for-byte what `LOGINFO << ...` would have produced.
+///
+///		Arithmetic arguments are copied as raw bytes and string-like arguments (std::string,
+///		std::string_view, C strings) as length-prefixed bytes. Any other streamable type is rendered
+///		with operator<< at the call site - the same cost `LOGINFO <<` pays - and travels as a string.
+///
+///		When std::cout is not captured by a LogStream (or the caller is itself a sink) the record is
+///		formatted synchronously and written to std::cout instead.
+//
+//--------------------------------------------------------------------------------------------------
+
+#pragma once
+#ifndef logerr_deferredFormat_h_
+#define logerr_deferredFormat_h_
+
+//-------------------------
+//	INCLUDES
+//-------------------------
+
+#include <LogStream.h>
+#include <logSite.h>
+
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#if __has_include(<format>)
+#include <format>
+#endif
+
+namespace logerr
+{
+	/// Renders a record's encoded arguments into @p out using the site's format string.
+	using DeferredFormatter = void (*)(const Site& site, std::span<const std::byte> arguments, std::string& out);
+
+	/// The fixed-size head of every deferred record; the encoded arguments follow it.
+	struct DeferredHeader
+	{
+		DeferredFormatter formatter;    ///< instantiated for the call site's argument types.
+		const Site*       site;
+		std::int64_t      timestamp;    ///< system_clock nanoseconds since the epoch, taken at the call site.
+		const char*       signature;    ///< the arguments' types, for readers that cannot call formatter (see detail::signature).
+	};
+
+	/// @brief		Render a deferred record (a DeferredHeader followed by its arguments) as a complete log line.
+	/// @details	The line is laid out exactly like the streaming macros: `[ts] [app] [LEVEL]    message\n`.
+	std::string formatDeferred(std::span<const std::byte> record);
+
+	/// Append the line formatDeferred(@p record) would return to @p out.
+	void formatDeferred(std::span<const std::byte> record, std::string& out);
+
+	namespace detail
+	{
+		/// How an argument travels through the ring: arithmetic values by value, everything else as text.
+		template<typename T>
+		using Stored = std::conditional_t<std::is_arithmetic_v<T>, T, std::string_view>;
+
+		template<typename T>
+		constexpr bool travelsAsIs = std::is_arithmetic_v<T> || std::is_convertible_v<const T&, std::string_view>;
+
+		/// Arithmetic and string-like arguments pass through untouched; anything else is streamed to text right here.
+		template<typename T>
+		decltype(auto) prepare(const T& value)
+		{
+			if constexpr (travelsAsIs<T>)
+			{
+				return (value);
+			}
+			else
+			{
+				std::ostringstream text;
+				text << value;
+				return std::move(text).str();
+			}
+		}
+
+		template<typename T>
+		std::string_view textOf(const T& value) noexcept
+		{
+			if constexpr (std::is_pointer_v<T>)
+				return value != nullptr ? std::string_view(value) : std::string_view("(null)");
+			else
+				return std::string_view(value);
+		}
+
+		template<typename T>
+		std::size_t encodedSize(const T& value) noexcept
+		{
+			if constexpr (std::is_arithmetic_v<T>)
+				return sizeof(T);
+			else
+				return sizeof(std::uint32_t) + textOf(value).size();
+		}
+
+		template<typename T>
+		std::byte* encode(std::byte* out, const T& value) noexcept
+		{
+			if constexpr (std::is_arithmetic_v<T>)
+			{
+				std::memcpy(out, &value, sizeof(T));
+				return out + sizeof(T);
+			}
+			else
+			{
+				const std::string_view text   = textOf(value);
+				const auto             length = static_cast<std::uint32_t>(text.size());
+				std::memcpy(out, &length, sizeof(length));
+				std::memcpy(out + sizeof(length), text.data(), length);
+				return out + sizeof(length) + length;
+			}
+		}
+
+		template<typename T>
+		T decode(const std::byte*& in) noexcept
+		{
+			if constexpr (std::is_arithmetic_v<T>)
+			{
+				T value;
+				std::memcpy(&value, in, sizeof(T));
+				in += sizeof(T);
+				return value;
+			}
+			else
+			{
+				std::uint32_t length = 0;
+				std::memcpy(&length, in, sizeof(length));
+				const std::string_view text(reinterpret_cast<const char*>(in + sizeof(length)), length);
+				in += sizeof(length) + length;
+				return text;
+			}
+		}
+
+		/// @brief		How one stored argument type is described to a reader without the call site's types (the binary log
+		///				decoder): a kind letter - b(ool), c(har), i(nteger), u(nsigned), f(loating point), s(tring) - and
+		///				'0' + its size in bytes.
+		template<typename T>
+		constexpr std::array<char, 2> typeCode() noexcept
+		{
+			if constexpr (std::is_same_v<T, std::string_view>)
+				return {'s', static_cast<char>('0' + sizeof(std::uint32_t))};
+			else if constexpr (std::is_same_v<T, bool>)
+				return {'b', '1'};
+			else if constexpr (std::is_same_v<T, char>)
+				return {'c', '1'};
+			else if constexpr (std::is_floating_point_v<T>)
+				return {'f', static_cast<char>('0' + sizeof(T))};
+			else if constexpr (std::is_signed_v<T>)
+				return {'i', static_cast<char>('0' + sizeof(T))};
+			else
+				return {'u', static_cast<char>('0' + sizeof(T))};
+		}
+
+		/// The null-terminated type codes of one argument-type list, in encoding order.
+		template<typename... Values>
+		inline constexpr std::array<char, 2 * sizeof...(Values) + 1> signature = []
+		{
+			std::array<char, 2 * sizeof...(Values) + 1> codes{};
+			std::size_t                                 at = 0;
+			((codes[at++] = typeCode<Values>()[0], codes[at++] = typeCode<Values>()[1]), ...);
+			return codes;
+		}();
+
+#if !defined(__cpp_lib_format)
+		inline void appendArgument(std::string& out, std::string_view value)
+		{
+			out += value;
+		}
+
+		template<typename T>
+		void appendArgument(std::string& out, T value)
+		{
+			if constexpr (std::is_same_v<T, bool>)
+			{
+				out += value ? "true" : "false";
+			}
+			else if constexpr (std::is_same_v<T, char>)
+			{
+				out += value;
+			}
+			else
+			{
+				char buffer[64];
+				const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+				out.append(buffer, result.ptr);
+			}
+		}
+#endif
+
+		/// @brief		Append std::format(format, args...) to @p out.
+		/// @details	A malformed format string never throws out of the backend: the error is rendered into the line.
+		///				Without <format> (older standard libraries) a subset is supported: `{}` and `{N}` replacement
+		///				fields and `{{` / `}}` escapes, with any format spec ignored.
+		template<typename... Args>
+		void formatTo(std::string& out, std::string_view format, const Args&... args)
+		{
+#if defined(__cpp_lib_format)
+			try
+			{
+				std::vformat_to(std::back_inserter(out), format, std::make_format_args(args...));
+			}
+			catch (const std::format_error& error)
+			{
+				out += "[format error: ";
+				out += error.what();
+				out += ']';
+			}
+#else
+			const auto appendNth = [&](std::size_t n)
+			{
+				std::size_t index = 0;
+				((index++ == n ? appendArgument(out, args) : void()), ...);
+			};
+
+			std::size_t next = 0;
+			for (std::size_t i = 0; i < format.size(); ++i)
+			{
+				const char c = format[i];
+				if ((c == '{' || c == '}') && i + 1 < format.size() && format[i + 1] == c)
+				{
+					out += c;
+					++i;
+					continue;
+				}
+				const std::size_t close = c == '{' ? format.find('}', i) : std::string_view::npos;
+				if (close == std::string_view::npos)
+				{
+					out += c;
+					continue;
+				}
+
+				const std::string_view field = format.substr(i + 1, close - i - 1);
+				const std::string_view id    = field.substr(0, field.find(':'));
+				std::size_t            n     = next++;
+				if (!id.empty())
+					std::from_chars(id.data(), id.data() + id.size(), n);
+				if (n < sizeof...(Args))
+					appendNth(n);
+				else
+					out += format.substr(i, close - i + 1);
+				i = close;
+			}
+#endif
+		}
+
+		/// The DeferredFormatter for one argument-type list.
+		template<typename... Values>
+		void formatStored(const Site& site, std::span<const std::byte> arguments, std::string& out)
+		{
+			[[maybe_unused]] const std::byte* cursor = arguments.data();
+			// braced initialization decodes left to right, in encoding order
+			const std::tuple<Values...> values{decode<Values>(cursor)...};
+			std::apply([&](const auto&... value) { formatTo(out, site.format, value...); }, values);
+		}
+
+		template<typename... Prepared>
+		void submit(const Site& site, std::int64_t timestamp, const Prepared&... args)
+		{
+			const DeferredHeader header{&formatStored<Stored<Prepared>...>, &site, timestamp, signature<Stored<Prepared>...>.data()};
+			const std::size_t    size   = sizeof(header) + (std::size_t{0} + ... + encodedSize(args));
+			const auto           write  = [&](std::byte* out) noexcept
+			{
+				std::memcpy(out, &header, sizeof(header));
+				out += sizeof(header);
+				((out = encode(out, args)), ...);
+			};
+
+			auto* stream = dynamic_cast<LogStream*>(std::cout.rdbuf());
+			if (stream != nullptr && stream->submitDeferred(size, write))
+				return;
+
+			std::vector<std::byte> record(size);
+			write(record.data());
+			const std::string line = formatDeferred(record);
+			if (stream != nullptr)
+				stream->tagLine(site.level);
+			std::cout.write(line.data(), static_cast<std::streamsize>(line.size()));
+		}
+	}    // namespace detail
+
+	/// @brief		Log one line whose formatting is deferred to the LogStream backend. Use through the LOG*_FMT macros;
+	///				@p site must be a static object carrying the format string.
+	template<typename... Args>
+	void logDeferred(const Site& site, const Args&... args)
+	{
+		const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch());
+		detail::submit(site, static_cast<std::int64_t>(now.count()), detail::prepare(args)...);
+	}
+}    // namespace logerr
+
+#endif    // logerr_deferredFormat_h_
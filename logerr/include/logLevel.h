@@ -0,0 +1,129 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LOG LEVEL
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+//
+/// @file	logLevel.h
+/// @brief	Compile-time and runtime severity thresholds for the LOG* macros.
+/// @details
+///		Every LOG* macro checks its level BEFORE anything is evaluated: a suppressed statement
+///		constructs no timestamp, looks up no application name and evaluates none of its streamed
+///		arguments. Two thresholds apply:
+///
+///		- LOGERR_MIN_LEVEL (compile time): statements below it are discarded by `if constexpr` and
+///		  never reach the binary. Define it to one of the LOGERR_LEVEL_* values, e.g.
+///		  `-DLOGERR_MIN_LEVEL=LOGERR_LEVEL_INFO` (or the LOGERR_MIN_LEVEL CMake cache variable).
+///		- the runtime level: a global threshold, optionally overridden per tag for the tagged
+///		  macros (LOGINFO_TAG(tag) etc.). Both live in atomics, so changing them is safe from any
+///		  thread; the check on the logging thread is a single relaxed load while no tag override is
+///		  set, and a short lock-free table probe otherwise.
+//
+//--------------------------------------------------------------------------------------------------
+
+#pragma once
+#ifndef logerr_logLevel_h_
+#define logerr_logLevel_h_
+
+//-------------------------
+//	INCLUDES
+//-------------------------
+
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+//-------------------------
+//	MACROS
+//-------------------------
+
+#define LOGERR_LEVEL_DEBUG   0
+#define LOGERR_LEVEL_INFO    1
+#define LOGERR_LEVEL_WARNING 2
+#define LOGERR_LEVEL_ERROR   3
+#define LOGERR_LEVEL_OFF     4
+
+#ifndef LOGERR_MIN_LEVEL
+#define LOGERR_MIN_LEVEL LOGERR_LEVEL_DEBUG
+#endif
+
+namespace logerr
+{
+	/// Log severities, in increasing order.
+	enum class Level : std::uint8_t
+	{
+		Debug   = LOGERR_LEVEL_DEBUG,
+		Info    = LOGERR_LEVEL_INFO,
+		Warning = LOGERR_LEVEL_WARNING,
+		Error   = LOGERR_LEVEL_ERROR,
+		Off     = LOGERR_LEVEL_OFF,    ///< as a threshold: nothing passes.
+	};
+
+	namespace detail
+	{
+		inline constexpr std::uint8_t disabledBit = 0x80;    ///< set in g_threshold by setEnabled(false).
+
+		/// The global level, with disabledBit or'ed in while logging is disabled - so one load answers both questions.
+		inline std::atomic<std::uint8_t> g_threshold{static_cast<std::uint8_t>(Level::Debug)};
+
+		/// How many tags currently carry their own level. Zero keeps tagged checks on the global fast path.
+		inline std::atomic<std::uint32_t> g_tagOverrides{0};
+
+		bool tagEnabled(Level level, std::string_view tag) noexcept;
+	}    // namespace detail
+
+	/// Whether statements at @p level are compiled in at all (see LOGERR_MIN_LEVEL).
+	constexpr bool compiledIn(Level level) noexcept
+	{
+		return level >= static_cast<Level>(LOGERR_MIN_LEVEL);
+	}
+
+	/// Whether an untagged statement at @p level should be logged right now.
+	inline bool isEnabled(Level level) noexcept
+	{
+		return static_cast<std::uint8_t>(level) >= detail::g_threshold.load(std::memory_order_relaxed);
+	}
+
+	/// Whether a statement at @p level for @p tag should be logged right now. The tag's own level wins when it has one.
+	inline bool isEnabled(Level level, std::string_view tag) noexcept
+	{
+		if (detail::g_tagOverrides.load(std::memory_order_relaxed) == 0)
+			return isEnabled(level);
+		return detail::tagEnabled(level, tag);
+	}
+
+	/// Set the global runtime level. Statements below it are skipped without evaluating their arguments.
+	void setLevel(Level level) noexcept;
+
+	/// The global runtime level.
+	Level level() noexcept;
+
+	/// @brief		Give @p tag its own runtime level, overriding the global one for the tagged macros.
+	/// @return		false if the (fixed-size) tag table is full and the tag has no slot yet.
+	bool setTagLevel(std::string_view tag, Level level);
+
+	/// Remove @p tag's own level, so it follows the global level again.
+	void clearTagLevel(std::string_view tag) noexcept;
+
+	/// Suppress (false) or restore (true) all logging without changing any level. Used by LOGERR_DISABLE/LOGERR_ENABLE.
+	void setEnabled(bool enabled) noexcept;
+}    // namespace logerr
+
+#endif    // logerr_logLevel_h_
@@ -0,0 +1,105 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LOG SITE
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+//
+/// @file	logSite.h
+/// @brief	The static, per-call-site descriptor every LOG* macro expansion creates.
+/// @details
+///		Each LOG* expansion declares one `static constexpr logerr::Site` holding everything about the
+///		statement that is fixed at compile time - level, file basename, line, function and tag - and
+///		passes its address on. Nothing about the location is streamed per call: the
+///		"[file:line function]" text is rendered once per site and cached, and the site's address is
+///		a stable key for anything that wants per-statement state (binary sinks, rate limiters,
+///		dynamic toggles).
+//
+//--------------------------------------------------------------------------------------------------
+
+#pragma once
+#ifndef logerr_logSite_h_
+#define logerr_logSite_h_
+
+//-------------------------
+//	INCLUDES
+//-------------------------
+
+#include <logLevel.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace logerr
+{
+	/// One log statement's compile-time description. Always a static constexpr object, so its address is stable.
+	struct Site
+	{
+		Level         level;
+		const char*   file;                 ///< the source file basename.
+		std::uint32_t line;
+		const char*   function;             ///< the full function signature.
+		const char*   tag;                  ///< the [tag] field, or nullptr for the application name.
+		const char*   format = nullptr;     ///< the format string of a deferred (LOG*_FMT) statement.
+	};
+
+	/// The padded "[LEVEL]" column for @p level.
+	constexpr std::string_view levelLabel(Level level) noexcept
+	{
+		switch (level)
+		{
+			case Level::Debug: return "[DEBUG]    ";
+			case Level::Info: return "[INFO]     ";
+			case Level::Warning: return "[WARNING]  ";
+			case Level::Error: return "[ERROR]    ";
+			default: return "";
+		}
+	}
+
+	/// @brief		The constant part of an untagged line's prefix after the timestamp: "] [app] [LEVEL]    ".
+	/// @details	Built once per level from the interned application name, so a prefix appends one span instead of
+	///				streaming the name and label separately.
+	std::string_view levelPrefix(Level level);
+
+	/// Whether the statement at @p site should be logged right now (its tag's level, else the global level).
+	inline bool isEnabled(const Site& site) noexcept
+	{
+		return site.tag != nullptr ? isEnabled(site.level, site.tag) : isEnabled(site.level);
+	}
+
+	/// @brief		Append the site's "[file:line function]  " column (warnings only; empty otherwise).
+	/// @details	Rendered the first time a site is seen and cached by the site's address after that.
+	void appendLocation(std::string& out, const Site& site);
+
+	/// Append the complete line prefix for @p site: "[ts] [tag] [LEVEL]    " plus the location column, if any.
+	void appendPrefix(std::string& out, const Site& site, std::chrono::system_clock::time_point time);
+
+	/// Streams a site's line prefix, timestamped now, in a single write.
+	struct Prefix
+	{
+		const Site& site;
+	};
+
+	std::ostream& operator<<(std::ostream& os, const Prefix& prefix);
+}    // namespace logerr
+
+#endif    // logerr_logSite_h_
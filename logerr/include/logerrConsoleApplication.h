@@ -51,8 +51,10 @@
 #include <string_view>
 #include <thread>
 
+#include <FlightRecorder.h>
 #include <LogFileWriter.h>
 #include <LogStream.h>
+#include <StackTrace.h>
 #include <StackTraceException.h>
 #include <StackTraceSIGSEGV.h>
 #include <asyncTraceLog.h>
@@ -79,11 +81,14 @@
 	int code          = 0;                                                                                                      \
 	g_mainThreadID    = std::this_thread::get_id();                                                                             \
 	g_mainThreadIDSet = true;                                                                                                   \
+	LOGERR_START_SYMBOL_PREWARM();                                                                                              \
                                                                                                                                 \
-	LogFileWriter logFileWriter;                                                                                                \
-	LogStream     logStream(std::cout);                                                                                         \
+	LogFileWriter  logFileWriter;                                                                                               \
+	FlightRecorder flightRecorder;                                                                                              \
+	LogStream      logStream(std::cout);                                                                                        \
                                                                                                                                 \
-	logStream.registerLogFunction("logFileWriter", [&logFileWriter](std::string str) { logFileWriter.write(std::move(str)); }); \
+	logStream.registerLogFunction("logFileWriter", [&logFileWriter](const LogRecord& record) { logFileWriter.write(record); }); \
+	logStream.registerLogFunction("flightRecorder", [&flightRecorder](const LogRecord& line) { flightRecorder.record(line); }); \
                                                                                                                                 \
 	LOGINFO << APPINFO::name() << ' ' << APPINFO::version() << " Started." << std::endl;                                        \
                                                                                                                                 \
@@ -130,7 +135,7 @@
 		code = 4;                                                                                   \
 	}                                                                                               \
                                                                                                     \
-	if (code == 0) LOGINFO << APPINFO::name() << " Exited Successfully" << std::endl;               \
+	if (code == 0) { LOGINFO << APPINFO::name() << " Exited Successfully" << std::endl; }           \
                                                                                                     \
 	return code;
 #endif
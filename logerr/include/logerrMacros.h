@@ -59,6 +59,10 @@
 #include <appinfo.h>
 #include <StackTrace.h>
 #include <asyncTraceLog.h>
+#include <deferredFormat.h>
+#include <logLevel.h>
+#include <logSite.h>
+#include <logerrStream.h>
 #include <logerrTypes.h>
 
 // Raw return-address capture for the deferred error footer. The capture is cheap (a handful of microseconds) and runs
@@ -157,6 +161,11 @@ namespace logerr
 	class TracingErrorLine
 	{
 	public:
+		/// @brief	The LOGERR / LOGERR_TAG form: everything about the statement comes from its static descriptor.
+		explicit TracingErrorLine(const Site& site)
+		{
+			m_prefix << Prefix{site};
+		}
 		/// @param tag  the subsystem/app tag shown in the [tag] field; defaults to APPINFO::name(). A module-scoped
 		///             consumer (a per-subsystem logger) passes its own tag here and inherits the identical traced,
 		///             deduplicated behavior instead of forking the macro.
@@ -244,41 +253,93 @@ namespace logerr
 // LOG FUNCTIONS
 // Errors and warnings carry their source location automatically. Info/debug remain compact because they are expected
 // operational events rather than diagnostic paths.
+//
+// Every expansion declares one static constexpr logerr::Site (level, file, line, function, tag; see logSite.h) and is
+// gated by its level before anything else: `if (!enabled) {} else <statement>`, so a suppressed statement evaluates none
+// of its arguments, and one below LOGERR_MIN_LEVEL is discarded at compile time. `logerrSite_` names the descriptor
+// inside the statement.
+#define LOGERR_SITE_(severity, tag, format)                                                                              \
+	if constexpr (!::logerr::compiledIn(severity)) {}                                                                    \
+	else if (static constexpr ::logerr::Site logerrSite_{severity, __FILENAME__, static_cast<std::uint32_t>(__LINE__),   \
+	                                                     LOGERR_FUNCTION, tag, format};                                  \
+	         !::logerr::isEnabled(logerrSite_)) {}                                                                       \
+	else
+// Where LOGWARNING / LOGINFO / LOGDEBUG stream to: a logerr::Statement on the calling thread's own stream for the level
+// (see logerrStream.h), which never takes std::cout's sentry and is published whole at the end of the statement. Define
+// LOGERR_USE_COUT to write to std::cout instead, as before; the line is tagged with its level first, so its record still
+// carries it (see logerr::tagCoutLine).
+#if defined(LOGERR_USE_COUT)
+#define LOGERR_STREAM_(severity) (::logerr::tagCoutLine(severity), std::cout)
+#else
+#define LOGERR_STREAM_(severity) ::logerr::Statement(severity)
+#endif
 #ifndef LOGERR
-// LOGERR is a temporary TracingErrorLine: it prints the [ts][app][ERROR][file:line func] prefix, forwards the streamed
-// message, and on end-of-statement appends the FULL stack trace the first time this call site logs (deduped, so a
-// repeating site records the trace once, not every time). __FILE__ doubles as the per-site de-dup key (a stable pointer
-// per source file) alongside __LINE__. Every existing `LOGERR << a << b << ENDL` compiles unchanged.
-#define LOGERR ::logerr::TracingErrorLine(__FILENAME__, __FILE__, static_cast<std::uint32_t>(__LINE__), LOGERR_FUNCTION)
+// LOGERR is a temporary TracingErrorLine: it prints the [ts][app][ERROR] prefix, forwards the streamed message, and on
+// end-of-statement appends the FULL stack trace the first time this stack logs (deduped by stack). Every existing
+// `LOGERR << a << b << ENDL` compiles unchanged.
+#define LOGERR LOGERR_SITE_(::logerr::Level::Error, nullptr, nullptr)::logerr::TracingErrorLine(logerrSite_)
 #endif
 #ifndef LOGWARNING
-#define LOGWARNING                                                                                                       \
-	(std::cout << '[' << TimestampLite() << "] [" << APPINFO::name() << "] [WARNING]  [" << __FILENAME__ << ':'         \
-	           << __LINE__ << ' ' << LOGERR_FUNCTION << "]  ")
+#define LOGWARNING LOGERR_SITE_(::logerr::Level::Warning, nullptr, nullptr) LOGERR_STREAM_(::logerr::Level::Warning) << ::logerr::Prefix{logerrSite_}
 #endif
 #ifndef LOGDEBUG
-#define LOGDEBUG std::cout << '[' << TimestampLite() << "] [" << APPINFO::name() << "] [DEBUG]    "
+#define LOGDEBUG LOGERR_SITE_(::logerr::Level::Debug, nullptr, nullptr) LOGERR_STREAM_(::logerr::Level::Debug) << ::logerr::Prefix{logerrSite_}
 #endif
 #ifndef LOGINFO
-#define LOGINFO std::cout << '[' << TimestampLite() << "] [" << APPINFO::name() << "] [INFO]     "
+#define LOGINFO LOGERR_SITE_(::logerr::Level::Info, nullptr, nullptr) LOGERR_STREAM_(::logerr::Level::Info) << ::logerr::Prefix{logerrSite_}
 #endif
 #ifndef ENDL
 #define ENDL std::endl
 #endif
 
+// Tagged variants: the [tag] field shows @p tag (a string literal) instead of the application name, and the statement is
+// gated by the tag's own runtime level when it has one (logerr::setTagLevel), else by the global level.
+#ifndef LOGERR_TAG
+#define LOGERR_TAG(tag) LOGERR_SITE_(::logerr::Level::Error, tag, nullptr)::logerr::TracingErrorLine(logerrSite_)
+#endif
+#ifndef LOGWARNING_TAG
+#define LOGWARNING_TAG(tag) LOGERR_SITE_(::logerr::Level::Warning, tag, nullptr) LOGERR_STREAM_(::logerr::Level::Warning) << ::logerr::Prefix{logerrSite_}
+#endif
+#ifndef LOGDEBUG_TAG
+#define LOGDEBUG_TAG(tag) LOGERR_SITE_(::logerr::Level::Debug, tag, nullptr) LOGERR_STREAM_(::logerr::Level::Debug) << ::logerr::Prefix{logerrSite_}
+#endif
+#ifndef LOGINFO_TAG
+#define LOGINFO_TAG(tag) LOGERR_SITE_(::logerr::Level::Info, tag, nullptr) LOGERR_STREAM_(::logerr::Level::Info) << ::logerr::Prefix{logerrSite_}
+#endif
+
+// Deferred-format logging: `LOGINFO_FMT("x={} y={}", x, y)`. The call site only copies a pointer to its Site (which
+// carries the format string), the timestamp and the argument bytes; the LogStream backend does the formatting (see
+// deferredFormat.h). The line is identical to the streaming form's, and the trailing newline is implied.
+#define LOGERR_DEFERRED_(severity, format, ...)                                                                          \
+	do                                                                                                                   \
+	{                                                                                                                    \
+		LOGERR_SITE_(severity, nullptr, format)::logerr::logDeferred(logerrSite_ __VA_OPT__(, ) __VA_ARGS__);            \
+	}                                                                                                                    \
+	while (false)
+#ifndef LOGWARNING_FMT
+#define LOGWARNING_FMT(format, ...) LOGERR_DEFERRED_(::logerr::Level::Warning, format __VA_OPT__(, ) __VA_ARGS__)
+#endif
+#ifndef LOGDEBUG_FMT
+#define LOGDEBUG_FMT(format, ...) LOGERR_DEFERRED_(::logerr::Level::Debug, format __VA_OPT__(, ) __VA_ARGS__)
+#endif
+#ifndef LOGINFO_FMT
+#define LOGINFO_FMT(format, ...) LOGERR_DEFERRED_(::logerr::Level::Info, format __VA_OPT__(, ) __VA_ARGS__)
+#endif
+
 // Capture a full trace at this call site without deliberately throwing or changing the caller's control flow. This is
 // opt-in because symbolization is substantially more expensive than LOGERR's source-location prefix.
 #ifndef LOGERR_TRACE
-#define LOGERR_TRACE(msg) (LOGERR << (msg) << '\n' << static_cast<std::string>(::StackTrace(1)) << ENDL)
+#define LOGERR_TRACE(msg) LOGERR << (msg) << '\n' << static_cast<std::string>(::StackTrace(1)) << ENDL
 #endif
 
-// enable/disable logs
+// enable/disable logs. The LOG* macros skip their arguments entirely while disabled; the failbit also silences any raw
+// std::cout output.
 #ifndef LOGERR_DISABLE
-#define LOGERR_DISABLE std::cout.setstate(std::ios::failbit)
+#define LOGERR_DISABLE (::logerr::setEnabled(false), std::cout.setstate(std::ios::failbit))
 #endif
 
 #ifndef LOGERR_ENABLE
-#define LOGERR_ENABLE std::cout.clear()
+#define LOGERR_ENABLE (::logerr::setEnabled(true), std::cout.clear())
 #endif
 
 // error
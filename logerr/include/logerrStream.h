@@ -0,0 +1,103 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LOGERR STREAM
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+//
+/// @file	logerrStream.h
+/// @brief	Per-thread log streams that feed the logging pipeline without going through std::cout.
+/// @details
+///		`logerr::stream(level)` is a std::ostream owned by the calling thread, backed by a LineBuffer.
+///		Writing to it touches no shared state: no std::cout sentry, locale or stdio
+///		synchronization, and no contention with other threads or with unrelated code writing to
+///		stdout. The staged text is handed to the pipeline when a statement ends (or on std::endl /
+///		std::flush): straight into the LogStream that captures std::cout when there is one, else
+///		written to std::cout itself.
+///
+///		The LOG* macros stream through these by default. Define LOGERR_USE_COUT (the CMake option
+///		of the same name) to have them write to std::cout as they used to - LogStream still captures
+///		std::cout either way, so third-party output keeps reaching the sinks. The macros follow the
+///		definition where they expand; LOGERR's traced entries are written by the library, so they
+///		follow the CMake option alone.
+//
+//--------------------------------------------------------------------------------------------------
+
+#pragma once
+#ifndef logerr_logerrStream_h_
+#define logerr_logerrStream_h_
+
+//-------------------------
+//	INCLUDES
+//-------------------------
+
+#include <logLevel.h>
+#include <logSite.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+namespace logerr
+{
+	/// @brief		The calling thread's log stream for @p level.
+	/// @details	Text written to it is published at the next std::endl / std::flush or Statement end. Text still
+	///				pending when the thread exits was never flushed and is dropped, as from any unflushed stream.
+	std::ostream& stream(Level level);
+
+	/// Hand everything written to the calling thread's @p level stream so far to the pipeline.
+	void publish(Level level);
+
+	/// @brief		Hand a complete, newline-terminated traced error to the pipeline as one record.
+	/// @param[in]	entry	the message, then its stack-trace footer.
+	/// @param[in]	level	the level the entry was logged at (see LogRecord::level).
+	/// @param[in]	footer	where the footer starts in @p entry.
+	/// @param[in]	stack	a non-zero fingerprint of the raw frames the footer was symbolized from (see LogRecord::Trace).
+	void publishTraced(std::string_view entry, Level level, std::size_t footer, std::uint64_t stack);
+
+	/// @brief		Tag the line the calling thread is writing to std::cout with @p level, when a LogStream captures it.
+	/// @details	How a LOGERR_USE_COUT line, which is raw std::cout text, still reaches the sinks with its level.
+	void tagCoutLine(Level level) noexcept;
+
+	/// @brief		One LOG* statement on the calling thread's stream: streams the prefix, then publishes the statement
+	///				when the full expression ends.
+	class Statement
+	{
+	public:
+		explicit Statement(Level level)
+		    : m_level(level)
+		    , m_stream(stream(level))
+		{
+		}
+
+		Statement(const Statement&)            = delete;
+		Statement& operator=(const Statement&) = delete;
+
+		~Statement();
+
+		friend std::ostream& operator<<(const Statement& statement, const Prefix& prefix) { return statement.m_stream << prefix; }
+
+	private:
+		Level         m_level;
+		std::ostream& m_stream;
+	};
+}    // namespace logerr
+
+#endif    // logerr_logerrStream_h_
@@ -45,9 +45,12 @@
 //------------------------
 
 #include <chrono>
+#include <cstddef>
 #include <iosfwd>
+#include <optional>
 #include <ostream>
 #include <string>
+#include <string_view>
 #include <ctime>
 
 //	----------------------------------------------------------------------------
@@ -64,12 +67,30 @@ class TimestampLite
 {
 public:
 	TimestampLite();
+	/// @brief	A timestamp for a moment captured earlier, e.g. on the thread that logged a deferred record.
+	explicit TimestampLite(std::chrono::system_clock::time_point time);
 
 	operator std::chrono::system_clock::time_point() const;
 	operator std::time_t() const;
 	operator std::string() const;
 	friend std::ostream& operator<<(std::ostream& os, const TimestampLite& timestamp);
 
+	/// The longest text write() can produce.
+	static constexpr std::size_t maxLength = 64;
+
+	/// @brief		Render "YYYY-mm-dd HH:MM:SS.nnnnnnnnn TZ" into @p buffer, which must hold maxLength chars. Not terminated.
+	/// @details	The date/time prefix and the timezone name are cached per thread and only re-rendered when the second
+	///				changes, so most calls copy two cached spans and write the nine fraction digits - no localtime_r (and
+	///				its glibc lock), no strftime and no allocation.
+	/// @return		the number of chars written (0 if the time cannot be represented).
+	std::size_t write(char* buffer) const;
+
+	/// @brief		Parse a timestamp write() rendered, at the start of @p text, back into the moment it stands for.
+	/// @details	Reads "YYYY-mm-dd HH:MM:SS.nnnnnnnnn" as local time. A timezone name after it settles the hour a
+	///				daylight-saving change repeats. Like write(), only a change of second costs a calendar conversion.
+	/// @return		nothing if @p text does not start with a timestamp.
+	static std::optional<std::chrono::system_clock::time_point> parse(std::string_view text);
+
 private:
 	std::chrono::system_clock::time_point m_now;
 };
@@ -0,0 +1,46 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	BOUNDED QUEUE
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+
+//----------------------------
+//  INCLUDES
+//----------------------------
+
+#include <BoundedQueue.h>
+#include <logSite.h>
+#include <timestampLite.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+//  droppedLinesNotice
+//----------------------------------------------------------------------------------------------------------------------
+std::string logerr::droppedLinesNotice(std::size_t dropped, std::string_view where)
+{
+	char        timestamp[TimestampLite::maxLength];
+	std::string notice(1, '[');
+	notice.append(timestamp, TimestampLite().write(timestamp));
+	notice += levelPrefix(Level::Warning);
+	notice += std::to_string(dropped);
+	notice += dropped == 1 ? " line dropped (" : " lines dropped (";
+	notice += where;
+	notice += ")\n";
+	return notice;
+}
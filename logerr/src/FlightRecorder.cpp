@@ -0,0 +1,306 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	FLIGHT RECORDER
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+
+//----------------------------
+//  INCLUDES
+//----------------------------
+
+// logerr
+#include <FlightRecorder.h>
+#include <appinfo.h>
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+#include <vector>
+
+// platform
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	constexpr std::string_view magic           = "LOGERRF1";
+	constexpr std::uint32_t    padMarker       = 0xFFFFFFFF;
+	constexpr std::uint64_t    minimumCapacity = 4096;
+
+	struct Header
+	{
+		char          magic[8];
+		std::uint64_t capacity;
+		std::uint64_t head;    ///< bytes ever written; the end of the newest record.
+		std::uint64_t tail;    ///< the start of the oldest record not yet overwritten.
+		std::byte     reserved[32];
+	};
+	static_assert(sizeof(Header) == 64);
+
+	/// length, unused, time
+	constexpr std::uint64_t recordHeaderBytes = 16;
+
+	constexpr std::uint64_t padded(std::uint64_t bytes) noexcept
+	{
+		return (bytes + 7) & ~std::uint64_t{7};
+	}
+
+	std::atomic<const FlightRecorder*> g_active{nullptr};
+
+	/// The bytes the record (or pad) at @p position takes up.
+	std::uint64_t sizeAt(const std::byte* ring, std::uint64_t capacity, std::uint64_t position) noexcept
+	{
+		const std::uint64_t offset = position % capacity;
+		if (capacity - offset < recordHeaderBytes)
+			return capacity - offset;
+		std::uint32_t length = 0;
+		std::memcpy(&length, ring + offset, sizeof(length));
+		return length == padMarker ? capacity - offset : padded(recordHeaderBytes + length);
+	}
+
+	/// @brief		The records of a recorder file image stamped within @p window of its newest record.
+	/// @details	@p file may be a live mapping another thread is recording into: the records read are kept only if the
+	///				tail has not passed them by the time they have been copied.
+	std::string readRecent(std::byte* file, std::size_t fileBytes, std::chrono::nanoseconds window)
+	{
+		if (fileBytes < sizeof(Header) || std::string_view(reinterpret_cast<const char*>(file), magic.size()) != magic)
+			return {};
+		auto&               header   = *reinterpret_cast<Header*>(file);
+		const std::uint64_t capacity = header.capacity;
+		if (capacity < minimumCapacity || capacity % 8 != 0 || capacity > fileBytes - sizeof(Header))
+			return {};
+		const std::byte* ring = file + sizeof(Header);
+
+		struct Entry
+		{
+			std::uint64_t position;
+			std::int64_t  time;
+			std::string   text;
+		};
+		std::vector<Entry> entries;
+
+		const std::uint64_t head = std::atomic_ref(header.head).load(std::memory_order_acquire);
+		std::uint64_t       position = std::atomic_ref(header.tail).load(std::memory_order_acquire);
+		while (position < head)
+		{
+			const std::uint64_t offset = position % capacity;
+			const std::uint64_t size   = sizeAt(ring, capacity, position);
+			if (size > capacity - offset || position + size > head)
+				break;    // overwritten under us; whatever is left is discarded below
+			std::uint32_t length = 0;
+			std::memcpy(&length, ring + offset, sizeof(length));
+			if (capacity - offset >= recordHeaderBytes && length != padMarker)
+			{
+				Entry entry{position, 0, {}};
+				std::memcpy(&entry.time, ring + offset + 8, sizeof(entry.time));
+				entry.text.assign(reinterpret_cast<const char*>(ring + offset + recordHeaderBytes), length);
+				entries.push_back(std::move(entry));
+			}
+			position += size;
+		}
+
+		// pairs with the writer's fence: a record it had started to overwrite is behind the tail seen here
+		std::atomic_thread_fence(std::memory_order_acquire);
+		const std::uint64_t tail = std::atomic_ref(header.tail).load(std::memory_order_relaxed);
+		std::erase_if(entries, [tail](const Entry& entry) { return entry.position < tail; });
+		if (entries.empty())
+			return {};
+
+		const std::int64_t newest = entries.back().time;
+		std::string        text;
+		for (const Entry& entry : entries)
+		{
+			if (newest - entry.time <= window.count())
+				text += entry.text;
+		}
+		return text;
+	}
+}    // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+//  FlightRecorder
+//----------------------------------------------------------------------------------------------------------------------
+FlightRecorder::FlightRecorder([[maybe_unused]] std::string path, [[maybe_unused]] std::size_t capacityBytes)
+{
+#if !defined(_WIN32)
+	std::string fallback;
+	if (path.empty())
+	{
+		path     = APPINFO::logDir() + APPINFO::name() + ".flight";
+		fallback = APPINFO::logDir() + APPINFO::name() + '_' + std::to_string(::getpid()) + ".flight";
+	}
+
+	std::error_code ignored;
+	if (const auto directory = std::filesystem::path(path).parent_path(); !directory.empty())
+		std::filesystem::create_directories(directory, ignored);
+
+	// one process per file: a second instance of the application records beside the first instead of into it
+	const auto openLocked = [](const std::string& candidate)
+	{
+		const int fd = ::open(candidate.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+		if (fd >= 0 && ::flock(fd, LOCK_EX | LOCK_NB) != 0)
+		{
+			::close(fd);
+			return -1;
+		}
+		return fd;
+	};
+	m_fd = openLocked(path);
+	if (m_fd < 0 && !fallback.empty())
+		m_fd = openLocked(path = fallback);
+
+	// A restart: the run before this one may have crashed, and its last records are what explains it. Set them aside
+	// as "<path>.prev" rather than record over them, and start a fresh ring.
+	Header existing{};
+	if (m_fd >= 0 && ::pread(m_fd, &existing, sizeof(existing), 0) == static_cast<ssize_t>(sizeof(existing)) &&
+	    std::string_view(existing.magic, magic.size()) == magic && existing.head != existing.tail)
+	{
+		std::error_code renamed;
+		std::filesystem::rename(path, path + std::string(previousSuffix), renamed);
+		if (!renamed)
+		{
+			::close(m_fd);
+			m_fd = openLocked(path);
+		}
+	}
+	m_path = path;
+	if (m_fd < 0)
+		return;
+
+	m_capacity = std::max(padded(capacityBytes), minimumCapacity);
+	m_mapBytes = sizeof(Header) + m_capacity;
+	if (::ftruncate(m_fd, 0) != 0 || ::ftruncate(m_fd, static_cast<off_t>(m_mapBytes)) != 0)
+	{
+		::close(m_fd);
+		m_fd = -1;
+		return;
+	}
+
+	void* map = ::mmap(nullptr, m_mapBytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+	if (map == MAP_FAILED)
+	{
+		::close(m_fd);
+		m_fd = -1;
+		return;
+	}
+	m_map = static_cast<std::byte*>(map);
+
+	auto& header    = *reinterpret_cast<Header*>(m_map);
+	header.capacity = m_capacity;
+	header.head     = 0;
+	header.tail     = 0;
+	std::memcpy(header.magic, magic.data(), magic.size());    // last: a half-initialized file is not a recorder
+	g_active.store(this, std::memory_order_release);
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  ~FlightRecorder
+//----------------------------------------------------------------------------------------------------------------------
+FlightRecorder::~FlightRecorder()
+{
+	const FlightRecorder* self = this;
+	g_active.compare_exchange_strong(self, nullptr, std::memory_order_acq_rel);
+#if !defined(_WIN32)
+	if (m_map != nullptr)
+		::munmap(m_map, m_mapBytes);
+	if (m_fd >= 0)
+		::close(m_fd);
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  record
+//----------------------------------------------------------------------------------------------------------------------
+void FlightRecorder::record(std::string_view text) noexcept
+{
+	if (m_map == nullptr)
+		return;
+
+	text = text.substr(0, static_cast<std::size_t>(m_capacity / 4));
+	auto&               header = *reinterpret_cast<Header*>(m_map);
+	std::byte* const    ring   = m_map + sizeof(Header);
+	const std::uint64_t size   = padded(recordHeaderBytes + text.size());
+
+	// a record never straddles the end of the ring: pad to the end and start over at 0
+	std::uint64_t       position = header.head;
+	const std::uint64_t pad      = m_capacity - position % m_capacity < size ? m_capacity - position % m_capacity : 0;
+
+	// Move the tail past everything about to be overwritten, then fence, so a reader that sees new bytes where an old
+	// record was also sees that the record is gone.
+	std::uint64_t tail = header.tail;
+	while (position + pad + size - tail > m_capacity)
+		tail += sizeAt(ring, m_capacity, tail);
+	std::atomic_ref(header.tail).store(tail, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	if (pad != 0)
+	{
+		std::memcpy(ring + position % m_capacity, &padMarker, sizeof(padMarker));
+		position += pad;
+	}
+
+	const auto          length = static_cast<std::uint32_t>(text.size());
+	const std::uint32_t unused = 0;
+	const std::int64_t  time   = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	std::byte* const    slot   = ring + position % m_capacity;
+	std::memcpy(slot, &length, sizeof(length));
+	std::memcpy(slot + 4, &unused, sizeof(unused));
+	std::memcpy(slot + 8, &time, sizeof(time));
+	std::memcpy(slot + recordHeaderBytes, text.data(), text.size());
+
+	std::atomic_ref(header.head).store(position + size, std::memory_order_release);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  recent
+//----------------------------------------------------------------------------------------------------------------------
+std::string FlightRecorder::recent(std::chrono::nanoseconds window) const
+{
+	return m_map != nullptr ? readRecent(m_map, m_mapBytes, window) : std::string();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  recover
+//----------------------------------------------------------------------------------------------------------------------
+std::string FlightRecorder::recover(const std::filesystem::path& path, std::chrono::nanoseconds window)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+		return {};
+	std::vector<char> image((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	return readRecent(reinterpret_cast<std::byte*>(image.data()), image.size(), window);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  active
+//----------------------------------------------------------------------------------------------------------------------
+const FlightRecorder* FlightRecorder::active() noexcept
+{
+	return g_active.load(std::memory_order_acquire);
+}
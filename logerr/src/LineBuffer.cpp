@@ -0,0 +1,121 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LINE BUFFER
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+
+//----------------------------
+//  INCLUDES
+//----------------------------
+
+#include <LineBuffer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+//----------------------------------------------------------------------------------------------------------------------
+//  LineBuffer
+//----------------------------------------------------------------------------------------------------------------------
+LineBuffer::LineBuffer(std::size_t capacity)
+    : m_capacity(std::max<std::size_t>(capacity, 16))
+    , m_buffer(m_capacity, '\0')
+{
+	setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  discard
+//----------------------------------------------------------------------------------------------------------------------
+void LineBuffer::discard(std::size_t length) noexcept
+{
+	const std::size_t used = pending().size();
+	length                 = std::min(length, used);
+	std::memmove(m_buffer.data(), m_buffer.data() + length, used - length);
+	setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+	pbump(static_cast<int>(used - length));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  take
+//----------------------------------------------------------------------------------------------------------------------
+std::string LineBuffer::take(std::size_t length)
+{
+	const std::size_t used = pending().size();
+	length                 = std::min(length, used);
+	if (length < used)
+	{
+		std::string taken(pending().substr(0, length));
+		discard(length);
+		return taken;
+	}
+
+	std::string taken = std::exchange(m_buffer, std::string(m_capacity, '\0'));
+	taken.resize(length);
+	setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+	return taken;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  overflow (protected)
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief		The put area is full: grow it and store @p v.
+//----------------------------------------------------------------------------------------------------------------------
+LineBuffer::int_type LineBuffer::overflow(int_type v)
+{
+	if (traits_type::eq_int_type(v, traits_type::eof()))
+		return traits_type::not_eof(v);
+
+	reserve(pending().size() + 1);
+	*pptr() = traits_type::to_char_type(v);
+	pbump(1);
+	return v;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  xsputn (protected)
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief		Store a whole chunk with one copy, growing the put area once if it does not fit.
+//----------------------------------------------------------------------------------------------------------------------
+std::streamsize LineBuffer::xsputn(const char* p, std::streamsize n)
+{
+	if (n <= 0)
+		return 0;
+
+	const auto size = static_cast<std::size_t>(n);
+	if (static_cast<std::size_t>(epptr() - pptr()) < size)
+		reserve(pending().size() + size);
+	std::memcpy(pptr(), p, size);
+	pbump(static_cast<int>(n));
+	return n;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  reserve (private)
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief		Grow the put area, keeping what is pending, so it can hold at least @p size bytes.
+//----------------------------------------------------------------------------------------------------------------------
+void LineBuffer::reserve(std::size_t size)
+{
+	const std::size_t used = pending().size();
+	m_buffer.resize(std::max(size, m_buffer.size() * 2));
+	setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+	pbump(static_cast<int>(used));
+}
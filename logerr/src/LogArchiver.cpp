@@ -0,0 +1,406 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LOG ARCHIVER
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+
+//----------------------------
+//  INCLUDES
+//----------------------------
+
+// logerr
+#include <LogArchiver.h>
+#include <LogIndex.h>
+#include <timestampLite.h>
+
+// std
+#include <algorithm>
+#include <cerrno>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+// compressors
+#if defined(LOGERR_HAS_ZLIB)
+#include <zlib.h>
+#endif
+#if defined(LOGERR_HAS_ZSTD)
+#include <zstd.h>
+#endif
+
+// platform
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	constexpr std::size_t chunkBytes = 256 * 1024;
+
+	/// Let the writer, and the application, win every contest for the CPU (and, through the nice value, the disk).
+	void lowerThisThreadsPriority() noexcept
+	{
+#if defined(_WIN32)
+		::SetThreadPriority(::GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+#elif defined(__linux__)
+		// on Linux the nice value is per thread
+		::setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)), 10);
+#endif
+	}
+
+#if defined(LOGERR_HAS_ZLIB)
+	bool gzipFile(std::ifstream& input, const std::filesystem::path& target)
+	{
+		gzFile output = ::gzopen(target.string().c_str(), "wb");
+		if (!output)
+			return false;
+
+		std::vector<char> chunk(chunkBytes);
+		bool              ok = true;
+		while (ok && input.read(chunk.data(), static_cast<std::streamsize>(chunk.size())).gcount() > 0)
+		{
+			const auto length = static_cast<int>(input.gcount());
+			ok = ::gzwrite(output, chunk.data(), static_cast<unsigned>(length)) == length;
+		}
+		return ::gzclose(output) == Z_OK && ok && !input.bad();
+	}
+#endif
+
+#if defined(LOGERR_HAS_ZSTD)
+	bool zstdFile(std::ifstream& input, const std::filesystem::path& target)
+	{
+		std::ofstream output(target, std::ios::binary);
+		ZSTD_CCtx*    context = ::ZSTD_createCCtx();
+		if (!output || !context)
+		{
+			::ZSTD_freeCCtx(context);
+			return false;
+		}
+
+		std::vector<char> in(::ZSTD_CStreamInSize());
+		std::vector<char> out(::ZSTD_CStreamOutSize());
+		bool              ok = true;
+		for (bool last = false; ok && !last;)
+		{
+			input.read(in.data(), static_cast<std::streamsize>(in.size()));
+			last = input.eof() || input.bad();
+
+			ZSTD_inBuffer source{in.data(), static_cast<std::size_t>(input.gcount()), 0};
+			for (bool done = false; ok && !done;)
+			{
+				ZSTD_outBuffer     destination{out.data(), out.size(), 0};
+				const std::size_t  remaining = ::ZSTD_compressStream2(context, &destination, &source, last ? ZSTD_e_end : ZSTD_e_continue);
+				ok   = !::ZSTD_isError(remaining) && output.write(out.data(), static_cast<std::streamsize>(destination.pos));
+				done = last ? remaining == 0 : source.pos == source.size;
+			}
+		}
+		::ZSTD_freeCCtx(context);
+		return ok && !input.bad() && output.flush();
+	}
+#endif
+
+	/// A closed segment of the series, as retention sees it.
+	struct Segment
+	{
+		std::filesystem::path           path;
+		std::filesystem::file_time_type modified;
+		std::uint64_t                   bytes;
+
+		/// Oldest first. Ties (a coarse file clock) go to the shorter, then lower, name: "x.9.log" before "x.10.log".
+		bool operator<(const Segment& other) const
+		{
+			if (modified != other.modified)
+				return modified < other.modified;
+			const auto& name      = path.native();
+			const auto& otherName = other.path.native();
+			return name.size() != otherName.size() ? name.size() < otherName.size() : name < otherName;
+		}
+	};
+
+	/// Whether a writer holds a LogArchiver::SegmentLock on @p segment.
+	bool heldByAWriter(const std::filesystem::path& segment) noexcept
+	{
+#if !defined(_WIN32)
+		const int fd = ::open(segment.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+			return false;
+		const bool held = ::flock(fd, LOCK_EX | LOCK_NB) != 0 && errno == EWOULDBLOCK;
+		::close(fd);    // and with it the lock, if it was taken
+		return held;
+#else
+		static_cast<void>(segment);
+		return false;
+#endif
+	}
+
+	/// Remove @p segment unless a writer holds its SegmentLock. The segment stays locked while it is removed, so a
+	/// writer cannot take it up in between.
+	bool removeUnlessHeld(const std::filesystem::path& segment, std::error_code& error)
+	{
+#if !defined(_WIN32)
+		const int fd = ::open(segment.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd >= 0 && ::flock(fd, LOCK_EX | LOCK_NB) != 0)
+		{
+			::close(fd);
+			return false;
+		}
+		const bool removed = std::filesystem::remove(segment, error);
+		if (fd >= 0)
+			::close(fd);
+		return removed;
+#else
+		return std::filesystem::remove(segment, error);    // fails for a file another writer has open
+#endif
+	}
+}    // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+//  LogArchiver
+//----------------------------------------------------------------------------------------------------------------------
+LogArchiver::LogArchiver(std::filesystem::path directory, std::string prefix, std::string extension,
+                         Compression compression, RetentionLimits retention, std::filesystem::path liveSegment)
+    : m_directory(std::move(directory))
+    , m_prefix(std::move(prefix))
+    , m_extension(std::move(extension))
+    , m_compression(available(compression))
+    , m_retention(retention)
+{
+	m_thread = std::jthread([this, liveSegment = std::move(liveSegment)](std::stop_token stop)
+	                        {
+		                        lowerThisThreadsPriority();
+		                        try
+		                        {
+			                        enforceRetention(liveSegment);
+		                        }
+		                        catch (const std::exception& e)
+		                        {
+			                        std::cerr << '[' << TimestampLite() << "] [ERROR]    Failed to apply the log retention limits in "
+			                                  << m_directory.string() << ". Details: " << e.what() << '\n';
+		                        }
+
+		                        // queued segments win over stop, so everything handed over before shutdown is archived
+		                        Job job;
+		                        while (m_jobs.wait_pop(job, stop))
+		                        {
+			                        try
+			                        {
+				                        compress(job.closedSegment, m_compression);
+				                        enforceRetention(job.liveSegment);
+			                        }
+			                        catch (const std::exception& e)
+			                        {
+				                        std::cerr << '[' << TimestampLite() << "] [ERROR]    Failed to archive the log segment "
+				                                  << job.closedSegment.string() << ". Details: " << e.what() << '\n';
+			                        }
+		                        }
+	                        });
+}
+
+LogArchiver::~LogArchiver() = default;
+
+//----------------------------------------------------------------------------------------------------------------------
+//  archive
+//----------------------------------------------------------------------------------------------------------------------
+void LogArchiver::archive(std::filesystem::path closedSegment, std::filesystem::path liveSegment)
+{
+	m_jobs.push({std::move(closedSegment), std::move(liveSegment)});
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  available
+//----------------------------------------------------------------------------------------------------------------------
+Compression LogArchiver::available(Compression requested) noexcept
+{
+#if !defined(LOGERR_HAS_ZSTD)
+	if (requested == Compression::Zstd)
+		requested = Compression::Gzip;
+#endif
+#if !defined(LOGERR_HAS_ZLIB)
+	if (requested == Compression::Gzip)
+		requested = Compression::None;
+#endif
+	return requested;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  extension
+//----------------------------------------------------------------------------------------------------------------------
+std::string_view LogArchiver::extension(Compression compression) noexcept
+{
+	switch (compression)
+	{
+		case Compression::Gzip: return ".gz";
+		case Compression::Zstd: return ".zst";
+		case Compression::None: break;
+	}
+	return "";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  compress
+//----------------------------------------------------------------------------------------------------------------------
+std::filesystem::path LogArchiver::compress(const std::filesystem::path& segment, Compression compression)
+{
+	compression = available(compression);
+	if (compression == Compression::None)
+		return segment;
+
+	std::ifstream input(segment, std::ios::binary);
+	if (!input)
+		return segment;
+
+	// write beside the segment and rename into place, so a crash never leaves a truncated archive under the real name
+	auto target = segment;
+	target += extension(compression);
+	auto partial = target;
+	partial += ".part";
+
+	bool ok = false;
+#if defined(LOGERR_HAS_ZSTD)
+	if (compression == Compression::Zstd)
+		ok = zstdFile(input, partial);
+#endif
+#if defined(LOGERR_HAS_ZLIB)
+	if (compression == Compression::Gzip)
+		ok = gzipFile(input, partial);
+#endif
+	input.close();
+
+	std::error_code error;
+	if (ok)
+		std::filesystem::rename(partial, target, error);
+	if (!ok || error)
+	{
+		std::filesystem::remove(partial, error);
+		return segment;
+	}
+	std::filesystem::remove(segment, error);
+	std::filesystem::remove(LogIndexWriter::sidecarPath(segment), error);    // it indexes the uncompressed bytes
+	return target;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  SegmentLock
+//----------------------------------------------------------------------------------------------------------------------
+LogArchiver::SegmentLock::SegmentLock(const std::filesystem::path& segment)
+{
+#if !defined(_WIN32)
+	// shared: any number of writers may hold it, and an archiver's exclusive probe fails while one does
+	m_fd = ::open(segment.c_str(), O_RDONLY | O_CLOEXEC);
+	if (m_fd >= 0 && ::flock(m_fd, LOCK_SH) != 0)
+	{
+		::close(m_fd);
+		m_fd = -1;
+	}
+#else
+	static_cast<void>(segment);
+#endif
+}
+
+LogArchiver::SegmentLock::SegmentLock(SegmentLock&& other) noexcept
+    : m_fd(std::exchange(other.m_fd, -1))
+{
+}
+
+LogArchiver::SegmentLock& LogArchiver::SegmentLock::operator=(SegmentLock&& other) noexcept
+{
+	if (this != &other)
+	{
+		const SegmentLock released(std::move(*this));
+		m_fd = std::exchange(other.m_fd, -1);
+	}
+	return *this;
+}
+
+LogArchiver::SegmentLock::~SegmentLock()
+{
+#if !defined(_WIN32)
+	if (m_fd >= 0)
+		::close(m_fd);
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  enforceRetention
+//----------------------------------------------------------------------------------------------------------------------
+void LogArchiver::enforceRetention(const std::filesystem::path& liveSegment) const
+{
+	if (m_retention.maxBytes == 0 && m_retention.maxFiles == 0)
+		return;
+
+	const auto isSeriesName = [this](std::string_view name)
+	{
+		if (!name.starts_with(m_prefix))
+			return false;
+		for (const Compression compression : {Compression::Gzip, Compression::Zstd})
+		{
+			if (name.ends_with(extension(compression)))
+			{
+				name.remove_suffix(extension(compression).size());
+				break;
+			}
+		}
+		return name.ends_with(m_extension);
+	};
+
+	std::error_code      error;
+	std::vector<Segment> segments;
+	std::uint64_t        totalBytes = 0;
+	for (const auto& entry : std::filesystem::directory_iterator(m_directory, error))
+	{
+		// the live segment is named as the writer opened it, so compare names: the series has one directory
+		if (!entry.is_regular_file(error) || entry.path().filename() == liveSegment.filename() ||
+		    !isSeriesName(entry.path().filename().string()) || heldByAWriter(entry.path()))
+			continue;
+		Segment segment{entry.path(), entry.last_write_time(error), entry.file_size(error)};
+		if (error)
+			continue;
+		totalBytes += segment.bytes;
+		segments.push_back(std::move(segment));
+	}
+
+	std::sort(segments.begin(), segments.end());
+
+	std::size_t files = segments.size();
+	for (const Segment& oldest : segments)
+	{
+		const bool overBytes = m_retention.maxBytes != 0 && totalBytes > m_retention.maxBytes;
+		const bool overFiles = m_retention.maxFiles != 0 && files > m_retention.maxFiles;
+		if (!overBytes && !overFiles)
+			break;
+		if (removeUnlessHeld(oldest.path, error))
+		{
+			std::filesystem::remove(LogIndexWriter::sidecarPath(oldest.path), error);
+			totalBytes -= oldest.bytes;
+			--files;
+		}
+	}
+}
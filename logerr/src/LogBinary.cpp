@@ -0,0 +1,676 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LOG BINARY
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+
+//----------------------------
+//  INCLUDES
+//----------------------------
+
+// logerr
+#include <LogBinary.h>
+#include <deferredFormat.h>
+#include <timestampLite.h>
+
+// std
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <span>
+#include <utility>
+#include <variant>
+
+namespace
+{
+	enum Entry : std::uint8_t
+	{
+		SessionEntry  = 0x01,
+		StringEntry   = 0x02,
+		SiteEntry     = 0x03,
+		TextEntry     = 0x04,
+		DeferredEntry = 0x05,
+		RawEntry      = 0x06,
+	};
+
+	constexpr std::uint64_t formatVersion = 1;
+
+	/// One deferred argument, widened to the few types the runtime formatter distinguishes.
+	using Value = std::variant<bool, char, std::int64_t, std::uint64_t, float, double, long double, std::string_view>;
+
+	void putVarint(std::string& out, std::uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			out += static_cast<char>((value & 0x7F) | 0x80);
+			value >>= 7;
+		}
+		out += static_cast<char>(value);
+	}
+
+	void putSigned(std::string& out, std::int64_t value)
+	{
+		putVarint(out, (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+	}
+
+	/// Reads the fields of one entry. Running off the end sets `truncated` and reads zeros from then on.
+	struct Reader
+	{
+		const char* in;
+		const char* end;
+		bool        truncated = false;
+		bool        damaged   = false;
+
+		std::uint8_t byte() noexcept
+		{
+			if (in == end)
+			{
+				truncated = true;
+				return 0;
+			}
+			return static_cast<std::uint8_t>(*in++);
+		}
+
+		std::uint64_t varint() noexcept
+		{
+			std::uint64_t value = 0;
+			for (unsigned shift = 0; shift < 64; shift += 7)
+			{
+				const std::uint8_t next = byte();
+				value |= static_cast<std::uint64_t>(next & 0x7F) << shift;
+				if ((next & 0x80) == 0)
+					return value;
+			}
+			damaged = true;
+			return 0;
+		}
+
+		std::int64_t zigzag() noexcept
+		{
+			const std::uint64_t value = varint();
+			return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+		}
+
+		std::string_view bytes(std::uint64_t length) noexcept
+		{
+			if (truncated || length > static_cast<std::uint64_t>(end - in))
+			{
+				truncated = true;
+				return {};
+			}
+			const std::string_view text(in, length);
+			in += length;
+			return text;
+		}
+	};
+
+	template<typename T>
+	T load(const std::byte*& in) noexcept
+	{
+		T value;
+		std::memcpy(&value, in, sizeof(T));
+		in += sizeof(T);
+		return value;
+	}
+
+	/// Decode arguments as the ring holds them (see deferredFormat.h) against their signature.
+	bool readStored(std::string_view signature, std::span<const std::byte> arguments, std::vector<Value>& values)
+	{
+		values.clear();
+		const std::byte* in  = arguments.data();
+		const std::byte* end = in + arguments.size();
+		for (std::size_t i = 0; i + 1 < signature.size(); i += 2)
+		{
+			const char        kind = signature[i];
+			const std::size_t size = static_cast<std::size_t>(signature[i + 1] - '0');
+			if (size > static_cast<std::size_t>(end - in))
+				return false;
+
+			if (kind == 's')
+			{
+				const auto length = load<std::uint32_t>(in);
+				if (length > static_cast<std::size_t>(end - in))
+					return false;
+				values.emplace_back(std::string_view(reinterpret_cast<const char*>(in), length));
+				in += length;
+			}
+			else if (kind == 'b' && size == 1)
+				values.emplace_back(load<bool>(in));
+			else if (kind == 'c' && size == 1)
+				values.emplace_back(load<char>(in));
+			else if (kind == 'i' && size == 1)
+				values.emplace_back(std::int64_t{load<std::int8_t>(in)});
+			else if (kind == 'i' && size == 2)
+				values.emplace_back(std::int64_t{load<std::int16_t>(in)});
+			else if (kind == 'i' && size == 4)
+				values.emplace_back(std::int64_t{load<std::int32_t>(in)});
+			else if (kind == 'i' && size == 8)
+				values.emplace_back(std::int64_t{load<std::int64_t>(in)});
+			else if (kind == 'u' && size == 1)
+				values.emplace_back(std::uint64_t{load<std::uint8_t>(in)});
+			else if (kind == 'u' && size == 2)
+				values.emplace_back(std::uint64_t{load<std::uint16_t>(in)});
+			else if (kind == 'u' && size == 4)
+				values.emplace_back(std::uint64_t{load<std::uint32_t>(in)});
+			else if (kind == 'u' && size == 8)
+				values.emplace_back(std::uint64_t{load<std::uint64_t>(in)});
+			else if (kind == 'f' && size == sizeof(float))
+				values.emplace_back(load<float>(in));
+			else if (kind == 'f' && size == sizeof(double))
+				values.emplace_back(load<double>(in));
+			else if (kind == 'f' && size == sizeof(long double))
+				values.emplace_back(load<long double>(in));
+			else
+				return false;
+		}
+		return in == end && signature.size() % 2 == 0;
+	}
+
+	/// Write arguments the way a deferred entry stores them.
+	void writeCompact(const std::vector<Value>& values, std::string& out)
+	{
+		for (const Value& value : values)
+		{
+			std::visit(
+			    [&out](const auto& argument)
+			    {
+				    using T = std::decay_t<decltype(argument)>;
+				    if constexpr (std::is_same_v<T, bool> || std::is_same_v<T, char>)
+					    out += static_cast<char>(argument);
+				    else if constexpr (std::is_same_v<T, std::int64_t>)
+					    putSigned(out, argument);
+				    else if constexpr (std::is_same_v<T, std::uint64_t>)
+					    putVarint(out, argument);
+				    else if constexpr (std::is_same_v<T, std::string_view>)
+				    {
+					    putVarint(out, argument.size());
+					    out += argument;
+				    }
+				    else
+					    out.append(reinterpret_cast<const char*>(&argument), sizeof(T));
+			    },
+			    value);
+		}
+	}
+
+	/// Read the arguments a deferred entry stores, against their signature.
+	bool readCompact(std::string_view signature, Reader& reader, std::vector<Value>& values)
+	{
+		values.clear();
+		for (std::size_t i = 0; i + 1 < signature.size(); i += 2)
+		{
+			const char        kind = signature[i];
+			const std::size_t size = static_cast<std::size_t>(signature[i + 1] - '0');
+			const auto        raw  = [&]<typename T>(T value)
+			{
+				const std::string_view bytes = reader.bytes(sizeof(T));
+				if (!bytes.empty())
+					std::memcpy(&value, bytes.data(), sizeof(T));
+				values.emplace_back(value);
+			};
+
+			switch (kind)
+			{
+				case 'b': values.emplace_back(reader.byte() != 0); break;
+				case 'c': values.emplace_back(static_cast<char>(reader.byte())); break;
+				case 'i': values.emplace_back(reader.zigzag()); break;
+				case 'u': values.emplace_back(reader.varint()); break;
+				case 's': values.emplace_back(reader.bytes(reader.varint())); break;
+				case 'f':
+					if (size == sizeof(float))
+						raw(0.0f);
+					else if (size == sizeof(double))
+						raw(0.0);
+					else if (size == sizeof(long double))
+						raw(0.0L);
+					else
+						return false;
+					break;
+				default: return false;
+			}
+		}
+		return !reader.truncated && !reader.damaged && reader.in == reader.end;
+	}
+
+	/// Append one replacement field, `{}` or `{:spec}`, formatted with @p value.
+	void appendField([[maybe_unused]] std::string& out, [[maybe_unused]] std::string_view field, const Value& value)
+	{
+#if defined(__cpp_lib_format)
+		const std::size_t colon = field.find(':');
+		std::string       replacement("{");
+		if (colon != std::string_view::npos)
+			replacement += field.substr(colon);
+		replacement += '}';
+		std::visit([&](const auto& argument) { logerr::detail::formatTo(out, replacement, argument); }, value);
+#else
+		std::visit([&](const auto& argument) { logerr::detail::formatTo(out, "{}", argument); }, value);
+#endif
+	}
+
+	/// @brief		logerr::detail::formatTo with the arguments known only at run time.
+	/// @details	Walks the format string the way formatTo's fallback does and formats each field on its own; the encoder
+	///				confirms per site that this renders what the call site did before it relies on it.
+	void formatValues(std::string& out, std::string_view format, const std::vector<Value>& values)
+	{
+		std::size_t next = 0;
+		for (std::size_t i = 0; i < format.size(); ++i)
+		{
+			const char c = format[i];
+			if ((c == '{' || c == '}') && i + 1 < format.size() && format[i + 1] == c)
+			{
+				out += c;
+				++i;
+				continue;
+			}
+			const std::size_t close = c == '{' ? format.find('}', i) : std::string_view::npos;
+			if (close == std::string_view::npos)
+			{
+				out += c;
+				continue;
+			}
+
+			const std::string_view field = format.substr(i + 1, close - i - 1);
+			const std::string_view id    = field.substr(0, field.find(':'));
+			std::size_t            n     = next++;
+			if (!id.empty())
+				std::from_chars(id.data(), id.data() + id.size(), n);
+			if (n < values.size())
+				appendField(out, field, values[n]);
+			else
+				out += format.substr(i, close - i + 1);
+			i = close;
+		}
+	}
+
+	std::chrono::system_clock::time_point timeOf(std::int64_t nanoseconds) noexcept
+	{
+		return std::chrono::system_clock::time_point(
+		    std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(nanoseconds)));
+	}
+
+	void appendTimestamp(std::string& out, std::int64_t nanoseconds)
+	{
+		char timestamp[TimestampLite::maxLength];
+		out += '[';
+		out.append(timestamp, TimestampLite(timeOf(nanoseconds)).write(timestamp));
+	}
+}    // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+//  restart
+//----------------------------------------------------------------------------------------------------------------------
+void LogBinaryEncoder::restart(bool emptyFile) noexcept
+{
+	m_strings.clear();
+	m_textSites.clear();
+	m_deferredSites.clear();
+	m_nextString   = 1;
+	m_nextSite     = 1;
+	m_previousTime = 0;
+	m_magicDue     = emptyFile;
+	m_sessionDue   = true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  encode
+//----------------------------------------------------------------------------------------------------------------------
+void LogBinaryEncoder::encode(const LogRecord& record, std::string& out)
+{
+	beginEntry(out);
+	if (!record.deferred().empty() && encodeDeferred(record, out))
+		return;
+	if (encodeText(record, out))
+		return;
+	encodeRaw(record.view(), out);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  beginEntry (private)
+//----------------------------------------------------------------------------------------------------------------------
+void LogBinaryEncoder::beginEntry(std::string& out)
+{
+	if (std::exchange(m_magicDue, false))
+		out += magic;
+	if (std::exchange(m_sessionDue, false))
+	{
+		out += static_cast<char>(SessionEntry);
+		putVarint(out, formatVersion);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  encodeDeferred (private)
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief		Store a deferred record's arguments instead of its text.
+/// @return		false if the record is left to encodeText: it is damaged, or its site does not format back exactly.
+//----------------------------------------------------------------------------------------------------------------------
+bool LogBinaryEncoder::encodeDeferred(const LogRecord& record, std::string& out)
+{
+	const std::string_view  payload = record.deferred();
+	logerr::DeferredHeader header{};
+	if (payload.size() < sizeof(header))
+		return false;
+	std::memcpy(&header, payload.data(), sizeof(header));
+	if (header.site == nullptr || header.site->format == nullptr || *header.site->format == '\0' || header.signature == nullptr)
+		return false;
+
+	const logerr::Site&            site = *header.site;
+	const std::span<const std::byte> arguments(reinterpret_cast<const std::byte*>(payload.data()) + sizeof(header),
+	                                           payload.size() - sizeof(header));
+	thread_local std::vector<Value> values;
+	if (!readStored(header.signature, arguments, values))
+		return false;
+
+	DeferredSite& state = m_deferredSites[&site];
+	if (!std::exchange(state.checked, true))
+	{
+		// rendered the way the decoder will, from the prefix it will store, and compared with what the backend wrote
+		std::string prefix;
+		logerr::appendPrefix(prefix, site, timeOf(header.timestamp));
+		const std::string_view tail = std::string_view(prefix).substr(prefix.find(']'));
+
+		std::string line;
+		appendTimestamp(line, header.timestamp);
+		line += tail;
+		formatValues(line, site.format, values);
+		line += '\n';
+		if (line != record.view())
+			return false;
+
+		const std::uint32_t prefixId    = stringId(tail, out);
+		const std::uint32_t formatId    = stringId(site.format, out);
+		const std::uint32_t signatureId = stringId(header.signature, out);
+		const std::uint32_t fileId      = stringId(site.file != nullptr ? site.file : "", out);
+		const std::uint32_t functionId  = stringId(site.function != nullptr ? site.function : "", out);
+
+		state.id = m_nextSite++;
+		out += static_cast<char>(SiteEntry);
+		putVarint(out, state.id);
+		putVarint(out, static_cast<std::uint64_t>(site.level));
+		putVarint(out, prefixId);
+		putVarint(out, formatId);
+		putVarint(out, signatureId);
+		putVarint(out, fileId);
+		putVarint(out, site.line);
+		putVarint(out, functionId);
+	}
+	if (state.id == 0)
+		return false;
+
+	m_scratch.clear();
+	writeCompact(values, m_scratch);
+
+	out += static_cast<char>(DeferredEntry);
+	putVarint(out, state.id);
+	putVarint(out, record.thread());
+	putSigned(out, header.timestamp - std::exchange(m_previousTime, header.timestamp));
+	putVarint(out, m_scratch.size());
+	out += m_scratch;
+	return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  encodeText (private)
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief		Store a line as its timestamp, its prefix's site and its message.
+/// @return		false if the line does not start with a timestamp and a level label that render back exactly.
+//----------------------------------------------------------------------------------------------------------------------
+bool LogBinaryEncoder::encodeText(const LogRecord& record, std::string& out)
+{
+	const std::string_view line = record.view();
+	if (line.empty() || line.front() != '[')
+		return false;
+	const auto time = TimestampLite::parse(line.substr(1));
+	if (!time)
+		return false;
+
+	char              timestamp[TimestampLite::maxLength];
+	const std::size_t length = TimestampLite(*time).write(timestamp);
+	if (length == 0 || line.substr(1, length) != std::string_view(timestamp, length))
+		return false;
+
+	// the prefix runs through the level label and, on a warning, the location column after it
+	const std::string_view rest      = line.substr(1 + length);
+	const std::string_view firstLine = rest.substr(0, rest.find('\n'));
+	std::size_t            prefixEnd = std::string_view::npos;
+	logerr::Level          level     = logerr::Level::Info;
+	for (const logerr::Level candidate : {logerr::Level::Debug, logerr::Level::Info, logerr::Level::Warning, logerr::Level::Error})
+	{
+		const std::string_view label = logerr::levelLabel(candidate);
+		if (const std::size_t at = firstLine.find(label); at != std::string_view::npos && (prefixEnd == std::string_view::npos || at + label.size() < prefixEnd))
+		{
+			prefixEnd = at + label.size();
+			level     = candidate;
+		}
+	}
+	if (!rest.starts_with(']') || prefixEnd == std::string_view::npos)
+		return false;
+	if (level == logerr::Level::Warning && firstLine.substr(prefixEnd).starts_with('['))
+	{
+		if (const std::size_t location = firstLine.find("]  ", prefixEnd); location != std::string_view::npos)
+			prefixEnd = location + 3;
+	}
+
+	const std::uint32_t    site    = textSite(rest.substr(0, prefixEnd), level, out);
+	const std::string_view message = rest.substr(prefixEnd);
+	const std::int64_t     nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(time->time_since_epoch()).count();
+
+	out += static_cast<char>(TextEntry);
+	putVarint(out, site);
+	putVarint(out, record.thread());
+	putSigned(out, nanoseconds - std::exchange(m_previousTime, nanoseconds));
+	putVarint(out, message.size());
+	out += message;
+	return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  encodeRaw (private)
+//----------------------------------------------------------------------------------------------------------------------
+void LogBinaryEncoder::encodeRaw(std::string_view text, std::string& out)
+{
+	out += static_cast<char>(RawEntry);
+	putVarint(out, text.size());
+	out += text;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  stringId (private)
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief		The id of @p text in this session's string table, defining it in @p out on first use. 0 for "".
+//----------------------------------------------------------------------------------------------------------------------
+std::uint32_t LogBinaryEncoder::stringId(std::string_view text, std::string& out)
+{
+	if (text.empty())
+		return 0;
+	if (const auto found = m_strings.find(text); found != m_strings.end())
+		return found->second;
+
+	const std::uint32_t id = m_nextString++;
+	m_strings.emplace(text, id);
+	out += static_cast<char>(StringEntry);
+	putVarint(out, id);
+	putVarint(out, text.size());
+	out += text;
+	return id;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  textSite (private)
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief		The site id of a text line's prefix, defining it in @p out on first use.
+//----------------------------------------------------------------------------------------------------------------------
+std::uint32_t LogBinaryEncoder::textSite(std::string_view prefix, logerr::Level level, std::string& out)
+{
+	if (const auto found = m_textSites.find(prefix); found != m_textSites.end())
+		return found->second;
+
+	const std::uint32_t prefixId = stringId(prefix, out);
+	const std::uint32_t id       = m_nextSite++;
+	m_textSites.emplace(prefix, id);
+	out += static_cast<char>(SiteEntry);
+	putVarint(out, id);
+	putVarint(out, static_cast<std::uint64_t>(level));
+	putVarint(out, prefixId);
+	out.append(5, '\0');    // no format, signature, file, line or function
+	return id;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  decode
+//----------------------------------------------------------------------------------------------------------------------
+std::size_t LogBinaryDecoder::decode(std::string_view data, std::string& out)
+{
+	if (!m_ok)
+		return 0;
+
+	const char* in  = data.data();
+	const char* end = in + data.size();
+	if (!m_started)
+	{
+		if (!LogBinaryEncoder::magic.starts_with(data.substr(0, LogBinaryEncoder::magic.size())))
+		{
+			m_ok = false;
+			return 0;
+		}
+		if (data.size() < LogBinaryEncoder::magic.size())
+			return 0;
+		in += LogBinaryEncoder::magic.size();
+		m_started = true;
+	}
+
+	while (in < end)
+	{
+		const char* entry  = in;
+		const int   result = decodeEntry(in, end, out);
+		if (result <= 0)
+		{
+			m_ok = result == 0;
+			in   = entry;
+			break;
+		}
+	}
+	return static_cast<std::size_t>(in - data.data());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  decodeEntry (private)
+//----------------------------------------------------------------------------------------------------------------------
+int LogBinaryDecoder::decodeEntry(const char*& in, const char* end, std::string& out)
+{
+	Reader reader{in, end};
+	const auto finish = [&]
+	{
+		if (reader.damaged)
+			return -1;
+		if (reader.truncated)
+			return 0;
+		in = reader.in;
+		return 1;
+	};
+	const auto isString = [this](std::uint64_t id) { return id < m_strings.size(); };
+	const auto isSite   = [this](std::uint64_t id) { return id != 0 && id < m_sites.size(); };
+
+	switch (reader.byte())
+	{
+		case SessionEntry:
+		{
+			const std::uint64_t version = reader.varint();
+			if (reader.truncated)
+				return 0;
+			if (version != formatVersion)
+				return -1;
+			m_strings.resize(1);
+			m_sites.resize(1);
+			m_previousTime = 0;
+			return finish();
+		}
+		case StringEntry:
+		{
+			const std::uint64_t    id   = reader.varint();
+			const std::string_view text = reader.bytes(reader.varint());
+			if (reader.truncated || reader.damaged)
+				return finish();
+			if (id != m_strings.size())
+				return -1;
+			m_strings.emplace_back(text);
+			return finish();
+		}
+		case SiteEntry:
+		{
+			const std::uint64_t id = reader.varint();
+			reader.varint();    // level
+			const std::uint64_t prefix    = reader.varint();
+			const std::uint64_t format    = reader.varint();
+			const std::uint64_t signature = reader.varint();
+			const std::uint64_t file      = reader.varint();
+			reader.varint();    // line
+			const std::uint64_t function = reader.varint();
+			if (reader.truncated || reader.damaged)
+				return finish();
+			if (id != m_sites.size() || !isString(prefix) || !isString(format) || !isString(signature) || !isString(file) || !isString(function))
+				return -1;
+			m_sites.push_back({m_strings[prefix], m_strings[format], m_strings[signature]});
+			return finish();
+		}
+		case TextEntry:
+		case DeferredEntry:
+		{
+			const bool             deferred = static_cast<std::uint8_t>(*in) == DeferredEntry;
+			const std::uint64_t    site     = reader.varint();
+			reader.varint();    // thread
+			const std::int64_t     delta    = reader.zigzag();
+			const std::string_view body     = reader.bytes(reader.varint());
+			if (reader.truncated || reader.damaged)
+				return finish();
+			if (!isSite(site))
+				return -1;
+
+			const Site& definition = m_sites[site];
+			if (!deferred)
+			{
+				appendTimestamp(out, m_previousTime += delta);
+				out += definition.prefix;
+				out += body;
+				return finish();
+			}
+
+			thread_local std::vector<Value> values;
+			Reader                          arguments{body.data(), body.data() + body.size()};
+			if (definition.format.empty() || !readCompact(definition.signature, arguments, values))
+				return -1;
+			appendTimestamp(out, m_previousTime += delta);
+			out += definition.prefix;
+			formatValues(out, definition.format, values);
+			out += '\n';
+			return finish();
+		}
+		case RawEntry:
+		{
+			const std::string_view text = reader.bytes(reader.varint());
+			if (!reader.truncated && !reader.damaged)
+				out += text;
+			return finish();
+		}
+		default:
+			return reader.truncated ? 0 : -1;
+	}
+}
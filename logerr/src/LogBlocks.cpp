@@ -0,0 +1,500 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LOG BLOCKS
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+
+//----------------------------
+//  INCLUDES
+//----------------------------
+
+// logerr
+#include <LogBlocks.h>
+#include <timestampLite.h>
+
+// std
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+
+// compressors
+#if defined(LOGERR_HAS_ZLIB)
+#include <zlib.h>
+#endif
+#if defined(LOGERR_HAS_ZSTD)
+#include <zstd.h>
+#endif
+
+namespace
+{
+	using time_point = std::chrono::system_clock::time_point;
+
+	constexpr std::string_view fileMagic  = "LOGERRZ1";
+	constexpr std::string_view blockMagic = "BLK1";
+	constexpr std::string_view indexMagic = "LIDX";
+
+	constexpr std::size_t blockHeaderBytes = 40;
+	constexpr std::size_t indexEntryBytes  = 32;
+	constexpr std::size_t trailerBytes     = 16;
+
+	/// How a block's records are stored. Written to disk: never renumber.
+	enum Codec : std::uint8_t
+	{
+		stored  = 0,
+		deflate = 1,    ///< zlib stream (Compression::Gzip).
+		zstd    = 2,
+	};
+
+	//------------------------------------------------------------------------------------------------------------------
+	//  encoding
+	//------------------------------------------------------------------------------------------------------------------
+
+	void store(char* out, std::uint64_t value, std::size_t bytes) noexcept
+	{
+		for (std::size_t i = 0; i < bytes; ++i, value >>= 8)
+			out[i] = static_cast<char>(value & 0xff);
+	}
+
+	std::uint64_t load(const char* in, std::size_t bytes) noexcept
+	{
+		std::uint64_t value = 0;
+		for (std::size_t i = bytes; i-- > 0;)
+			value = value << 8 | static_cast<std::uint8_t>(in[i]);
+		return value;
+	}
+
+	std::uint64_t toNanoseconds(time_point time) noexcept
+	{
+		return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count());
+	}
+
+	time_point fromNanoseconds(std::uint64_t nanoseconds) noexcept
+	{
+		return time_point(std::chrono::duration_cast<time_point::duration>(std::chrono::nanoseconds(static_cast<std::int64_t>(nanoseconds))));
+	}
+
+	/// FNV-1a: catches a torn or overwritten block, which is all it is for.
+	std::uint32_t checksum(std::string_view bytes) noexcept
+	{
+		std::uint32_t hash = 2166136261u;
+		for (const char c : bytes)
+		{
+			hash ^= static_cast<std::uint8_t>(c);
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	struct BlockHeader
+	{
+		std::uint8_t       codec   = stored;
+		std::uint32_t      raw     = 0;    ///< bytes once decompressed.
+		std::uint32_t      size    = 0;    ///< bytes stored after the header.
+		std::uint32_t      sum     = 0;    ///< checksum of the stored bytes.
+		LogBlockIndexEntry entry;
+
+		void write(char* out) const noexcept
+		{
+			std::memcpy(out, blockMagic.data(), blockMagic.size());
+			store(out + 4, codec, 1);
+			store(out + 5, 0, 3);
+			store(out + 8, raw, 4);
+			store(out + 12, size, 4);
+			store(out + 16, entry.records, 4);
+			store(out + 20, sum, 4);
+			store(out + 24, toNanoseconds(entry.first), 8);
+			store(out + 32, toNanoseconds(entry.last), 8);
+		}
+
+		bool read(const char* in, std::uint64_t offset) noexcept
+		{
+			if (std::string_view(in, blockMagic.size()) != blockMagic)
+				return false;
+			codec         = static_cast<std::uint8_t>(load(in + 4, 1));
+			raw           = static_cast<std::uint32_t>(load(in + 8, 4));
+			size          = static_cast<std::uint32_t>(load(in + 12, 4));
+			entry.records = static_cast<std::uint32_t>(load(in + 16, 4));
+			sum           = static_cast<std::uint32_t>(load(in + 20, 4));
+			entry.first   = fromNanoseconds(load(in + 24, 8));
+			entry.last    = fromNanoseconds(load(in + 32, 8));
+			entry.offset  = offset;
+			return true;
+		}
+	};
+
+	/// @brief		Compress @p records into a whole block, header included.
+	std::string encodeBlock(std::string_view records, [[maybe_unused]] Compression compression, const LogBlockIndexEntry& entry)
+	{
+		BlockHeader header{.raw = static_cast<std::uint32_t>(records.size()), .entry = entry};
+		std::string block(blockHeaderBytes, '\0');
+
+#if defined(LOGERR_HAS_ZSTD)
+		if (compression == Compression::Zstd)
+		{
+			block.resize(blockHeaderBytes + ::ZSTD_compressBound(records.size()));
+			const std::size_t size = ::ZSTD_compress(block.data() + blockHeaderBytes, block.size() - blockHeaderBytes,
+			                                         records.data(), records.size(), 3);
+			if (!::ZSTD_isError(size))
+			{
+				block.resize(blockHeaderBytes + size);
+				header.codec = zstd;
+			}
+		}
+#endif
+#if defined(LOGERR_HAS_ZLIB)
+		if (compression == Compression::Gzip)
+		{
+			auto size = ::compressBound(static_cast<uLong>(records.size()));
+			block.resize(blockHeaderBytes + size);
+			if (::compress2(reinterpret_cast<Bytef*>(block.data() + blockHeaderBytes), &size,
+			                reinterpret_cast<const Bytef*>(records.data()), static_cast<uLong>(records.size()),
+			                Z_DEFAULT_COMPRESSION) == Z_OK)
+			{
+				block.resize(blockHeaderBytes + size);
+				header.codec = deflate;
+			}
+		}
+#endif
+		if (header.codec == stored)
+		{
+			block.resize(blockHeaderBytes);
+			block.append(records);
+		}
+
+		header.size = static_cast<std::uint32_t>(block.size() - blockHeaderBytes);
+		header.sum  = checksum(std::string_view(block).substr(blockHeaderBytes));
+		header.write(block.data());
+		return block;
+	}
+
+	/// @brief		Decompress a block's stored bytes.
+	/// @throws		std::runtime_error if they do not decompress to the size the header promises.
+	std::string decodeBlock(const BlockHeader& header, std::string_view payload)
+	{
+		if (header.codec == stored)
+			return std::string(payload);
+
+		std::string records(header.raw, '\0');
+		bool        ok = false;
+#if defined(LOGERR_HAS_ZLIB)
+		if (header.codec == deflate)
+		{
+			uLongf size = header.raw;
+			ok = ::uncompress(reinterpret_cast<Bytef*>(records.data()), &size, reinterpret_cast<const Bytef*>(payload.data()),
+			                  static_cast<uLong>(payload.size())) == Z_OK &&
+			     size == header.raw;
+		}
+#endif
+#if defined(LOGERR_HAS_ZSTD)
+		if (header.codec == zstd)
+			ok = ::ZSTD_decompress(records.data(), records.size(), payload.data(), payload.size()) == header.raw;
+#endif
+		if (!ok)
+			throw std::runtime_error("log block at offset " + std::to_string(header.entry.offset) +
+			                         " could not be decompressed (damaged, or a codec this build lacks)");
+		return records;
+	}
+
+	//------------------------------------------------------------------------------------------------------------------
+	//  timestamps
+	//------------------------------------------------------------------------------------------------------------------
+
+	/// The time a log line is stamped with: its leading "[YYYY-mm-dd HH:MM:SS.nnnnnnnnn TZ", in local time.
+	std::optional<time_point> lineTime(std::string_view line)
+	{
+		if (line.empty() || line.front() != '[')
+			return std::nullopt;
+		return TimestampLite::parse(line.substr(1));
+	}
+
+	/// Calls @p visit(line) for each line of @p text, newline included.
+	template<class Visit>
+	void forEachLine(std::string_view text, Visit&& visit)
+	{
+		while (!text.empty())
+		{
+			const std::size_t end = std::min(text.find('\n'), text.size() - 1) + 1;
+			visit(text.substr(0, end));
+			text.remove_prefix(end);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------------------------
+	//  index
+	//------------------------------------------------------------------------------------------------------------------
+
+	/// @brief		Read the index of the block log @p file, @p size bytes long, into @p index.
+	/// @details	Uses the footer when the file has a whole one; otherwise walks the block headers, stopping at the first
+	///				block that is torn or does not check out.
+	/// @return		where the blocks end (the footer, or the torn tail, starts there); 0 if this is not a block log.
+	std::uint64_t readIndex(std::ifstream& file, std::uint64_t size, std::vector<LogBlockIndexEntry>& index)
+	{
+		index.clear();
+		char magic[fileMagic.size()]{};
+		if (size < fileMagic.size() || !file.seekg(0).read(magic, sizeof(magic)) || std::string_view(magic, sizeof(magic)) != fileMagic)
+			return 0;
+
+		if (size >= fileMagic.size() + trailerBytes)
+		{
+			char trailer[trailerBytes]{};
+			file.seekg(static_cast<std::streamoff>(size - trailerBytes)).read(trailer, sizeof(trailer));
+			const std::uint64_t indexOffset = load(trailer, 8);
+			const std::uint64_t count       = load(trailer + 8, 4);
+			if (file && std::string_view(trailer + 12, indexMagic.size()) == indexMagic && indexOffset >= fileMagic.size() &&
+			    indexOffset + count * indexEntryBytes + trailerBytes == size)
+			{
+				std::string entries(count * indexEntryBytes, '\0');
+				if (file.seekg(static_cast<std::streamoff>(indexOffset)).read(entries.data(), static_cast<std::streamsize>(entries.size())))
+				{
+					for (std::size_t i = 0; i < count; ++i)
+					{
+						const char* entry = entries.data() + i * indexEntryBytes;
+						index.push_back({load(entry, 8), fromNanoseconds(load(entry + 8, 8)), fromNanoseconds(load(entry + 16, 8)),
+						                 static_cast<std::uint32_t>(load(entry + 24, 4))});
+					}
+					return indexOffset;
+				}
+			}
+			file.clear();
+		}
+
+		// no footer: its writer is still running, or crashed
+		std::uint64_t offset = fileMagic.size();
+		std::string   payload;
+		while (offset + blockHeaderBytes <= size)
+		{
+			char        raw[blockHeaderBytes]{};
+			BlockHeader header;
+			if (!file.seekg(static_cast<std::streamoff>(offset)).read(raw, sizeof(raw)) || !header.read(raw, offset) ||
+			    offset + blockHeaderBytes + header.size > size)
+				break;
+			payload.resize(header.size);
+			if (!file.read(payload.data(), static_cast<std::streamsize>(payload.size())) || checksum(payload) != header.sum)
+				break;
+			index.push_back(header.entry);
+			offset += blockHeaderBytes + header.size;
+		}
+		file.clear();
+		return offset;
+	}
+}    // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+//  LogBlockWriter
+//----------------------------------------------------------------------------------------------------------------------
+LogBlockWriter::LogBlockWriter(const std::string& path, Compression compression, std::size_t blockBytes, const OpenOutput& open)
+    : m_compression(LogArchiver::available(compression))
+    , m_blockBytes(std::max<std::size_t>(blockBytes, 4096))
+{
+	// Continue an existing block log: drop its footer, or the torn block a crash left, and append after its last block.
+	std::error_code error;
+	const auto      size = std::filesystem::exists(path, error) ? std::filesystem::file_size(path, error) : 0;
+	if (error)
+		return;
+	if (size >= fileMagic.size())
+	{
+		std::ifstream existing(path, std::ios::binary);
+		m_offset = readIndex(existing, size, m_index);
+		if (m_offset == 0)
+			return;    // something else lives here: leave it alone, and report the log as unopenable
+		existing.close();
+		if (m_offset < size)
+			std::filesystem::resize_file(path, m_offset, error);
+		if (error)
+			return;
+	}
+	else if (size != 0)
+	{
+		std::filesystem::resize_file(path, 0, error);    // a torn file magic
+		if (error)
+			return;
+	}
+
+	m_output = open(path);
+	if (m_offset == 0 && m_output && m_output->isOpen())
+	{
+		if (m_output->write(fileMagic))
+			m_offset = fileMagic.size();
+		else
+			m_output.reset();
+	}
+	m_pending.reserve(m_blockBytes);
+}
+
+LogBlockWriter::~LogBlockWriter()
+{
+	if (!isOpen())
+		return;
+
+	// seal the last block, then the footer. Without it (a crash, or a failed write) readers walk the block headers instead.
+	if (!seal(false) || m_failed)
+		return;
+	std::string footer(m_index.size() * indexEntryBytes + trailerBytes, '\0');
+	char*       out = footer.data();
+	for (const LogBlockIndexEntry& entry : m_index)
+	{
+		store(out, entry.offset, 8);
+		store(out + 8, toNanoseconds(entry.first), 8);
+		store(out + 16, toNanoseconds(entry.last), 8);
+		store(out + 24, entry.records, 4);
+		store(out + 28, 0, 4);
+		out += indexEntryBytes;
+	}
+	store(out, m_offset, 8);
+	store(out + 8, m_index.size(), 4);
+	std::memcpy(out + 12, indexMagic.data(), indexMagic.size());
+	m_output->write(footer);
+}
+
+bool LogBlockWriter::isOpen() const noexcept
+{
+	return m_output && m_output->isOpen();
+}
+
+bool LogBlockWriter::write(std::string_view batch) noexcept
+{
+	// A block closes once it holds blockBytes, at the next record's first line, so a record never spans two blocks. Lines
+	// with no stamp (raw output) only close one that has grown to twice the size.
+	bool ok = true;
+	try
+	{
+		forEachLine(batch,
+		            [&](std::string_view line)
+		            {
+			            const auto time = lineTime(line);
+			            if (m_pending.size() >= (time ? m_blockBytes : 2 * m_blockBytes))
+				            ok = seal(false) && ok;
+			            m_pending.append(line);
+			            if (!time)
+				            return;    // a continuation line, or raw output
+			            m_block.first = m_block.records == 0 ? *time : std::min(m_block.first, *time);
+			            m_block.last  = m_block.records == 0 ? *time : std::max(m_block.last, *time);
+			            ++m_block.records;
+		            });
+	}
+	catch (const std::bad_alloc&)
+	{
+		errno = ENOMEM;
+		return false;
+	}
+	return ok;
+}
+
+bool LogBlockWriter::sync() noexcept
+{
+	return seal(true);
+}
+
+bool LogBlockWriter::writeAndSync(std::string_view batch) noexcept
+{
+	// write() may already have sealed a full block; sealing again covers the rest
+	return write(batch) && seal(true);
+}
+
+bool LogBlockWriter::seal(bool syncAfter) noexcept
+{
+	if (m_pending.empty())
+		return !syncAfter || m_output->sync();
+
+	if (m_block.records == 0)
+		m_block.first = m_block.last = std::chrono::system_clock::now();    // nothing stamped: file it under now
+	m_block.offset = m_offset;
+
+	bool ok = false;
+	try
+	{
+		const std::string block = encodeBlock(m_pending, m_compression, m_block);
+		ok = syncAfter ? m_output->writeAndSync(block) : m_output->write(block);
+		if (ok)
+		{
+			m_index.push_back(m_block);
+			m_offset += block.size();
+		}
+	}
+	catch (const std::bad_alloc&)
+	{
+		errno = ENOMEM;
+	}
+	m_failed = m_failed || !ok;
+	m_pending.clear();
+	m_block = {};
+	return ok;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  LogBlockReader
+//----------------------------------------------------------------------------------------------------------------------
+LogBlockReader::LogBlockReader(const std::filesystem::path& path)
+    : m_path(path)
+{
+	std::error_code error;
+	const auto      size = std::filesystem::file_size(path, error);
+	if (error)
+		return;
+	std::ifstream file(path, std::ios::binary);
+	m_open = file && readIndex(file, size, m_index) != 0;
+}
+
+std::string LogBlockReader::read(const LogBlockIndexEntry& block) const
+{
+	std::ifstream file(m_path, std::ios::binary);
+	char          raw[blockHeaderBytes]{};
+	BlockHeader   header;
+	if (!file.seekg(static_cast<std::streamoff>(block.offset)).read(raw, sizeof(raw)) || !header.read(raw, block.offset))
+		throw std::runtime_error("no log block at offset " + std::to_string(block.offset) + " of " + m_path.string());
+
+	std::string payload(header.size, '\0');
+	if (!file.read(payload.data(), static_cast<std::streamsize>(payload.size())) || checksum(payload) != header.sum)
+		throw std::runtime_error("log block at offset " + std::to_string(block.offset) + " of " + m_path.string() + " is damaged");
+	return decodeBlock(header, payload);
+}
+
+std::string LogBlockReader::read(time_point from, time_point to) const
+{
+	std::string records;
+	for (const LogBlockIndexEntry& block : m_index)
+	{
+		if (block.last < from || block.first > to)
+			continue;    // the point of the index: this block is never read, let alone decompressed
+
+		bool inWindow = false;
+		forEachLine(read(block),
+		            [&](std::string_view line)
+		            {
+			            if (const auto time = lineTime(line))
+				            inWindow = *time >= from && *time <= to;
+			            if (inWindow)
+				            records.append(line);
+		            });
+	}
+	return records;
+}
+
+std::string LogBlockReader::readAll() const
+{
+	std::string records;
+	for (const LogBlockIndexEntry& block : m_index)
+		records += read(block);
+	return records;
+}
@@ -42,21 +42,58 @@
 //----------------------------
 
 // logerr
+#include <LogBinary.h>
+#include <LogBlocks.h>
 #include <LogFileWriter.h>
+#include <LogIndex.h>
 #include <appinfo.h>
 #include <date.h>
+#include <logSite.h>
 #include <logerrMacros.h>
 #include <timestampLite.h>
 
 // std
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
 #include <chrono>
 #include <cstdint>
+#include <cstring>
 #include <filesystem>
-#include <fstream>
 #include <future>
 #include <iostream>
+#include <list>
 #include <memory>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <stop_token>
 #include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// platform
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(__NR_io_uring_register)
+#define LOGERR_HAS_IO_URING
+#endif
+#endif
 
 //----------------------------
 //  USING NAMESPACE
@@ -64,22 +101,772 @@
 
 using namespace std::chrono_literals;
 
+namespace
+{
+	/// Push everything written to @p fd so far to the device.
+	bool syncDescriptor(int fd) noexcept
+	{
+#if defined(_WIN32)
+		return ::_commit(fd) == 0;
+#elif defined(__APPLE__)
+		return ::fsync(fd) == 0;
+#else
+		return ::fdatasync(fd) == 0;
+#endif
+	}
+
+	//------------------------------------------------------------------------------------------------------------------
+	//      CLASS: AppendFile
+	//------------------------------------------------------------------------------------------------------------------
+	/// @brief		The log file as a raw append-only descriptor: one write(2) per batch, and fdatasync when asked.
+	/// @details	A std::ofstream hides its descriptor, so it can neither sync nor be told where a batch ends.
+	//------------------------------------------------------------------------------------------------------------------
+	class AppendFile : public LogFileWriter::Output
+	{
+	public:
+		explicit AppendFile(const std::string& path)
+		{
+#if defined(_WIN32)
+			m_fd = ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_TEXT, _S_IREAD | _S_IWRITE);
+#else
+			m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+#endif
+		}
+
+		AppendFile(const AppendFile&)            = delete;
+		AppendFile& operator=(const AppendFile&) = delete;
+
+		~AppendFile() override
+		{
+			if (m_fd >= 0)
+			{
+#if defined(_WIN32)
+				::_close(m_fd);
+#else
+				::close(m_fd);
+#endif
+			}
+		}
+
+		[[nodiscard]] bool isOpen() const noexcept override { return m_fd >= 0; }
+
+		/// Write all of @p text, retrying short writes.
+		bool write(std::string_view text) noexcept override
+		{
+			while (!text.empty())
+			{
+#if defined(_WIN32)
+				const auto written = ::_write(m_fd, text.data(), static_cast<unsigned int>(std::min<std::size_t>(text.size(), 1u << 30)));
+#else
+				const auto written = ::write(m_fd, text.data(), text.size());
+#endif
+				if (written < 0)
+				{
+					if (errno == EINTR)
+						continue;
+					return false;
+				}
+				text.remove_prefix(static_cast<std::size_t>(written));
+			}
+			return true;
+		}
+
+		bool sync() noexcept override { return syncDescriptor(m_fd); }
+
+	private:
+		int m_fd = -1;
+	};
+
+#if !defined(_WIN32)
+	//------------------------------------------------------------------------------------------------------------------
+	//      CLASS: MappedFile
+	//------------------------------------------------------------------------------------------------------------------
+	/// @brief		The log file as a shared memory mapping: a batch is a memcpy into the page cache, with no syscall.
+	/// @details	The file grows in preallocated extents (fallocate, so a full disk fails the extension up front rather
+	///				than raising SIGBUS on a page fault later), and one extent-sized window of it is mapped at a time. The
+	///				copied pages belong to the page cache as soon as they are written, so they survive the process
+	///				crashing. A background thread starts their writeback (msync MS_ASYNC) on a cadence; sync() waits for
+	///				it. On close the file is truncated to the bytes actually written. After a crash the file still has
+	///				its preallocated, NUL-filled tail; the next open finds the true end by trimming it.
+	//------------------------------------------------------------------------------------------------------------------
+	class MappedFile : public LogFileWriter::Output
+	{
+	public:
+		MappedFile(const std::string& path, std::size_t extent, std::chrono::milliseconds syncInterval)
+		{
+			m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+			if (m_fd < 0)
+				return;
+
+			const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+			m_extent        = (std::max(extent, page) + page - 1) / page * page;
+			if (!recoverLength() || !mapWindow())
+			{
+				::close(m_fd);
+				m_fd = -1;
+				return;
+			}
+
+			if (syncInterval.count() > 0)
+			{
+				m_writeback = std::jthread(
+				    [this, syncInterval](std::stop_token stop)
+				    {
+					    std::unique_lock lock(m_mutex);
+					    while (!m_wakeup.wait_for(lock, stop, syncInterval, [] { return false; }) && !stop.stop_requested())
+						    startWriteback();
+				    });
+			}
+		}
+
+		MappedFile(const MappedFile&)            = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		~MappedFile() override
+		{
+			if (m_writeback.joinable())
+			{
+				m_writeback.request_stop();
+				m_writeback.join();
+			}
+			if (m_fd < 0)
+				return;
+			unmapWindow();
+			static_cast<void>(::ftruncate(m_fd, static_cast<off_t>(m_length)));
+			::close(m_fd);
+		}
+
+		[[nodiscard]] bool isOpen() const noexcept override { return m_fd >= 0; }
+
+		bool write(std::string_view text) noexcept override
+		{
+			const std::lock_guard lock(m_mutex);
+			while (!text.empty())
+			{
+				if (!m_window && !mapWindow())
+					return false;
+				const std::size_t used = m_length - m_windowOffset;
+				if (used == m_extent)
+				{
+					startWriteback();
+					unmapWindow();
+					if (!mapWindow())
+						return false;
+					continue;
+				}
+				const std::size_t count = std::min(text.size(), m_extent - used);
+				std::memcpy(m_window + used, text.data(), count);
+				m_length += count;
+				text.remove_prefix(count);
+			}
+			return true;
+		}
+
+		bool sync() noexcept override
+		{
+			const std::lock_guard lock(m_mutex);
+			// fdatasync also covers the windows already unmapped: their dirty pages are still the file's page cache
+			return (!m_window || ::msync(m_window, m_length - m_windowOffset, MS_SYNC) == 0) && syncDescriptor(m_fd);
+		}
+
+	private:
+		/// Find where the previous writer stopped: the file size, less any NUL-filled preallocation a crash left behind.
+		bool recoverLength() noexcept
+		{
+			struct stat status{};
+			if (::fstat(m_fd, &status) != 0)
+				return false;
+			m_allocated = static_cast<std::size_t>(status.st_size);
+			m_length    = m_allocated;
+
+			char buffer[4096];
+			while (m_length > 0)
+			{
+				const std::size_t chunk = std::min(m_length, sizeof(buffer));
+				if (::pread(m_fd, buffer, chunk, static_cast<off_t>(m_length - chunk)) != static_cast<ssize_t>(chunk))
+					return false;
+				const std::string_view bytes(buffer, chunk);
+				const std::size_t      last = bytes.find_last_not_of('\0');
+				if (last != std::string_view::npos)
+				{
+					m_length -= chunk - last - 1;
+					break;
+				}
+				m_length -= chunk;
+			}
+			return true;
+		}
+
+		/// Map the extent-sized, page-aligned window holding m_length, preallocating the file to cover it first.
+		bool mapWindow() noexcept
+		{
+			m_windowOffset         = m_length / m_extent * m_extent;
+			const std::size_t need = m_windowOffset + m_extent;
+			if (m_allocated < need)
+			{
+#if defined(__linux__)
+				if (::fallocate(m_fd, 0, static_cast<off_t>(m_allocated), static_cast<off_t>(need - m_allocated)) != 0
+				    && (errno != EOPNOTSUPP || ::ftruncate(m_fd, static_cast<off_t>(need)) != 0))
+					return false;
+#else
+				if (::ftruncate(m_fd, static_cast<off_t>(need)) != 0)
+					return false;
+#endif
+				m_allocated = need;
+			}
+
+			void* window = ::mmap(nullptr, m_extent, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, static_cast<off_t>(m_windowOffset));
+			if (window == MAP_FAILED)
+				return false;
+			m_window = static_cast<char*>(window);
+			::madvise(m_window, m_extent, MADV_SEQUENTIAL);
+			m_flushed = m_windowOffset;
+			return true;
+		}
+
+		void unmapWindow() noexcept
+		{
+			if (m_window)
+				::munmap(m_window, m_extent);
+			m_window = nullptr;
+		}
+
+		/// Start writeback of everything copied since the last call, without waiting for it. Caller holds m_mutex.
+		void startWriteback() noexcept
+		{
+			if (!m_window || m_length == m_flushed)
+				return;
+			const auto page  = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+			const auto begin = (m_flushed - m_windowOffset) / page * page;
+			::msync(m_window + begin, m_length - m_windowOffset - begin, MS_ASYNC);
+			m_flushed = m_length;
+		}
+
+		int                         m_fd           = -1;
+		std::size_t                 m_extent       = 0;          ///< window size and preallocation step, in whole pages.
+		std::size_t                 m_allocated    = 0;          ///< file size, including the preallocated tail.
+		std::size_t                 m_length       = 0;          ///< bytes of log actually written.
+		std::size_t                 m_windowOffset = 0;          ///< file offset of the mapped window.
+		std::size_t                 m_flushed      = 0;          ///< file offset up to which writeback has been started.
+		char*                       m_window       = nullptr;
+		std::mutex                  m_mutex;                     ///< the worker's writes vs. the writeback thread.
+		std::condition_variable_any m_wakeup;
+		std::jthread                m_writeback;
+	};
+#endif
+
+#if defined(LOGERR_HAS_IO_URING)
+	//------------------------------------------------------------------------------------------------------------------
+	//      CLASS: UringFile
+	//------------------------------------------------------------------------------------------------------------------
+	/// @brief		The log file written through io_uring: a batch is copied into one of a few registered buffers and
+	///				submitted, and the worker goes back to draining the queue while the kernel writes it.
+	/// @details	Up to bufferCount writes are in flight; write() only waits when every buffer is still busy, and a
+	///				completed write hands its buffer back. Writes carry explicit offsets, so several can be in flight
+	///				without reordering the file. writeAndSync() waits for every write in flight, then for an fdatasync,
+	///				and returns its result; failures of other asynchronous work are reported by the next call. Uses the
+	///				raw system calls, not liburing; ringReady() is false when the kernel or a seccomp profile refuses
+	///				the ring, or when the buffers could not be registered and the kernel cannot write from unregistered
+	///				ones.
+	//------------------------------------------------------------------------------------------------------------------
+	class UringFile : public LogFileWriter::Output
+	{
+	public:
+		static constexpr unsigned bufferCount = 4;
+
+		UringFile(const std::string& path, std::size_t bufferBytes)
+		    : m_bufferBytes(std::max<std::size_t>(bufferBytes, 4096))
+		{
+			m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+			struct stat status{};
+			if (m_fd < 0 || ::fstat(m_fd, &status) != 0)
+				return;
+			m_offset = static_cast<std::uint64_t>(status.st_size);
+			m_ready  = setupRing();
+			if (!m_ready)
+				return;
+			setupBuffers();
+			// unregistered buffers are written with IORING_OP_WRITE, which kernels before 5.6 reject with EINVAL
+			if (!m_fixed && !supports(IORING_OP_WRITE))
+			{
+				closeRing();
+				m_ready = false;
+			}
+		}
+
+		UringFile(const UringFile&)            = delete;
+		UringFile& operator=(const UringFile&) = delete;
+
+		~UringFile() override
+		{
+			if (m_ready)
+			{
+				while (m_inFlight > 0 && waitForCompletion())
+				{
+				}
+				closeRing();
+			}
+			if (m_fd >= 0)
+				::close(m_fd);
+		}
+
+		/// Whether the ring is up. When false the caller should use the portable path instead.
+		[[nodiscard]] bool ringReady() const noexcept { return m_ready; }
+
+		[[nodiscard]] bool isOpen() const noexcept override { return m_fd >= 0; }
+
+		bool write(std::string_view batch) noexcept override { return submitBatch(batch, false); }
+
+		bool writeAndSync(std::string_view batch) noexcept override { return submitBatch(batch, true); }
+
+		/// Wait for every write in flight, then fdatasync.
+		bool sync() noexcept override
+		{
+			while (m_inFlight > 0)
+			{
+				if (!waitForCompletion())
+					return false;
+			}
+			return reportFailure() && syncDescriptor(m_fd);
+		}
+
+	private:
+		enum : std::uint64_t
+		{
+			syncTag = bufferCount,    ///< user_data of an fdatasync; a write's is its buffer index.
+		};
+
+		struct Buffer
+		{
+			std::unique_ptr<char[]> data;
+			std::uint64_t           offset = 0;    ///< where the write in flight goes.
+			std::size_t             length = 0;    ///< its length.
+		};
+
+		static int enter(int ring, unsigned submit, unsigned waitFor) noexcept
+		{
+			return static_cast<int>(::syscall(__NR_io_uring_enter, ring, submit, waitFor, waitFor > 0 ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0));
+		}
+
+		static unsigned load(const unsigned* value) noexcept
+		{
+			return std::atomic_ref<unsigned>(*const_cast<unsigned*>(value)).load(std::memory_order_acquire);
+		}
+
+		static void store(unsigned* value, unsigned next) noexcept
+		{
+			std::atomic_ref<unsigned>(*value).store(next, std::memory_order_release);
+		}
+
+		bool setupRing() noexcept
+		{
+			io_uring_params params{};
+			const int ring = static_cast<int>(::syscall(__NR_io_uring_setup, 2 * bufferCount + 2, &params));
+			if (ring < 0)
+				return false;
+
+			m_sqSize   = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+			m_cqSize   = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+			m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+			const bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+			if (single)
+				m_sqSize = m_cqSize = std::max(m_sqSize, m_cqSize);
+
+			void* sq = ::mmap(nullptr, m_sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQ_RING);
+			void* cq = single || sq == MAP_FAILED
+			               ? sq
+			               : ::mmap(nullptr, m_cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_CQ_RING);
+			void* sqes = sq == MAP_FAILED || cq == MAP_FAILED
+			                 ? MAP_FAILED
+			                 : ::mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQES);
+			if (sqes == MAP_FAILED)
+			{
+				if (cq != MAP_FAILED && cq != sq)
+					::munmap(cq, m_cqSize);
+				if (sq != MAP_FAILED)
+					::munmap(sq, m_sqSize);
+				::close(ring);
+				return false;
+			}
+
+			m_ringFd = ring;
+			m_sqRing = static_cast<char*>(sq);
+			m_cqRing = static_cast<char*>(cq);
+			m_sqes   = static_cast<io_uring_sqe*>(sqes);
+			m_sqTail  = reinterpret_cast<unsigned*>(m_sqRing + params.sq_off.tail);
+			m_sqMask  = *reinterpret_cast<unsigned*>(m_sqRing + params.sq_off.ring_mask);
+			m_sqArray = reinterpret_cast<unsigned*>(m_sqRing + params.sq_off.array);
+			m_sqEntries = params.sq_entries;
+			m_cqHead  = reinterpret_cast<unsigned*>(m_cqRing + params.cq_off.head);
+			m_cqTail  = reinterpret_cast<unsigned*>(m_cqRing + params.cq_off.tail);
+			m_cqMask  = *reinterpret_cast<unsigned*>(m_cqRing + params.cq_off.ring_mask);
+			m_cqes    = reinterpret_cast<io_uring_cqe*>(m_cqRing + params.cq_off.cqes);
+			return true;
+		}
+
+		/// Allocate the buffers and register them with the ring. Unregistered buffers still work, just without the
+		/// fixed-buffer fast path (registration can fail on a low RLIMIT_MEMLOCK).
+		void setupBuffers() noexcept
+		{
+			std::array<iovec, bufferCount> vectors{};
+			for (unsigned index = 0; index < bufferCount; ++index)
+			{
+				m_buffers[index].data = std::make_unique_for_overwrite<char[]>(m_bufferBytes);
+				vectors[index]        = {m_buffers[index].data.get(), m_bufferBytes};
+				m_free[index]         = index;
+			}
+			m_freeCount = bufferCount;
+			m_fixed = ::syscall(__NR_io_uring_register, m_ringFd, IORING_REGISTER_BUFFERS, vectors.data(), bufferCount) == 0;
+		}
+
+		/// @brief		Whether the kernel supports @p opcode, by IORING_REGISTER_PROBE. A kernel too old to probe (before
+		///				5.6) is taken to support only the opcodes every io_uring kernel has, which this asks about only
+		///				for IORING_OP_WRITE - itself new in 5.6.
+		[[nodiscard]] bool supports(std::uint8_t opcode) const noexcept
+		{
+			constexpr unsigned opCount = 256;
+			alignas(io_uring_probe) std::array<std::byte, sizeof(io_uring_probe) + opCount * sizeof(io_uring_probe_op)> storage{};
+			auto* const probe = reinterpret_cast<io_uring_probe*>(storage.data());
+			if (::syscall(__NR_io_uring_register, m_ringFd, IORING_REGISTER_PROBE, probe, opCount) < 0)
+				return false;
+			return opcode <= probe->last_op && (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED) != 0;
+		}
+
+		void closeRing() noexcept
+		{
+			::munmap(m_sqes, m_sqesSize);
+			if (m_cqRing != m_sqRing)
+				::munmap(m_cqRing, m_cqSize);
+			::munmap(m_sqRing, m_sqSize);
+			::close(m_ringFd);
+			m_ringFd = -1;
+		}
+
+		/// The next submission queue entry, zeroed. There is always room: submitBatch() keeps the ring from filling.
+		io_uring_sqe& nextEntry() noexcept
+		{
+			const unsigned index = m_sqLocalTail & m_sqMask;
+			io_uring_sqe&  entry = m_sqes[index];
+			std::memset(&entry, 0, sizeof(entry));
+			m_sqArray[index] = index;
+			++m_sqLocalTail;
+			++m_unsubmitted;
+			return entry;
+		}
+
+		/// Copy @p batch into free buffers, one write per buffer, and submit them; with @p syncAfter, also wait for them
+		/// and for an fdatasync behind them.
+		bool submitBatch(std::string_view batch, bool syncAfter) noexcept
+		{
+			if (!reportFailure())
+				return false;
+
+			// a sync holds no buffer, so bound it too: a full ring could overflow the completion queue
+			while (m_inFlight + bufferCount + 1 > m_sqEntries)
+			{
+				if (!waitForCompletion())
+					return false;
+			}
+
+			while (!batch.empty())
+			{
+				while (m_freeCount == 0)
+				{
+					if (!waitForCompletion())
+						return false;
+				}
+
+				const unsigned    index  = m_free[--m_freeCount];
+				Buffer&           buffer = m_buffers[index];
+				buffer.length            = std::min(batch.size(), m_bufferBytes);
+				buffer.offset            = m_offset;
+				std::memcpy(buffer.data.get(), batch.data(), buffer.length);
+				batch.remove_prefix(buffer.length);
+				m_offset += buffer.length;
+
+				io_uring_sqe& entry = nextEntry();
+				entry.opcode        = m_fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+				entry.fd            = m_fd;
+				entry.addr          = reinterpret_cast<std::uint64_t>(buffer.data.get());
+				entry.len           = static_cast<std::uint32_t>(buffer.length);
+				entry.off           = buffer.offset;
+				entry.buf_index     = static_cast<std::uint16_t>(index);
+				entry.user_data     = index;
+				++m_inFlight;
+			}
+
+			if (!syncAfter)
+				return submit(0);
+
+			// A link orders the sync behind the one entry before it - not the batch's other writes, nor earlier
+			// batches' still in flight - so drain them all first; then the sync covers every byte written.
+			while (m_inFlight > 0)
+			{
+				if (!waitForCompletion())
+					return false;
+			}
+			if (!reportFailure())
+				return false;
+
+			io_uring_sqe& entry = nextEntry();
+			entry.opcode        = IORING_OP_FSYNC;
+			entry.fd            = m_fd;
+			entry.fsync_flags   = IORING_FSYNC_DATASYNC;
+			entry.user_data     = syncTag;
+			++m_inFlight;
+			while (m_inFlight > 0)
+			{
+				if (!waitForCompletion())
+					return false;
+			}
+			return reportFailure();
+		}
+
+		/// Publish the prepared entries and, if @p waitFor > 0, wait for that many completions; then reap.
+		bool submit(unsigned waitFor) noexcept
+		{
+			store(m_sqTail, m_sqLocalTail);
+			int result = 0;
+			do
+				result = enter(m_ringFd, m_unsubmitted, waitFor);
+			while (result < 0 && errno == EINTR);
+			if (result < 0)
+				return false;
+			m_unsubmitted -= std::min(m_unsubmitted, static_cast<unsigned>(result));
+			reap();
+			return true;
+		}
+
+		bool waitForCompletion() noexcept { return submit(1); }
+
+		/// Take every completion off the ring, recycling the finished buffers.
+		void reap() noexcept
+		{
+			unsigned       head = *m_cqHead;
+			const unsigned tail = load(m_cqTail);
+			for (; head != tail; ++head)
+			{
+				const io_uring_cqe& completion = m_cqes[head & m_cqMask];
+				--m_inFlight;
+				if (completion.user_data == syncTag)
+				{
+					if (completion.res < 0)
+						m_failure = -completion.res;
+					continue;
+				}
+
+				Buffer& buffer = m_buffers[completion.user_data];
+				if (completion.res < 0)
+					m_failure = -completion.res;
+				else if (static_cast<std::size_t>(completion.res) < buffer.length)
+					finishShortWrite(buffer, static_cast<std::size_t>(completion.res));
+				m_free[m_freeCount++] = static_cast<unsigned>(completion.user_data);
+			}
+			store(m_cqHead, head);
+		}
+
+		/// A write that completed short (rare on a regular file): write the rest synchronously.
+		void finishShortWrite(const Buffer& buffer, std::size_t written) noexcept
+		{
+			while (written < buffer.length)
+			{
+				const auto result = ::pwrite(m_fd, buffer.data.get() + written, buffer.length - written, static_cast<off_t>(buffer.offset + written));
+				if (result < 0 && errno == EINTR)
+					continue;
+				if (result <= 0)
+				{
+					m_failure = result < 0 ? errno : EIO;
+					return;
+				}
+				written += static_cast<std::size_t>(result);
+			}
+		}
+
+		/// false, with errno set, if asynchronous work failed since the last call.
+		bool reportFailure() noexcept
+		{
+			if (m_failure == 0)
+				return true;
+			errno = std::exchange(m_failure, 0);
+			return false;
+		}
+
+		int                                  m_fd          = -1;
+		int                                  m_ringFd      = -1;
+		bool                                 m_ready       = false;
+		bool                                 m_fixed       = false;    ///< the buffers are registered with the ring.
+		std::size_t                          m_bufferBytes;
+		std::uint64_t                        m_offset      = 0;        ///< where the next write goes.
+		std::array<Buffer, bufferCount>      m_buffers;
+		std::array<unsigned, bufferCount>    m_free{};                 ///< indexes of the buffers not in flight.
+		unsigned                             m_freeCount   = 0;
+		unsigned                             m_inFlight    = 0;        ///< submitted entries not yet completed.
+		int                                  m_failure     = 0;        ///< errno of a failed asynchronous operation.
+
+		char*         m_sqRing      = nullptr;
+		char*         m_cqRing      = nullptr;
+		io_uring_sqe* m_sqes        = nullptr;
+		std::size_t   m_sqSize      = 0;
+		std::size_t   m_cqSize      = 0;
+		std::size_t   m_sqesSize    = 0;
+		unsigned*     m_sqTail      = nullptr;
+		unsigned*     m_sqArray     = nullptr;
+		unsigned      m_sqMask      = 0;
+		unsigned      m_sqEntries   = 0;
+		unsigned      m_sqLocalTail = 0;
+		unsigned      m_unsubmitted = 0;
+		unsigned*     m_cqHead      = nullptr;
+		unsigned*     m_cqTail      = nullptr;
+		unsigned      m_cqMask      = 0;
+		io_uring_cqe* m_cqes        = nullptr;
+	};
+#endif
+
+	/// The log file itself, written the way @p options asks.
+	std::unique_ptr<LogFileWriter::Output> openLogFile(const std::string& path, const LogFileWriter::Options& options)
+	{
+#if !defined(_WIN32)
+		if (options.backend == LogFileWriter::Backend::Mapped)
+			return std::make_unique<MappedFile>(path, options.mappedExtentBytes, options.mappedSyncInterval);
+#endif
+#if defined(LOGERR_HAS_IO_URING)
+		if (options.backend == LogFileWriter::Backend::Uring)
+		{
+			auto file = std::make_unique<UringFile>(path, options.batchBytes);
+			if (file->ringReady())
+				return file;
+		}
+#endif
+		return std::make_unique<AppendFile>(path);
+	}
+
+	/// @brief		A rotating log's segment names: the first is the path itself, the n-th inserts ".n" before the extension.
+	/// @details	The extension is ".log.txt" for the auto-generated names, else the path's last extension. The series
+	///				prefix, which the archiver's retention matches, is "<repo>_<app>_" for an auto-generated name (so
+	///				earlier runs belong to the series) and "<stem>." for an explicit one.
+	struct SegmentNames
+	{
+		SegmentNames(const std::string& path, bool generated)
+		{
+			const std::filesystem::path first(path);
+			directory = first.parent_path().empty() ? std::filesystem::path(".") : first.parent_path();
+			stem      = first.filename().string();
+			extension = stem.ends_with(".log.txt") ? ".log.txt" : first.extension().string();
+			stem.resize(stem.size() - extension.size());
+			prefix = generated ? stem.substr(0, stem.rfind('_') + 1) : stem + '.';
+		}
+
+		/// The path of segment @p index, skipping names a previous run already used.
+		[[nodiscard]] std::string next(unsigned& index) const
+		{
+			const auto taken = [](const std::filesystem::path& segment)
+			{
+				std::error_code ignored;
+				for (const Compression compression : {Compression::None, Compression::Gzip, Compression::Zstd})
+				{
+					auto archived = segment;
+					archived += LogArchiver::extension(compression);
+					if (std::filesystem::exists(archived, ignored))
+						return true;
+				}
+				return false;
+			};
+
+			std::filesystem::path segment;
+			do
+				segment = directory / (stem + '.' + std::to_string(++index) + extension);
+			while (taken(segment));
+			return segment.string();
+		}
+
+		std::filesystem::path directory;
+		std::string           stem;         ///< the first segment's name without its extension.
+		std::string           extension;
+		std::string           prefix;
+	};
+
+	/// @brief		The call stacks whose trace the file already holds: the most recently written ones, up to a capacity.
+	/// @details	Worker thread only. Keyed by LogRecord::Trace::stack, so a repeat is found without looking at the text.
+	class SeenStacks
+	{
+	public:
+		explicit SeenStacks(std::size_t capacity)
+		    : m_capacity(capacity)
+		{
+		}
+
+		/// @brief		Record @p stack as the most recently written one.
+		/// @return		true if it was not already held: its trace has to be written in full.
+		bool insert(std::uint64_t stack)
+		{
+			if (const auto found = m_index.find(stack); found != m_index.end())
+			{
+				m_order.splice(m_order.begin(), m_order, found->second);
+				return false;
+			}
+			if (m_capacity == 0)
+				return true;
+			if (m_order.size() == m_capacity)
+			{
+				m_index.erase(m_order.back());
+				m_order.pop_back();
+			}
+			m_order.push_front(stack);
+			m_index.emplace(stack, m_order.begin());
+			return true;
+		}
+
+	private:
+		std::size_t                                                       m_capacity;
+		std::list<std::uint64_t>                                          m_order;    ///< most recent first.
+		std::unordered_map<std::uint64_t, std::list<std::uint64_t>::iterator> m_index;
+	};
+
+	/// @brief		@p record with its trace footer replaced by a one-line note, the message kept verbatim.
+	LogRecord collapseTrace(const LogRecord& record)
+	{
+		const std::string_view message = record.view().substr(0, record.trace().offset);
+		return LogRecord::build(
+		    record.level(),
+		    [&](std::string& collapsed)
+		    {
+			    collapsed.append(message);
+			    if (!collapsed.empty() && collapsed.back() != '\n')
+				    collapsed += '\n';
+			    collapsed += "    (trace deduplicated - identical call stack already recorded above)\n";
+		    });
+	}
+}    // namespace
+
 //--------------------------------------------------------------------------------------------------
 //	LogFileWriter (public ) []
 //--------------------------------------------------------------------------------------------------
 /// @brief Constructor
 /// @param logFilePath path to the log file for this application
 LogFileWriter::LogFileWriter(std::string logFilePath)
+    : LogFileWriter(std::move(logFilePath), Options{})
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+//	LogFileWriter (public ) []
+//--------------------------------------------------------------------------------------------------
+/// @brief Constructor
+/// @param logFilePath path to the log file for this application
+/// @param options when queued records are written, and how durably (see Options)
+LogFileWriter::LogFileWriter(std::string logFilePath, Options options)
+    : m_logQueue(options.queueLimits)
 {
 	auto ready = std::make_shared<std::promise<void>>();
 	auto readyFuture = ready->get_future();
 
-	m_thread = std::jthread([this, logFilePath = std::move(logFilePath), ready](std::stop_token stop) mutable noexcept
+	m_thread = std::jthread([this, logFilePath = std::move(logFilePath), options, ready](std::stop_token stop) mutable noexcept
 	                       {
 		                       bool readyReported = false;
 		                       try
 		                       {
-		                       if (logFilePath.empty())
+		                       const bool generatedPath = logFilePath.empty();
+		                       if (generatedPath)
 		                       {
 			                       auto currentDateTime = date::format("%FT%TZ", date::floor<std::chrono::milliseconds>(std::chrono::system_clock::now()));
 			                       std::erase(currentDateTime, ':');
@@ -91,7 +878,8 @@ LogFileWriter::LogFileWriter(std::string logFilePath)
 			                       }
 
 			                       std::ostringstream ss;
-			                       ss << APPINFO::logDir() << name << "_" << currentDateTime << ".log.txt";
+			                       ss << APPINFO::logDir() << name << "_" << currentDateTime
+			                          << (options.format == Format::Blocks ? ".logz" : options.format == Format::Binary ? ".logb" : ".log.txt");
 
 			                       logFilePath = ss.str();
 		                       }
@@ -115,12 +903,20 @@ LogFileWriter::LogFileWriter(std::string logFilePath)
 			                       error = true;
 		                       }
 
-		                       // open an unbuffered log file
-		                       std::ofstream logFile;
-		                       logFile.rdbuf()->pubsetbuf(nullptr, 0);
-		                       logFile.open(logFilePath, std::ios::out | std::ios::app);
+		                       // open the log file for appending. The worker does its own buffering, one batch at a time.
+		                       const auto open = [&options](const std::string& path) -> std::unique_ptr<Output>
+		                       {
+			                       const auto openOutput = [&options](const std::string& outputPath)
+			                       { return options.openOutput ? options.openOutput(outputPath) : openFile(outputPath, options); };
+			                       if (options.format == Format::Blocks)
+				                       return std::make_unique<LogBlockWriter>(path, options.compression, options.blockBytes, openOutput);
+			                       if (options.format == Format::Text && options.sidecarIndex)
+				                       return std::make_unique<LogIndexWriter>(path, options.indexBlockBytes, openOutput);
+			                       return openOutput(path);
+		                       };
+		                       std::unique_ptr<Output> logFile = open(logFilePath);
 
-		                       if (!logFile.is_open())
+		                       if (!logFile || !logFile->isOpen())
 		                       {
 			                       std::cerr << '[' << TimestampLite() << "] [ERROR]    Failed to open the log file for writing: "
 			                                 << logFilePath << '\n';
@@ -138,25 +934,204 @@ LogFileWriter::LogFileWriter(std::string logFilePath)
 		                       ready->set_value();
 		                       readyReported = true;
 
-		                       // don't try to log to a file we couldn't open...
+		                       // don't try to log to a file we couldn't open... and don't let a writer wait for room that
+		                       // will never come.
 		                       if (error)
 		                       {
+			                       m_logQueue.close();
 			                       return;
 		                       }
 
-		                       // log lines as we receive them into the queue
-		                       std::string logEntry;
-		                       while (m_logQueue.wait_pop(logEntry, stop))
+		                       // Rotation: the worker moves to a new segment between batches, so producers never wait on
+		                       // it; closing, compressing and pruning old segments is the archiver thread's business.
+		                       const bool rotating = options.rotateBytes != 0 || options.rotateInterval.count() > 0;
+		                       const SegmentNames segmentNames(logFilePath, generatedPath);
+		                       LogArchiver::SegmentLock   liveLock(logFilePath);    // before any archiver can see the series
+		                       std::optional<LogArchiver> archiver;
+		                       if (rotating || options.retention.maxBytes != 0 || options.retention.maxFiles != 0)
+			                       archiver.emplace(segmentNames.directory, segmentNames.prefix, segmentNames.extension,
+			                                        options.format == Format::Blocks ? Compression::None : options.compression,
+			                                        options.retention, logFilePath);
+
+		                       unsigned      segmentIndex  = 0;
+		                       auto          segmentOpened = std::chrono::steady_clock::now();
+		                       std::uint64_t segmentBytes  = 0;
+		                       {
+			                       std::error_code ignored;
+			                       if (const auto existing = std::filesystem::file_size(logFilePath, ignored); !ignored)
+				                       segmentBytes = existing;
+		                       }
+
+		                       bool rotateFailed = false;
+		                       const auto rotateBefore = [&](std::size_t batchBytes)
+		                       {
+			                       const bool full    = options.rotateBytes != 0 && segmentBytes + batchBytes > options.rotateBytes;
+			                       const bool expired = options.rotateInterval.count() > 0 &&
+			                                            std::chrono::steady_clock::now() - segmentOpened >= options.rotateInterval;
+			                       if (segmentBytes == 0 || (!full && !expired))
+				                       return;
+
+			                       const std::string nextPath = segmentNames.next(segmentIndex);
+			                       std::unique_ptr<Output> nextFile = open(nextPath);
+			                       if (!nextFile || !nextFile->isOpen())
+			                       {
+				                       // keep writing the current segment, and try again after another interval
+				                       if (!std::exchange(rotateFailed, true))
+					                       std::cerr << '[' << TimestampLite() << "] [ERROR]    Failed to open the next log segment: "
+					                                 << nextPath << '\n';
+				                       segmentOpened = std::chrono::steady_clock::now();
+				                       return;
+			                       }
+
+			                       logFile  = std::move(nextFile);    // closes the previous segment
+			                       liveLock = LogArchiver::SegmentLock(nextPath);
+			                       archiver->archive(std::exchange(logFilePath, nextPath), nextPath);
+			                       {
+				                       const std::lock_guard<std::mutex> pathLock(m_filePathMutex);
+				                       m_filePath = logFilePath;
+			                       }
+			                       segmentBytes  = 0;
+			                       segmentOpened = std::chrono::steady_clock::now();
+		                       };
+
+		                       // Group commit: wait for a record, then take everything queued behind it in one go and
+		                       // write the lot with a single syscall. A batch is written once it reaches batchBytes, or
+		                       // once the queue has drained and flushInterval has passed without it filling up.
+		                       std::string               batch;
+		                       std::vector<LogRecord> pending;
+		                       std::size_t               buffered      = 0;    ///< text bytes in the batch.
+		                       bool                      batchHasError = false;
+		                       batch.reserve(options.batchBytes);
+
+		                       // Binary: the batch keeps the records and is encoded at commit, once it is known which
+		                       // segment - and so which string and site tables - it goes to.
+		                       const bool             binary = options.format == Format::Binary;
+		                       std::vector<LogRecord> binaryBatch;
+		                       LogBinaryEncoder       encoder;
+		                       encoder.restart(segmentBytes == 0);
+
+		                       // A trace footer goes to the file once per stack; repeats are collapsed here, on the
+		                       // worker, by the fingerprint the record carries (the GUI dock, a separate sink, still
+		                       // shows every full trace).
+		                       SeenStacks seenStacks(options.traceDedupStacks);
+
+		                       const bool syncErrors = options.durability == Durability::SyncOnError || options.durability == Durability::ByLevel;
+		                       const auto append     = [&](const LogRecord& traced)
+		                       {
+			                       const LogRecord record = traced.trace().stack == 0 || seenStacks.insert(traced.trace().stack)
+			                                                    ? traced
+			                                                    : collapseTrace(traced);
+			                       if (binary)
+				                       binaryBatch.push_back(record);
+			                       else
+				                       batch.append(record.view());
+			                       buffered += record.size();
+			                       if (syncErrors && traced.level() == logerr::Level::Error)
+				                       batchHasError = true;
+		                       };
+		                       const auto encodeBatch = [&]
 		                       {
-			                       logFile << logEntry;
-			                       logFile.flush();
+			                       batch.clear();
+			                       for (const LogRecord& record : binaryBatch)
+				                       encoder.encode(record, batch);
+		                       };
+
+		                       bool writeFailed = false;
+		                       const auto commit = [&]
+		                       {
+			                       if (buffered == 0)
+				                       return;
+			                       if (binary)
+				                       encodeBatch();
+			                       if (rotating)
+			                       {
+				                       const std::string previousPath = logFilePath;
+				                       rotateBefore(batch.size());
+				                       if (binary && logFilePath != previousPath)
+				                       {
+					                       encoder.restart(true);
+					                       encodeBatch();
+				                       }
+			                       }
+			                       segmentBytes += batch.size();
+			                       const bool ok = options.durability == Durability::SyncBatch || batchHasError
+			                                           ? logFile->writeAndSync(batch)
+			                                           : logFile->write(batch);
+			                       if (!ok && !writeFailed)
+			                       {
+				                       const int failure = errno;
+				                       writeFailed = true;    // report the first failure only; a full disk fails every batch
+				                       std::cerr << '[' << TimestampLite() << "] [ERROR]    Failed to write the log file: "
+				                                 << logFilePath << ". Details: " << std::strerror(failure) << '\n';
+			                       }
+			                       batch.clear();
+			                       binaryBatch.clear();
+			                       buffered      = 0;
+			                       batchHasError = false;
+		                       };
+
+		                       // ByLevel: lines below ERROR stay in the batch until it fills or lazyDeadline, set when
+		                       // the first of them went in, passes; the worker waits for the queue no longer than that.
+		                       const bool lazy = options.durability == Durability::ByLevel;
+		                       std::chrono::steady_clock::time_point lazyDeadline;
+		                       const auto droppedNotice = [&]
+		                       {
+			                       // once the queue has drained, account for anything it had to drop in the meantime
+			                       if (const std::size_t dropped = m_logQueue.takeDroppedIfEmpty())
+				                       append(LogRecord(logerr::droppedLinesNotice(dropped, "log file queue full"), logerr::Level::Warning));
+		                       };
+
+		                       LogRecord logEntry;
+		                       for (;;)
+		                       {
+			                       const bool holding = lazy && buffered != 0;
+			                       if (!(holding ? m_logQueue.wait_pop_until(logEntry, stop, lazyDeadline) : m_logQueue.wait_pop(logEntry, stop)))
+			                       {
+				                       if (stop.stop_requested())
+					                       break;
+				                       commit();    // the held lines' time is up
+				                       continue;
+			                       }
+
+			                       const auto now      = std::chrono::steady_clock::now();
+			                       const auto deadline = now + options.flushInterval;
+			                       if (!holding)
+				                       lazyDeadline = now + options.lazyCommitInterval;
+			                       append(logEntry);
+
+			                       // an ERROR ends the gathering at once: it is synced with whatever was queued ahead of it
+			                       while (buffered < options.batchBytes && !batchHasError)
+			                       {
+				                       pending.clear();
+				                       if (m_logQueue.pop_all(pending) != 0)
+				                       {
+					                       for (const LogRecord& record : pending)
+						                       append(record);
+				                       }
+				                       else if (options.flushInterval.count() > 0 && m_logQueue.wait_pop_until(logEntry, stop, deadline))
+				                       {
+					                       append(logEntry);
+				                       }
+				                       else
+				                       {
+					                       break;
+				                       }
+			                       }
+			                       pending.clear();
+			                       droppedNotice();
+
+			                       if (buffered >= options.batchBytes || batchHasError ||
+			                           (lazy ? std::chrono::steady_clock::now() >= lazyDeadline : options.durability != Durability::None))
+				                       commit();
 		                       }
 
-		                       // close the log on exit
-		                       logFile.close();
+		                       // write whatever is still buffered on exit; the file closes with logFile
+		                       droppedNotice();
+		                       commit();
 		                       }
 		                       catch (...)
 		                       {
+			                       m_logQueue.close();
 			                       const auto failure = std::current_exception();
 			                       if (!readyReported)
 			                       {
@@ -200,85 +1175,37 @@ LogFileWriter::LogFileWriter(std::string logFilePath)
 LogFileWriter::~LogFileWriter()
 = default;
 
+//--------------------------------------------------------------------------------------------------
+//	openFile (public ) [static ]
+//--------------------------------------------------------------------------------------------------
+std::unique_ptr<LogFileWriter::Output> LogFileWriter::openFile(const std::string& path, const Options& options)
+{
+	return openLogFile(path, options);
+}
+
 //--------------------------------------------------------------------------------------------------
 //	write (public ) []
 //--------------------------------------------------------------------------------------------------
-/// @brief Queues a string to be written into the log file
-/// @param str String (or line) to write to the log
+/// @brief Queues a record to be written into the log file
+/// @param record the line to write to the log. Only the handle is queued; the text is shared, not copied.
 /// @remarks this function is thread-safe
-void LogFileWriter::write(std::string str)
+void LogFileWriter::write(LogRecord record)
 {
-	// Deduplicate a repeated trace footer for the ON-DISK log only (the GUI dock, a separate sink, still shows every
-	// full trace). The first entry carrying a given stack keeps its full footer; a later entry with the identical
-	// footer is written with the footer collapsed to a one-line note, so the file does not repeat an identical stack.
-	m_logQueue.emplace(deduplicateTraceFooter(std::move(str)));
+	const std::size_t   bytes = record.size();
+	const logerr::Level level = record.level();
+	m_logQueue.push(std::move(record), bytes, level);    // applies the overflow policy; a drop is counted, not reported here
 }
 
 //--------------------------------------------------------------------------------------------------
-//	deduplicateTraceFooter (private ) []
+//	write (public ) []
 //--------------------------------------------------------------------------------------------------
-/// @brief Collapse a repeated stack-trace footer in a file-bound log entry (see the header for the contract).
-std::string LogFileWriter::deduplicateTraceFooter(std::string entry)
+/// @brief Queues a string to be written into the log file
+/// @param str String (or line) to write to the log. Adopted by the queued record without a copy.
+/// @param level the level @p str was logged at
+/// @remarks this function is thread-safe
+void LogFileWriter::write(std::string str, logerr::Level level)
 {
-	// The trace footer is the trailing run of symbolized frame lines. formatFrames emits each as, e.g.,
-	//   "    [0  ]   0x00007ff...: slipway.cpp:1519            | Slipway::continueLaunch"
-	// Detect the footer's first line by that leading "[<digits>]" + " 0x" shape (indentation-agnostic), and treat from
-	// there to the end of the entry as the footer. Everything before it is the message (kept verbatim).
-	const auto isFrameLine = [](std::string_view line) noexcept
-	{
-		std::size_t i = 0;
-		while (i < line.size() && (line[i] == ' ' || line[i] == '\t')) ++i;
-		if (i >= line.size() || line[i] != '[') return false;
-		++i;
-		const std::size_t digitsStart = i;
-		while (i < line.size() && line[i] >= '0' && line[i] <= '9') ++i;
-		if (i == digitsStart) return false;    // "[" not followed by a frame index
-		while (i < line.size() && line[i] == ' ') ++i;
-		if (i >= line.size() || line[i] != ']') return false;
-		return line.find("0x") != std::string_view::npos;    // a symbolized frame carries a hex address
-	};
-
-	// Find the byte offset of the first frame line (scanning line by line). No frame line -> not a traced error; return
-	// the entry untouched.
-	std::size_t footerStart = std::string::npos;
-	std::size_t lineBegin    = 0;
-	while (lineBegin < entry.size())
-	{
-		std::size_t lineEnd = entry.find('\n', lineBegin);
-		if (lineEnd == std::string::npos) lineEnd = entry.size();
-		if (isFrameLine(std::string_view(entry).substr(lineBegin, lineEnd - lineBegin)))
-		{
-			footerStart = lineBegin;
-			break;
-		}
-		lineBegin = lineEnd + 1;
-	}
-	if (footerStart == std::string::npos)
-		return entry;    // no trace footer to dedup
-
-	const std::string_view footer(std::string_view(entry).substr(footerStart));
-
-	// FNV-1a over the footer bytes: a stable, cheap key for "the same trace, symbolized identically."
-	std::uint64_t hash = 1469598103934665603ULL;
-	for (const char c : footer)
-	{
-		hash ^= static_cast<std::uint8_t>(c);
-		hash *= 1099511628211ULL;
-	}
-
-	{
-		const std::lock_guard<std::mutex> lock(m_dedupMutex);
-		if (m_seenTraceFooters.insert(hash).second)
-			return entry;    // first time this footer is seen: write it in full
-	}
-
-	// A repeat: keep the message (everything before the footer) and replace the footer with a one-line note so the
-	// on-disk log records THAT the error recurred on the same stack without re-printing the whole trace.
-	std::string collapsed = entry.substr(0, footerStart);
-	if (!collapsed.empty() && collapsed.back() != '\n')
-		collapsed += '\n';
-	collapsed += "    (trace deduplicated - identical call stack already recorded above)\n";
-	return collapsed;
+	write(LogRecord(std::move(str), level));
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -0,0 +1,493 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LOG INDEX
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+
+
+//----------------------------
+//  INCLUDES
+//----------------------------
+
+// logerr
+#include <LogIndex.h>
+#include <logSite.h>
+#include <timestampLite.h>
+
+// std
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+
+// platform
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	using time_point = std::chrono::system_clock::time_point;
+	using logerr::Level;
+
+	constexpr std::string_view magic      = "LOGERRX1";
+	constexpr std::size_t      entryBytes = 40;
+
+	//------------------------------------------------------------------------------------------------------------------
+	//  encoding
+	//------------------------------------------------------------------------------------------------------------------
+
+	void store(char* out, std::uint64_t value, std::size_t bytes) noexcept
+	{
+		for (std::size_t i = 0; i < bytes; ++i, value >>= 8)
+			out[i] = static_cast<char>(value & 0xff);
+	}
+
+	std::uint64_t load(const char* in, std::size_t bytes) noexcept
+	{
+		std::uint64_t value = 0;
+		for (std::size_t i = bytes; i-- > 0;)
+			value = value << 8 | static_cast<std::uint8_t>(in[i]);
+		return value;
+	}
+
+	std::uint64_t toNanoseconds(time_point time) noexcept
+	{
+		return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count());
+	}
+
+	time_point fromNanoseconds(std::uint64_t nanoseconds) noexcept
+	{
+		return time_point(std::chrono::duration_cast<time_point::duration>(std::chrono::nanoseconds(static_cast<std::int64_t>(nanoseconds))));
+	}
+
+	void encode(const LogIndexEntry& entry, char* out) noexcept
+	{
+		store(out, entry.offset, 8);
+		store(out + 8, entry.bytes, 4);
+		store(out + 12, entry.records, 4);
+		store(out + 16, entry.stamped, 4);
+		store(out + 20, entry.levels, 4);
+		store(out + 24, toNanoseconds(entry.first), 8);
+		store(out + 32, toNanoseconds(entry.last), 8);
+	}
+
+	LogIndexEntry decode(const char* in) noexcept
+	{
+		return {.offset  = load(in, 8),
+		        .bytes   = static_cast<std::uint32_t>(load(in + 8, 4)),
+		        .records = static_cast<std::uint32_t>(load(in + 12, 4)),
+		        .stamped = static_cast<std::uint32_t>(load(in + 16, 4)),
+		        .levels  = static_cast<std::uint32_t>(load(in + 20, 4)),
+		        .first   = fromNanoseconds(load(in + 24, 8)),
+		        .last    = fromNanoseconds(load(in + 32, 8))};
+	}
+
+	//------------------------------------------------------------------------------------------------------------------
+	//  records
+	//------------------------------------------------------------------------------------------------------------------
+
+	/// Calls @p visit(line) for each line of @p text, newline included.
+	template<class Visit>
+	void forEachLine(std::string_view text, Visit&& visit)
+	{
+		while (!text.empty())
+		{
+			const std::size_t end = std::min(text.find('\n'), text.size() - 1) + 1;
+			visit(text.substr(0, end));
+			text.remove_prefix(end);
+		}
+	}
+
+	/// The level whose label @p firstLine carries. Raw output with no label counts as INFO.
+	Level levelOf(std::string_view firstLine) noexcept
+	{
+		for (const Level level : {Level::Error, Level::Warning, Level::Debug})
+		{
+			if (firstLine.find(logerr::levelLabel(level)) != std::string_view::npos)
+				return level;
+		}
+		return Level::Info;
+	}
+
+	/// The time a record is stamped with: its leading "[YYYY-mm-dd HH:MM:SS.nnnnnnnnn TZ", in local time.
+	std::optional<time_point> recordTime(std::string_view firstLine)
+	{
+		if (firstLine.empty() || firstLine.front() != '[')
+			return std::nullopt;
+		return TimestampLite::parse(firstLine.substr(1));
+	}
+
+	/// The first occurrence of @p needle in @p text, or npos. glibc's memmem is vectorized; std::search is not.
+	std::size_t find(std::string_view text, std::string_view needle) noexcept
+	{
+#if defined(__GLIBC__)
+		const void* found = ::memmem(text.data(), text.size(), needle.data(), needle.size());
+		return found != nullptr ? static_cast<std::size_t>(static_cast<const char*>(found) - text.data()) : std::string_view::npos;
+#else
+		return text.find(needle);
+#endif
+	}
+
+	/// The length of @p path, less any NUL-filled preallocation a crashed Backend::Mapped writer left behind.
+	std::uint64_t dataLength(const std::string& path)
+	{
+		std::error_code error;
+		std::uint64_t   length = std::filesystem::exists(path, error) ? std::filesystem::file_size(path, error) : 0;
+		if (error)
+			return 0;
+
+		std::ifstream file(path, std::ios::binary);
+		char          buffer[4096];
+		while (length > 0)
+		{
+			const std::uint64_t chunk = std::min<std::uint64_t>(length, sizeof(buffer));
+			if (!file.seekg(static_cast<std::streamoff>(length - chunk)).read(buffer, static_cast<std::streamsize>(chunk)))
+				return 0;
+			const std::size_t last = std::string_view(buffer, chunk).find_last_not_of('\0');
+			if (last != std::string_view::npos)
+				return length - (chunk - last - 1);
+			length -= chunk;
+		}
+		return 0;
+	}
+
+	//------------------------------------------------------------------------------------------------------------------
+	//  MappedLog
+	//------------------------------------------------------------------------------------------------------------------
+	/// @brief		A log file mapped read-only for the length of a query (read into memory where there is no mmap).
+	class MappedLog
+	{
+	public:
+		explicit MappedLog(const std::filesystem::path& path)
+		{
+#if !defined(_WIN32)
+			const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+			if (fd < 0)
+				return;
+			struct stat status{};
+			if (::fstat(fd, &status) == 0)
+			{
+				m_open = true;
+				m_size = static_cast<std::size_t>(status.st_size);
+				if (m_size != 0)
+				{
+					void* map = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+					if (map != MAP_FAILED)
+						m_map = static_cast<const char*>(map);
+					m_open = m_map != nullptr;
+				}
+			}
+			::close(fd);
+#else
+			std::ifstream file(path, std::ios::binary);
+			if (!file)
+				return;
+			m_copy.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+			m_open = true;
+			m_map  = m_copy.data();
+			m_size = m_copy.size();
+#endif
+		}
+
+		~MappedLog()
+		{
+#if !defined(_WIN32)
+			if (m_map != nullptr)
+				::munmap(const_cast<char*>(m_map), m_size);
+#endif
+		}
+
+		MappedLog(const MappedLog&)            = delete;
+		MappedLog& operator=(const MappedLog&) = delete;
+
+		[[nodiscard]] bool             isOpen() const noexcept { return m_open; }
+		[[nodiscard]] std::string_view bytes() const noexcept { return {m_map, m_size}; }
+
+	private:
+		const char* m_map  = nullptr;
+		std::size_t m_size = 0;
+		bool        m_open = false;
+#if defined(_WIN32)
+		std::string m_copy;
+#endif
+	};
+}    // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+//  LogIndexWriter
+//----------------------------------------------------------------------------------------------------------------------
+LogIndexWriter::LogIndexWriter(const std::string& path, std::size_t blockBytes, const OpenOutput& open)
+    : m_blockBytes(std::max<std::size_t>(blockBytes, 4096))
+{
+	// Keep the entries that still describe the log, and pick up where they end: what an earlier writer left unindexed
+	// is indexed below, and a log that never had an index is indexed from its end on.
+	const std::uint64_t              length  = dataLength(path);
+	const std::vector<LogIndexEntry> entries = LogQuery::readIndex(path, length);
+	m_offset = entries.empty() ? length : entries.back().offset + entries.back().bytes;
+
+	std::string tail;
+	if (m_offset < length)
+	{
+		tail.resize(static_cast<std::size_t>(length - m_offset));
+		std::ifstream log(path, std::ios::binary);
+		if (!log.seekg(static_cast<std::streamoff>(m_offset)).read(tail.data(), static_cast<std::streamsize>(tail.size())))
+			tail.clear();
+	}
+
+	m_output = open(path);
+	if (!isOpen())
+		return;
+
+	m_index.open(sidecarPath(path), std::ios::binary | std::ios::trunc);
+	std::string header(magic);
+	header.resize(magic.size() + entries.size() * entryBytes);
+	for (std::size_t i = 0; i < entries.size(); ++i)
+		encode(entries[i], header.data() + magic.size() + i * entryBytes);
+	m_failed = !m_index.write(header.data(), static_cast<std::streamsize>(header.size()));
+	if (!m_failed && !tail.empty())
+		index(tail);
+}
+
+LogIndexWriter::~LogIndexWriter()
+{
+	if (!m_failed)
+		close();
+}
+
+bool LogIndexWriter::isOpen() const noexcept
+{
+	return m_output && m_output->isOpen();
+}
+
+bool LogIndexWriter::write(std::string_view batch) noexcept
+{
+	if (!m_output->write(batch))
+	{
+		m_failed = true;
+		return false;
+	}
+	index(batch);
+	return true;
+}
+
+bool LogIndexWriter::sync() noexcept
+{
+	return m_output->sync();
+}
+
+bool LogIndexWriter::writeAndSync(std::string_view batch) noexcept
+{
+	if (!m_output->writeAndSync(batch))
+	{
+		m_failed = true;
+		return false;
+	}
+	index(batch);
+	return true;
+}
+
+std::filesystem::path LogIndexWriter::sidecarPath(const std::filesystem::path& log)
+{
+	auto path = log;
+	path += ".idx";
+	return path;
+}
+
+void LogIndexWriter::index(std::string_view text)
+{
+	if (m_failed)
+		return;
+
+	// A block closes once it holds blockBytes, at the next record's first line. Lines that start no record (raw output)
+	// only close one that has grown to twice the size.
+	forEachLine(text,
+	            [&](std::string_view line)
+	            {
+		            const bool record = line.front() == '[';
+		            if (m_block.bytes >= (record ? m_blockBytes : 2 * m_blockBytes))
+			            close();
+		            if (m_block.bytes == 0)
+			            m_block.offset = m_offset;
+		            m_block.bytes += static_cast<std::uint32_t>(line.size());
+		            m_offset += line.size();
+		            if (!record)
+			            return;
+
+		            ++m_block.records;
+		            m_block.levels |= LogQuery::levelBit(levelOf(line));
+		            if (const auto time = recordTime(line))
+		            {
+			            m_block.first = m_block.stamped == 0 ? *time : std::min(m_block.first, *time);
+			            m_block.last  = m_block.stamped == 0 ? *time : std::max(m_block.last, *time);
+			            ++m_block.stamped;
+		            }
+	            });
+}
+
+void LogIndexWriter::close()
+{
+	if (m_block.bytes == 0)
+		return;
+	char entry[entryBytes];
+	encode(m_block, entry);
+	m_failed = !m_index.write(entry, sizeof(entry)).flush();
+	m_block  = {};
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  LogQuery
+//----------------------------------------------------------------------------------------------------------------------
+std::vector<LogIndexEntry> LogQuery::readIndex(const std::filesystem::path& log, std::uint64_t logBytes)
+{
+	std::vector<LogIndexEntry> entries;
+	std::ifstream              file(LogIndexWriter::sidecarPath(log), std::ios::binary);
+	char                       header[magic.size()]{};
+	if (!file.read(header, sizeof(header)) || std::string_view(header, sizeof(header)) != magic)
+		return entries;
+
+	// entries run back to back; the first that does not (a torn write, or a log rewritten since) ends the index
+	char entry[entryBytes];
+	while (file.read(entry, sizeof(entry)))
+	{
+		const LogIndexEntry decoded = decode(entry);
+		const bool          follows = entries.empty() || decoded.offset == entries.back().offset + entries.back().bytes;
+		if (!follows || decoded.bytes == 0 || decoded.offset + decoded.bytes > logBytes)
+			break;
+		entries.push_back(decoded);
+	}
+	return entries;
+}
+
+std::size_t LogQuery::run(const std::filesystem::path& log, const std::function<void(std::string_view record)>& visit) const
+{
+	const MappedLog mapped(log);
+	if (!mapped.isOpen())
+		throw std::runtime_error("cannot open " + log.string());
+	const std::string_view bytes = mapped.bytes();
+
+	// The literal every match must contain that is likely to be rarest: the text, the tag's field, or a single level's label.
+	const std::string tagField = tag.empty() ? std::string() : "] [" + tag + "] ";
+	std::string_view  anchor   = !text.empty() ? std::string_view(text) : std::string_view(tagField);
+	if (anchor.empty() && std::popcount(levels & allLevels) == 1)
+	{
+		for (const Level level : {Level::Debug, Level::Info, Level::Warning, Level::Error})
+		{
+			if (levels & levelBit(level))
+				anchor = logerr::levelLabel(level);
+		}
+		if (anchor == logerr::levelLabel(Level::Info))
+			anchor = {};    // an unlabeled line is INFO too
+	}
+
+	const auto matches = [&](std::string_view record)
+	{
+		const std::string_view firstLine = record.substr(0, record.find('\n'));
+		if ((levels & allLevels) != allLevels && (levels & levelBit(levelOf(firstLine))) == 0)
+			return false;
+		if (!tagField.empty() && firstLine.find(tagField) == std::string_view::npos)
+			return false;
+		if (from || to)
+		{
+			const auto time = recordTime(firstLine);
+			if (!time || (from && *time < *from) || (to && *time > *to))
+				return false;
+		}
+		return text.empty() || anchor.data() == text.data() || find(record, text) != std::string_view::npos;
+	};
+
+	std::size_t found = 0;
+	const auto  scan  = [&](std::size_t begin, std::size_t end)
+	{
+		const std::string_view region = bytes.substr(begin, end - begin);
+
+		// where the record holding (or starting at) position ends: at the next line that starts one
+		const auto recordEnd = [&](std::size_t position)
+		{
+			const std::size_t next = find(region.substr(position), "\n[");
+			return next == std::string_view::npos ? region.size() : position + next + 1;
+		};
+		// where the record holding position starts: back over continuation lines to the line that starts it
+		const auto lineBegin = [&](std::size_t position)
+		{
+			const std::size_t newline = position == 0 ? std::string_view::npos : region.rfind('\n', position - 1);
+			return newline == std::string_view::npos ? 0 : newline + 1;
+		};
+		const auto recordBegin = [&](std::size_t position)
+		{
+			std::size_t line = lineBegin(position);
+			while (line > 0 && region[line] != '[')
+				line = lineBegin(line - 1);
+			return line;
+		};
+
+		std::size_t position = 0;
+		while (position < region.size() && (limit == 0 || found < limit))
+		{
+			std::size_t first = position;
+			if (!anchor.empty())
+			{
+				const std::size_t hit = find(region.substr(position), anchor);
+				if (hit == std::string_view::npos)
+					return;
+				first = std::max(recordBegin(position + hit), position);
+			}
+			const std::size_t      last   = recordEnd(first);
+			const std::string_view record = region.substr(first, last - first);
+			if (matches(record))
+			{
+				++found;
+				visit(record);
+			}
+			position = last;
+		}
+	};
+
+	// the index rules blocks out; whatever it does not cover is scanned
+	const std::vector<LogIndexEntry> entries = readIndex(log, bytes.size());
+	const auto ruledOut = [&](const LogIndexEntry& entry)
+	{
+		if ((entry.levels & levels) == 0)
+			return true;
+		if (!from && !to)
+			return false;
+		// a record without a timestamp never matches a time window, so only the stamped ones count
+		return entry.stamped == 0 || (from && entry.last < *from) || (to && entry.first > *to);
+	};
+
+	std::size_t position = entries.empty() ? bytes.size() : entries.front().offset;
+	scan(0, position);
+	for (const LogIndexEntry& entry : entries)
+	{
+		if (limit != 0 && found >= limit)
+			break;
+		if (!ruledOut(entry))
+			scan(entry.offset, entry.offset + entry.bytes);
+		position = entry.offset + entry.bytes;
+	}
+	if (limit == 0 || found < limit)
+		scan(position, bytes.size());
+	return found;
+}
@@ -0,0 +1,140 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LOG RECORD
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+
+//----------------------------
+//  INCLUDES
+//----------------------------
+
+#include <LogRecord.h>
+
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	// Idle record buffers. Records are built on the LogStream backend and usually released there too, or on the one
+	// thread a queueing sink drains them from, so the lock is all but uncontended.
+	template<class Block>
+	struct Pool
+	{
+		std::mutex          mutex;
+		std::vector<Block*> free;
+	};
+
+	template<class Block>
+	Pool<Block>& poolOf(std::size_t capacity)
+	{
+		// Intentionally leaked: a record may be released by a sink's queue during static destruction.
+		static auto& pool = *[capacity]
+		{
+			auto* created = new Pool<Block>();
+			created->free.reserve(capacity);
+			return created;
+		}();
+		return pool;
+	}
+}    // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+//  LogRecord
+//----------------------------------------------------------------------------------------------------------------------
+LogRecord::LogRecord(std::string_view text, logerr::Level level)
+    : m_block(acquire())
+{
+	m_block->level = level;
+	m_block->text.assign(text);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  LogRecord
+//----------------------------------------------------------------------------------------------------------------------
+LogRecord::LogRecord(std::string&& text, logerr::Level level)
+    : m_block(acquire())
+{
+	m_block->level = level;
+	m_block->text  = std::move(text);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  LogRecord
+//----------------------------------------------------------------------------------------------------------------------
+LogRecord::LogRecord(std::string&& text, Trace trace, logerr::Level level)
+    : LogRecord(std::move(text), level)
+{
+	m_block->trace = trace;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  LogRecord
+//----------------------------------------------------------------------------------------------------------------------
+LogRecord::LogRecord(std::uint32_t thread, logerr::Level level, Trace trace, std::string&& text)
+    : LogRecord(std::move(text), trace, level)
+{
+	m_block->thread = thread;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  acquire (private)
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief		An empty buffer with a reference count of one: a pooled one when there is one, else a new one.
+//----------------------------------------------------------------------------------------------------------------------
+LogRecord::Block* LogRecord::acquire()
+{
+	auto& pool = poolOf<Block>(poolSize);
+	{
+		const std::lock_guard lock(pool.mutex);
+		if (!pool.free.empty())
+		{
+			Block* block = pool.free.back();
+			pool.free.pop_back();
+			block->refs.store(1, std::memory_order_relaxed);
+			return block;
+		}
+	}
+	return new Block();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  release (private)
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief		Return a buffer whose last handle is gone to the pool, keeping its allocation for the next record.
+//----------------------------------------------------------------------------------------------------------------------
+void LogRecord::release(Block* block) noexcept
+{
+	auto& pool = poolOf<Block>(poolSize);
+	if (block->text.capacity() <= maxPooledCapacity && block->deferred.capacity() <= maxPooledCapacity)
+	{
+		block->thread = 0;
+		block->level  = logerr::Level::Info;
+		block->trace  = {};
+		block->text.clear();
+		block->deferred.clear();
+		const std::lock_guard lock(pool.mutex);
+		if (pool.free.size() < poolSize)
+		{
+			pool.free.push_back(block);
+			return;
+		}
+	}
+	delete block;
+}
@@ -3,9 +3,48 @@
 //------------------------------
 
 #include <LogStream.h>
+#include <deferredFormat.h>
+#include <logerrMacros.h>
+
+#include <algorithm>
+#include <cstring>
 #include <ostream>
+#include <utility>
+
+thread_local LineBuffer     LogStream::m_line;
+thread_local logerr::Level LogStream::m_lineLevel = logerr::Level::Info;
+
+namespace
+{
+	// Every LogStream gets a process-unique generation, so a thread's cached ring from an EARLIER (destroyed) stream is
+	// never mistaken for a ring of the current one.
+	std::atomic<std::uint64_t> g_nextGeneration{1};
+
+	// Producer thread ids, shared by every LogStream so that no two producers, of any stream, carry the same one.
+	std::atomic<std::uint32_t> g_nextThread{1};
 
-thread_local std::string LogStream::m_string;
+	// True on a thread that is currently inside a sink. A sink that itself writes to the captured stream must not feed
+	// its output back into the ring it is being dispatched from (and the backend can never wait on itself).
+	thread_local bool t_dispatching = false;
+
+	// A thread's ring for one LogStream. The holder is thread_local, so its destructor runs when the thread ends: it
+	// only flags the ring (never touches the stream, which may already be gone) and the backend retires it once empty.
+	template<class Producer>
+	struct ProducerSlot
+	{
+		std::uint64_t             generation = 0;
+		std::shared_ptr<Producer> producer;
+
+		ProducerSlot() = default;
+		ProducerSlot(const ProducerSlot&)            = delete;
+		ProducerSlot& operator=(const ProducerSlot&) = delete;
+		~ProducerSlot()
+		{
+			if (producer)
+				producer->exited.store(true, std::memory_order_release);
+		}
+	};
+}    // namespace
 
 //--------------------------------------------------------------------------------------------------
 //	LogStream () []
@@ -13,7 +52,10 @@ thread_local std::string LogStream::m_string;
 LogStream::LogStream(std::ostream& stream) 
 	: m_stream(stream)
 	, m_old_buf(stream.rdbuf())
+	, m_sinks(new SinkSet())
+	, m_generation(g_nextGeneration.fetch_add(1))
 {
+	m_thread = std::jthread([this](std::stop_token stop) { run(std::move(stop)); });
 	stream.rdbuf(this);
 }
 
@@ -25,7 +67,7 @@ LogStream::~LogStream() noexcept
 	// output anything that is left
 	try
 	{
-		if (!m_string.empty())
+		if (!m_line.pending().empty())
 			log();
 	}
 	catch (...)    // NOLINT(bugprone-empty-catch)
@@ -33,6 +75,12 @@ LogStream::~LogStream() noexcept
 		// A stream buffer destructor cannot propagate failures from user callbacks.
 	}
 
+	// Stop the backend. It drains every ring before it exits, so nothing accepted before this point is lost.
+	m_thread.request_stop();
+	wake();
+	if (m_thread.joinable())
+		m_thread.join();
+
 	try
 	{
 		m_stream.rdbuf(m_old_buf);
@@ -41,11 +89,16 @@ LogStream::~LogStream() noexcept
 	{
 		// std::basic_ios::rdbuf() can throw when the stream has an exception mask.
 	}
+
+	delete m_sinks.load();
 }
 
 //--------------------------------------------------------------------------------------------------
 //	overflow () []
 //--------------------------------------------------------------------------------------------------
+/// @details	The stream is shared by every thread, so it has no put area of its own: each character is staged in the
+///				calling thread's LineBuffer (an inline store into its put area) until a newline ends the record.
+//--------------------------------------------------------------------------------------------------
 std::basic_streambuf<char>::int_type LogStream::overflow(int_type v)
 {
 	if (traits_type::eq_int_type(v, traits_type::eof()))
@@ -53,7 +106,7 @@ std::basic_streambuf<char>::int_type LogStream::overflow(int_type v)
 		return traits_type::not_eof(v);
 	}
 
-	m_string += traits_type::to_char_type(v);
+	m_line.sputc(traits_type::to_char_type(v));
 
 	if (v == '\n')
 		log();
@@ -71,33 +124,416 @@ std::streamsize LogStream::xsputn(const char* p, std::streamsize n)
 		return 0;
 	}
 
-	m_string.append(p, p + n);
+	m_line.sputn(p, n);
 
-	if (m_string.back() == '\n')
+	if (p[n - 1] == '\n')
 		log();
 
 	return n;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+//  write (public)
+//----------------------------------------------------------------------------------------------------------------------
+void LogStream::write(LineBuffer& line, logerr::Level level)
+{
+	const std::string_view text = line.pending();
+	if (text.empty())
+		return;
+
+	if (m_line.pending().empty() && text.back() == '\n')
+	{
+		try
+		{
+			submit(line, level);
+		}
+		catch (...)
+		{
+			line.discard(line.pending().size());
+			throw;
+		}
+		line.discard(line.pending().size());
+		return;
+	}
+
+	const bool ends = text.back() == '\n';
+	m_line.sputn(text.data(), static_cast<std::streamsize>(text.size()));
+	line.discard(text.size());
+	if (ends)
+	{
+		m_lineLevel = level;
+		log();
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  write (public)
+//----------------------------------------------------------------------------------------------------------------------
+void LogStream::write(std::string_view entry, LogRecord::Trace trace, logerr::Level level)
+{
+	if (entry.empty())
+		return;
+
+	// finish this thread's unfinished line with it: the footer then starts that much further in
+	trace.offset += static_cast<std::uint32_t>(m_line.pending().size());
+	m_line.sputn(entry.data(), static_cast<std::streamsize>(entry.size()));
+	try
+	{
+		submit(m_line, level, trace);
+	}
+	catch (...)
+	{
+		m_line.discard(m_line.pending().size());
+		m_lineLevel = logerr::Level::Info;
+		throw;
+	}
+	m_line.discard(m_line.pending().size());
+	m_lineLevel = logerr::Level::Info;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  tagLine (public)
+//----------------------------------------------------------------------------------------------------------------------
+void LogStream::tagLine(logerr::Level level) noexcept
+{
+	m_lineLevel = level;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 //  log (protected)
 //----------------------------------------------------------------------------------------------------------------------
 void LogStream::log()
 {
-	const std::lock_guard lock(m_callbackMutex);
+	const logerr::Level level = std::exchange(m_lineLevel, logerr::Level::Info);
 	try
 	{
-		for(auto& [name, callback] : m_callbacks)
-		{
-			callback(m_string);
-		}
+		submit(m_line, level);
 	}
 	catch (...)
 	{
-		m_string.clear();
+		m_line.discard(m_line.pending().size());
 		throw;
 	}
-	m_string.clear();
+	m_line.discard(m_line.pending().size());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  submit (private)
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief		Hand one complete record to the backend through this thread's ring. Never takes a lock after the
+///				thread's first record.
+/// @details	A record too large for the ring travels as an owning pointer instead: the line's buffer is moved to
+///				the backend, never copied. Output produced from inside a sink goes straight to the original stream
+///				buffer instead. @p level travels in the record's kind word; a traced record carries @p trace ahead of
+///				its payload.
+//----------------------------------------------------------------------------------------------------------------------
+void LogStream::submit(LineBuffer& line, logerr::Level level, LogRecord::Trace trace)
+{
+	const std::string_view record = line.pending();
+	const bool             traced = trace.stack != 0;
+	const std::size_t      header = traced ? sizeof(trace) : 0;
+	if (std::byte* slot = reserveRecord(kindWord(traced ? TracedRecord : TextRecord, level), header + record.size()))
+	{
+		std::memcpy(slot, &trace, header);
+		std::memcpy(slot + header, record.data(), record.size());
+		commitRecord();
+	}
+	else if (t_dispatching || m_thread.get_id() == std::this_thread::get_id())
+	{
+		m_old_buf->sputn(record.data(), static_cast<std::streamsize>(record.size()));
+	}
+	else
+	{
+		auto         owned = std::make_unique<std::string>(line.take(record.size()));
+		std::byte*   slot  = reserveRecord(kindWord(traced ? IndirectTraced : IndirectRecord, level), header + sizeof(std::string*));
+		std::string* raw   = owned.release();
+		std::memcpy(slot, &trace, header);
+		std::memcpy(slot + header, &raw, sizeof(raw));
+		commitRecord();
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  reserveRecord (private)
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief		Open a record of @p size bytes on this thread's ring.
+/// @details	When the ring is full the producer wakes the backend and yields until there is room, so a burst is
+///				back-pressured rather than dropped.
+/// @return		where to write the payload, or nullptr when the record can never fit a ring or the caller is a sink.
+//----------------------------------------------------------------------------------------------------------------------
+std::byte* LogStream::reserveRecord(std::uint32_t kind, std::size_t size)
+{
+	if (t_dispatching || m_thread.get_id() == std::this_thread::get_id())
+		return nullptr;
+
+	LogRing& ring = producerForThisThread().ring;
+	if (size > ring.maxPayload())
+		return nullptr;
+
+	std::byte* slot = ring.reserve(kind, size);
+	while (slot == nullptr)
+	{
+		wake();
+		std::this_thread::yield();
+		slot = ring.reserve(kind, size);
+	}
+	return slot;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  commitRecord (private)
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief		Publish the record opened by the last reserveRecord() on this thread.
+//----------------------------------------------------------------------------------------------------------------------
+void LogStream::commitRecord()
+{
+	producerForThisThread().ring.commit();
+
+	// Pairs with the fence in run(): either the backend sees this record before it sleeps, or this thread sees that it
+	// is asleep and wakes it. The common case (backend busy) costs one relaxed load.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (m_idle.load(std::memory_order_relaxed))
+		wake();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  producerForThisThread (private)
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief		The calling thread's ring for this stream, created and registered with the backend on first use.
+/// @details	The thread's own slot keeps the producer alive for as long as the thread can use it.
+//----------------------------------------------------------------------------------------------------------------------
+LogStream::Producer& LogStream::producerForThisThread()
+{
+	thread_local ProducerSlot<Producer> slot;
+	if (slot.generation != m_generation || !slot.producer)
+	{
+		if (slot.producer)
+			slot.producer->exited.store(true, std::memory_order_release);
+
+		auto producer = std::make_shared<Producer>(g_nextThread.fetch_add(1, std::memory_order_relaxed));
+		{
+			const std::lock_guard lock(m_producersMutex);
+			m_producers.push_back(producer);
+		}
+		slot.producer   = std::move(producer);
+		slot.generation = m_generation;
+	}
+	return *slot.producer;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  drainOnce (private)
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief		Dispatch every record currently committed to any ring, and retire the rings of exited threads.
+/// @return		true if at least one record was dispatched.
+//----------------------------------------------------------------------------------------------------------------------
+bool LogStream::drainOnce()
+{
+	std::vector<std::shared_ptr<Producer>> producers;
+	{
+		const std::lock_guard lock(m_producersMutex);
+		producers = m_producers;
+	}
+
+	std::size_t dispatched = 0;
+	for (const auto& producer : producers)
+	{
+		const bool exited = producer->exited.load(std::memory_order_acquire);
+		dispatched += producer->ring.drain(
+		        [this, thread = producer->thread](std::uint32_t word, std::span<const std::byte> payload)
+		        {
+			        const std::uint32_t kind  = word & 0xFFu;
+			        auto                level = static_cast<logerr::Level>(word >> 8);
+
+			        LogRecord::Trace trace;
+			        if (kind == TracedRecord || kind == IndirectTraced)
+			        {
+				        std::memcpy(&trace, payload.data(), sizeof(trace));
+				        payload = payload.subspan(sizeof(trace));
+			        }
+
+			        if (kind == IndirectRecord || kind == IndirectTraced)
+			        {
+				        std::string* owned = nullptr;
+				        std::memcpy(&owned, payload.data(), sizeof(owned));
+				        const std::unique_ptr<std::string> record(owned);
+				        dispatch(LogRecord(thread, level, trace, std::move(*record)));
+			        }
+			        else if (kind == DeferredRecord)
+			        {
+				        const std::string_view encoded(reinterpret_cast<const char*>(payload.data()), payload.size());
+				        logerr::DeferredHeader header;
+				        std::memcpy(&header, payload.data(), sizeof(header));
+				        level = header.site->level;
+				        dispatch(LogRecord::build(thread, level, encoded, [&](std::string& line) { logerr::formatDeferred(payload, line); }));
+			        }
+			        else
+			        {
+				        const std::string_view text(reinterpret_cast<const char*>(payload.data()), payload.size());
+				        dispatch(LogRecord::build(thread, level, trace, [&](std::string& line) { line.assign(text); }));
+			        }
+		        });
+
+		// The exited flag was read BEFORE the drain, so a thread that finished logging and then exited has had every
+		// record it committed drained by now.
+		if (exited && producer->ring.empty())
+		{
+			const std::lock_guard lock(m_producersMutex);
+			std::erase(m_producers, producer);
+		}
+	}
+	return dispatched != 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  dispatch (private)
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief		Deliver one record to every registered sink. BACKEND THREAD ONLY.
+/// @details	Every sink receives the same handle, so the line is not copied per sink. A sink that throws does not
+///				stop the others, or the backend: the failure is published for cooperative rethrow on the main thread
+///				(LOGERR_RETHROW), exactly like a failure on a logerr::thread.
+//----------------------------------------------------------------------------------------------------------------------
+void LogStream::dispatch(const LogRecord& record)
+{
+	// Announce the snapshot before using it, then confirm it is still current: a writer that swapped it out either sees
+	// the announcement and waits for this pass to finish, or swapped before the re-check and is picked up by it.
+	const SinkSet* sinks = m_sinks.load(std::memory_order_seq_cst);
+	m_sinksInUse.store(sinks, std::memory_order_seq_cst);
+	for (const SinkSet* current = m_sinks.load(std::memory_order_seq_cst); current != sinks; current = m_sinks.load(std::memory_order_seq_cst))
+	{
+		sinks = current;
+		m_sinksInUse.store(sinks, std::memory_order_seq_cst);
+	}
+
+	t_dispatching = true;
+	for (const Sink& sink : *sinks)
+	{
+		try
+		{
+			(*sink.callback)(record);
+		}
+		catch (...)
+		{
+			logerr::captureException(std::current_exception());
+		}
+	}
+	t_dispatching = false;
+	m_sinksInUse.store(nullptr, std::memory_order_release);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  addSink (private)
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief		Publish a snapshot with @p callback added under @p name, keeping the set sorted by name.
+//----------------------------------------------------------------------------------------------------------------------
+void LogStream::addSink(std::string&& name, Callback&& callback)
+{
+	const std::lock_guard lock(m_sinksMutex);
+	const SinkSet&        current  = *m_sinks.load(std::memory_order_acquire);
+	const auto            position = std::ranges::lower_bound(current, name, {}, &Sink::name);
+	if (position != current.end() && position->name == name)
+		return;
+
+	SinkSet sinks;
+	sinks.reserve(current.size() + 1);
+	sinks.insert(sinks.end(), current.begin(), position);
+	sinks.push_back({std::move(name), std::make_shared<Callback>(std::move(callback))});
+	sinks.insert(sinks.end(), position, current.end());
+	publish(std::move(sinks));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  publish (private)
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief		Swap @p sinks in as the current snapshot and retire the old one. CALLER HOLDS m_sinksMutex.
+/// @details	The old snapshot is freed once the backend is no longer dispatching to it. From inside a sink (the
+///				backend itself, mid-dispatch) it is kept until the stream is destroyed instead.
+//----------------------------------------------------------------------------------------------------------------------
+void LogStream::publish(SinkSet&& sinks)
+{
+	std::unique_ptr<const SinkSet> old(m_sinks.exchange(new SinkSet(std::move(sinks)), std::memory_order_seq_cst));
+	if (t_dispatching)
+	{
+		m_retiredSinks.push_back(std::move(old));
+		return;
+	}
+	while (m_sinksInUse.load(std::memory_order_seq_cst) == old.get())
+		std::this_thread::yield();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  wake (private)
+//----------------------------------------------------------------------------------------------------------------------
+void LogStream::wake() noexcept
+{
+	m_idle.store(false, std::memory_order_relaxed);
+	m_wakeups.fetch_add(1, std::memory_order_seq_cst);
+	m_wakeups.notify_one();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  run (private)
+//----------------------------------------------------------------------------------------------------------------------
+/// @brief		The backend loop: drain every ring, satisfy flush() waiters, sleep when there is nothing to do.
+/// @details	After stop is requested the loop keeps draining until a full pass finds nothing, so every record
+///				committed before the destructor started is dispatched.
+//----------------------------------------------------------------------------------------------------------------------
+void LogStream::run(std::stop_token stop)
+{
+	while (true)
+	{
+		// Read the requests BEFORE the pass: every record their requester committed before asking is then visible to it.
+		// (A stop seen only after the pass may have raced a final record in behind it, so it takes one more pass.)
+		const std::uint64_t flushRequested = m_flushRequested.load(std::memory_order_seq_cst);
+		const bool          stopping       = stop.stop_requested();
+		const bool          dispatched     = drainOnce();
+
+		if (flushRequested != 0)
+		{
+			const std::lock_guard lock(m_flushMutex);
+			if (flushRequested > m_flushCompleted)
+			{
+				m_flushCompleted = flushRequested;
+				m_flushDone.notify_all();
+			}
+		}
+
+		if (dispatched)
+			continue;
+		if (stopping)
+			break;
+
+		// Announce that we are going to sleep, then look once more: a producer that committed before seeing m_idle
+		// is caught by this re-check, and one that commits after it sees m_idle and bumps m_wakeups.
+		const std::uint32_t wakeups = m_wakeups.load(std::memory_order_seq_cst);
+		m_idle.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		bool pending = m_flushRequested.load() > flushRequested || stop.stop_requested();
+		if (!pending)
+		{
+			const std::lock_guard lock(m_producersMutex);
+			for (const auto& producer : m_producers)
+				pending = pending || !producer->ring.empty();
+		}
+		if (!pending)
+			m_wakeups.wait(wakeups, std::memory_order_seq_cst);
+		m_idle.store(false, std::memory_order_relaxed);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  flush (public)
+//----------------------------------------------------------------------------------------------------------------------
+void LogStream::flush()
+{
+	if (t_dispatching || !m_thread.joinable() || m_thread.get_id() == std::this_thread::get_id())
+		return;
+
+	const std::uint64_t generation = m_flushRequested.fetch_add(1, std::memory_order_seq_cst) + 1;
+	wake();
+	std::unique_lock lock(m_flushMutex);
+	m_flushDone.wait(lock, [&] { return m_flushCompleted >= generation; });
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -105,9 +541,12 @@ void LogStream::log()
 //----------------------------------------------------------------------------------------------------------------------
 void LogStream::unregisterLogFunction(const std::string& name /*= ""*/)
 {
-	const std::lock_guard lock(m_callbackMutex);
-	if(name.empty())
-		m_callbacks.clear();
-	else
-		m_callbacks.erase(name);
+	flush();
+	const std::lock_guard lock(m_sinksMutex);
+	SinkSet sinks = *m_sinks.load(std::memory_order_acquire);
+	if (name.empty())
+		sinks.clear();
+	else if (std::erase_if(sinks, [&](const Sink& sink) { return sink.name == name; }) == 0)
+		return;
+	publish(std::move(sinks));
 }
@@ -2,6 +2,7 @@
 //	INCLUDES
 //------------------------
 #include "StackTrace.h"
+#include <atomic>
 #include <csetjmp>
 #include <csignal>
 #include <cstddef>
@@ -13,6 +14,8 @@
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <system_error>
+#include <thread>
 #include <unordered_set>
 #include <vector>
 
@@ -28,10 +31,15 @@
 #pragma warning(pop)
 #else
 #include <backtraceSymbols.h>
-#include <cxxabi.h>
 #include <execinfo.h>
 #endif    // WINDOWS
 
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace
 {
 	// Deduplication registry for deduplicateByStack. The key is a hash of the raw return-address array captured for a
@@ -47,6 +55,9 @@ namespace
 	std::mutex&                        g_tracedStacksMutex = *new std::mutex;
 	std::unordered_set<std::uint64_t>& g_tracedStacks      = *new std::unordered_set<std::uint64_t>;
 
+	// Set once prewarmSymbols() has loaded every module's symbols.
+	std::atomic<bool> g_symbolsReady{false};
+
 	// FNV-1a over the raw frame pointers. Cheap (a handful of nanoseconds over the already-captured array) and stable
 	// within a process run, so identical stacks hash identically.
 	std::uint64_t hashStack(void* const* frames, std::size_t count) noexcept
@@ -161,6 +172,15 @@ bool StackTrace::firstTimeForStack(void* const* frames, int count)
 	return g_tracedStacks.insert(hashStack(frames, static_cast<std::size_t>(count))).second;
 }
 
+//--------------------------------------------------------------------------------------------------
+//	fingerprint ( public, static )
+//--------------------------------------------------------------------------------------------------
+std::uint64_t StackTrace::fingerprint(void* const* frames, int count) noexcept
+{
+	const std::uint64_t hash = hashStack(frames, static_cast<std::size_t>(count));
+	return hash != 0 ? hash : 1;
+}
+
 //--------------------------------------------------------------------------------------------------
 //	resetDeduplication ( public, static )
 //--------------------------------------------------------------------------------------------------
@@ -245,9 +265,9 @@ StackTrace::StackTrace(unsigned int ignore /*= 0*/, bool deduplicateByStack /*=
 /// @param[in]	count	the number of addresses in @p frames.
 /// @return		The formatted, newline-terminated trace footer; empty when @p count is zero.
 /// @details	Shared by the constructor (over its own captured, post-skip frames) and the async trace-log worker (over
-///				the frames captured at the log site). Both DbgHelp and the BFD-backed symbolizer keep process-global
-///				state and are not safe to call concurrently, so access is serialized here; symbolization is otherwise
-///				identical to the historical per-frame formatting on both platforms.
+///				the frames captured at the log site). Thread-safe: DbgHelp keeps process-global state, so it is
+///				serialized here, while the BFD-backed symbolizer locks per module, so threads resolving different
+///				modules do not wait on each other.
 //--------------------------------------------------------------------------------------------------
 // The actual symbolization, per platform. Wrapped by StackTrace::formatFrames (below), which is the self-defending
 // entry point: symbolization runs in the worst conditions (a crashing or exiting process, arbitrary threads, torn-down
@@ -258,13 +278,14 @@ static std::string formatFramesImpl(void* const* frames, int count)
 	if (count <= 0)
 		return {};
 
-	// Both DbgHelp and the BFD-backed symbolizer maintain process-global state and are not safe to call concurrently.
-	// INTENTIONALLY LEAKED (never destroyed): the async trace-log worker (and late exit-time traces) can enter here after
+#ifdef WINDOWS
+	// DbgHelp keeps process-global state and is not safe to call concurrently. (The BFD-backed symbolizer locks each
+	// module it reads instead, so on POSIX the async trace-log workers symbolize in parallel.)
+	// INTENTIONALLY LEAKED (never destroyed): the async trace-log workers (and late exit-time traces) can enter here after
 	// a function-local static mutex would have been destroyed - locking a destroyed mutex is undefined. A never-freed
 	// process-lifetime mutex is valid for the whole run.
 	static std::mutex&    stackTraceMutex = *new std::mutex;
 	const std::lock_guard stackTraceLock(stackTraceMutex);
-#ifdef WINDOWS
 	const auto process = GetCurrentProcess();
 	// One-time symbol handler setup, cached ONLY on success so a transient early failure (a module list that is not yet
 	// stable during startup, a network/redirected PDB path that momentarily is not reachable) does not poison every
@@ -377,58 +398,17 @@ static std::string formatFramesImpl(void* const* frames, int count)
 		if (filename.empty())
 			filename = "??:0";
 
-		// if you see "Error: invalid pointer" here you probably need to`
-		// increase the size of FUNCTION_NAME_SIZE.
-		int   demanglerStatus = 0;
-		char* ret             = abi::__cxa_demangle(functionName.c_str(),
-                                        nullptr,
-                                        nullptr,
-                                        &demanglerStatus);
-
-		if (demanglerStatus == 0 && ret)
-		{
-			value << std::right << std::setw(5) << "["
-			      << std::right << std::dec << std::setw(count / 10 + 1) << (i)
-			      << std::left << std::setw(4) << "]"
-			      << std::left << std::setw(0) << "0x"
-			      << std::right << std::hex << std::setw(16) << std::setfill('0') << (unsigned long long) frames[i]
-			      << std::left << std::setw(0) << ": "
-			      << std::left << std::setw(filenameWidth) << std::setfill(' ') << filename
-			      << std::left << std::setw(0) << "| "
-			      << std::left << ret
-			      << '\n';
-		}
-		else if (!functionName.empty())
-		{
-			// de-mangling failed, but there is a symbol name. Output function name as a C function with
-			// no arguments.
-			value << std::right << std::setw(5) << "["
-			      << std::right << std::dec << std::setw(count / 10 + 1) << (i)
-			      << std::left << std::setw(4) << "]"
-			      << std::left << std::setw(0) << "0x"
-			      << std::right << std::hex << std::setw(16) << std::setfill('0') << (unsigned long long) frames[i]
-			      << std::left << std::setw(0) << ": "
-			      << std::left << std::setw(filenameWidth) << std::setfill(' ') << filename
-			      << std::left << std::setw(0) << "| "
-			      << std::left << functionName
-			      << '\n';
-		}
-		else
-		{
-			// No symbol name. Print the module instead
-			value << std::right << std::setw(5) << "["
-			      << std::right << std::dec << std::setw(count / 10 + 1) << (i)
-			      << std::left << std::setw(4) << "]"
-			      << std::left << std::setw(0) << "0x"
-			      << std::right << std::hex << std::setw(16) << std::setfill('0') << (unsigned long long) frames[i]
-			      << std::left << std::setw(0) << ": "
-			      << std::left << std::setw(filenameWidth) << std::setfill(' ') << filename
-			      << std::left << std::setw(0) << "| "
-			      << std::left << "<no symbol found>"
-			      << '\n';
-		}
-
-		if (ret) std::free(ret);
+		// the names come demangled, and cached with the rest of the frame (see SymbolCache.h)
+		value << std::right << std::setw(5) << "["
+		      << std::right << std::dec << std::setw(count / 10 + 1) << (i)
+		      << std::left << std::setw(4) << "]"
+		      << std::left << std::setw(0) << "0x"
+		      << std::right << std::hex << std::setw(16) << std::setfill('0') << (unsigned long long) frames[i]
+		      << std::left << std::setw(0) << ": "
+		      << std::left << std::setw(filenameWidth) << std::setfill(' ') << filename
+		      << std::left << std::setw(0) << "| "
+		      << std::left << (functionName.empty() ? "<no symbol found>" : functionName)
+		      << '\n';
 	}
 
 	return value.str();
@@ -518,3 +498,58 @@ const std::vector<void*>& StackTrace::frames() const noexcept
 {
 	return m_frames;
 }
+
+//--------------------------------------------------------------------------------------------------
+//  prewarmSymbols ( public )
+//--------------------------------------------------------------------------------------------------
+/// @details	The thread is detached and runs at a low priority, so main() and the application's own start-up never wait
+///				on it; the module cache it fills is never destroyed, so it may still be running when the process exits.
+//--------------------------------------------------------------------------------------------------
+void logerr::prewarmSymbols()
+{
+	static std::once_flag started;
+	std::call_once(started, []
+	{
+		try
+		{
+			std::thread([]
+			{
+#if defined(WINDOWS)
+				::SetThreadPriority(::GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+#elif defined(__linux__)
+				// on Linux the nice value is per thread
+				::setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)), 10);
+#endif
+				try
+				{
+#ifdef WINDOWS
+					// DbgHelp loads each module's symbols on first use; resolving this thread's own stack initializes
+					// the handler and loads the executable's and the runtime's
+					void*     frames[32];
+					const int count = StackTrace::captureFramesSafely(frames, 32);
+					static_cast<void>(StackTrace::formatFrames(frames, count));
+#else
+					prewarmSymbolTables();
+#endif
+				}
+				catch (...)
+				{
+					// a trace opens whatever was not prewarmed, as it would have without prewarming
+				}
+				g_symbolsReady.store(true, std::memory_order_release);
+			}).detach();
+		}
+		catch (const std::system_error&)
+		{
+			// no thread to spare: the first trace loads the symbols it needs, as it would have without prewarming
+		}
+	});
+}
+
+//--------------------------------------------------------------------------------------------------
+//  symbolsReady ( public )
+//--------------------------------------------------------------------------------------------------
+bool logerr::symbolsReady() noexcept
+{
+	return g_symbolsReady.load(std::memory_order_acquire);
+}
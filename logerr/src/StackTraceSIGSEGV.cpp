@@ -2,6 +2,7 @@
 //  INCLUDES
 //----------------------------
 
+#include <FlightRecorder.h>
 #include <appinfo.h>
 #include <asyncTraceLog.h>
 #include <date.h>
@@ -9,6 +10,7 @@
 #include <logerrMacros.h>
 
 // std
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 
@@ -49,6 +51,11 @@ void stackTraceSIGSEGV(int)
 	if (crashDumpFile.is_open())
 	{
 		crashDumpFile << crashDetails;
+
+		// what the log file writer and the trace worker may not get to write: the flight recorder has it
+		if (const FlightRecorder* recorder = FlightRecorder::active())
+			crashDumpFile << "\n\nRECENT LOG (last 30 seconds, from " << recorder->path() << "):\n\n"
+			              << recorder->recent(std::chrono::seconds(30));
 		crashDumpFile.flush();
 		crashDumpFile.close();
 	}
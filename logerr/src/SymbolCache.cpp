@@ -0,0 +1,155 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	SYMBOL CACHE
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+
+//----------------------------
+//  INCLUDES
+//----------------------------
+
+#include <SymbolCache.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+//  SymbolCache
+//----------------------------------------------------------------------------------------------------------------------
+SymbolCache::SymbolCache(std::size_t capacity)
+    : m_capacity(capacity)
+{
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  instance
+//----------------------------------------------------------------------------------------------------------------------
+SymbolCache& SymbolCache::instance()
+{
+	// INTENTIONALLY LEAKED, like the symbolizer's module cache: a LOGERR during exit-time teardown still symbolizes.
+	static SymbolCache& cache = *new SymbolCache;
+	return cache;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  find
+//----------------------------------------------------------------------------------------------------------------------
+std::optional<SymbolCache::Symbol> SymbolCache::find(const Key& key)
+{
+	Shard&                            shard = shardFor(key);
+	const std::lock_guard<std::mutex> lock(shard.mutex);
+	const auto                        found = shard.index.find(key);
+	if (found == shard.index.end())
+	{
+		m_misses.fetch_add(1, std::memory_order_relaxed);
+		return std::nullopt;
+	}
+	m_hits.fetch_add(1, std::memory_order_relaxed);
+	shard.order.splice(shard.order.begin(), shard.order, found->second);
+	return found->second->second;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  insert
+//----------------------------------------------------------------------------------------------------------------------
+void SymbolCache::insert(const Key& key, Symbol symbol)
+{
+	const std::size_t limit = shardCapacity();
+	if (limit == 0)
+		return;
+
+	Shard&                            shard = shardFor(key);
+	const std::lock_guard<std::mutex> lock(shard.mutex);
+	if (const auto found = shard.index.find(key); found != shard.index.end())
+	{
+		// two threads resolved the same frame at once; keep one
+		shard.order.splice(shard.order.begin(), shard.order, found->second);
+		return;
+	}
+	trim(shard, limit - 1);
+	shard.order.emplace_front(key, std::move(symbol));
+	shard.index.emplace(key, shard.order.begin());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  setCapacity
+//----------------------------------------------------------------------------------------------------------------------
+void SymbolCache::setCapacity(std::size_t capacity)
+{
+	m_capacity.store(capacity, std::memory_order_relaxed);
+	const std::size_t limit = shardCapacity();
+	for (Shard& shard : m_shards)
+	{
+		const std::lock_guard<std::mutex> lock(shard.mutex);
+		trim(shard, limit);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  clear
+//----------------------------------------------------------------------------------------------------------------------
+void SymbolCache::clear()
+{
+	for (Shard& shard : m_shards)
+	{
+		const std::lock_guard<std::mutex> lock(shard.mutex);
+		shard.index.clear();
+		shard.order.clear();
+	}
+	m_hits.store(0, std::memory_order_relaxed);
+	m_misses.store(0, std::memory_order_relaxed);
+	m_evictions.store(0, std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  stats
+//----------------------------------------------------------------------------------------------------------------------
+SymbolCache::Stats SymbolCache::stats() const
+{
+	Stats stats;
+	stats.hits      = m_hits.load(std::memory_order_relaxed);
+	stats.misses    = m_misses.load(std::memory_order_relaxed);
+	stats.evictions = m_evictions.load(std::memory_order_relaxed);
+	stats.capacity  = m_capacity.load(std::memory_order_relaxed);
+	for (const Shard& shard : m_shards)
+	{
+		const std::lock_guard<std::mutex> lock(shard.mutex);
+		stats.entries += shard.index.size();
+	}
+	return stats;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  shardCapacity
+//----------------------------------------------------------------------------------------------------------------------
+std::size_t SymbolCache::shardCapacity() const noexcept
+{
+	return (m_capacity.load(std::memory_order_relaxed) + shardCount - 1) / shardCount;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  trim
+//----------------------------------------------------------------------------------------------------------------------
+void SymbolCache::trim(Shard& shard, std::size_t limit)
+{
+	while (shard.index.size() > limit)
+	{
+		shard.index.erase(shard.order.back().first);
+		shard.order.pop_back();
+		m_evictions.fetch_add(1, std::memory_order_relaxed);
+	}
+}
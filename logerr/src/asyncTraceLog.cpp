@@ -30,19 +30,24 @@
 #include <StackTrace.h>
 #include <StackTraceException.h>
 #include <appinfo.h>
-#include <concurrent_queue.h>
+#include <BoundedQueue.h>
+#include <logSite.h>
+#include <logerrStream.h>
 #include <logerrThread.h>
 #include <timestampLite.h>
 
+#include <algorithm>
 #include <atomic>
+#include <cstdint>
 #include <condition_variable>
 #include <cstdlib>
 #include <functional>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <mutex>
-#include <sstream>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -72,15 +77,56 @@ namespace
 	};
 
 	//----------------------------------------------------------------------------------------------------------------------
-	//      FUNCTION: writeEntry [static]
+	//      FUNCTION: writeLine [static]
 	//----------------------------------------------------------------------------------------------------------------------
-	/// @brief		Symbolize one entry's frames and write the whole entry atomically to std::cout.
-	/// @param[in]	entry	the entry to symbolize and write.
-	/// @details	Runs the deduplication gate against the provided frames and formats the footer only for a first-seen
-	///				stack. The prefix + message and the footer are written under one mutex so entries stay contiguous. Used
-	///				by the background worker and, during process teardown, by the synchronous fallback in enqueueTracedError.
+	/// @brief		Write one complete, newline-terminated entry as a single unit, serialized with every other entry.
+	/// @param[in]	footer	where the entry's stack-trace footer starts, when @p stack is non-zero.
+	/// @param[in]	stack	the footer's fingerprint (LogRecord::Trace::stack); 0 for an entry without one.
 	//----------------------------------------------------------------------------------------------------------------------
-	void writeEntry(const TracedError& entry)
+	void writeLine(const std::string& line, ::logerr::Level level, std::size_t footer = 0, std::uint64_t stack = 0)
+	{
+		// INTENTIONALLY LEAKED (never destroyed): writeLine runs on the background worker AND, once teardown has begun
+		// (g_shuttingDown), on the synchronous fallback path in enqueueTracedError - a LOGERR emitted during static
+		// destruction. A function-local static mutex would already have run its destructor by then, and locking a
+		// destroyed mutex is undefined (the same teardown use-after-free class as the symbolizer statics). Held as a
+		// never-freed process-lifetime object it is valid for the whole run and cannot be used-after-free; the leak is
+		// one mutex.
+		static std::mutex&                outputMutex = *new std::mutex;
+		const std::lock_guard<std::mutex> lock(outputMutex);
+		if (stack != 0)
+		{
+			// The record carries the footer's fingerprint, so the file writer can collapse a repeated stack by it.
+			::logerr::publishTraced(line, level, footer, stack);
+			return;
+		}
+#if defined(LOGERR_USE_COUT)
+		::logerr::tagCoutLine(level);
+		std::cout << line << std::flush;
+#else
+		// The worker's own stream for the level hands the entry to the pipeline as one write (see logerrStream.h).
+		::logerr::stream(level) << line << std::flush;
+#endif
+	}
+
+	// One entry, symbolized and ready to write: the whole line (message, then footer), where its footer starts, and the
+	// footer's fingerprint. A flush() barrier carries only its callback.
+	struct FormattedEntry
+	{
+		std::string           line;
+		std::size_t           footer = 0;
+		std::uint64_t         stack  = 0;
+		std::function<void()> barrier;
+	};
+
+	//----------------------------------------------------------------------------------------------------------------------
+	//      FUNCTION: formatEntry [static]
+	//----------------------------------------------------------------------------------------------------------------------
+	/// @brief		Symbolize one entry's frames and join the footer to the message, ready for writeLine.
+	/// @param[in]	entry	the entry to symbolize.
+	/// @details	The expensive half of writing an entry, and the half the symbolizer threads run concurrently. Used by the
+	///				background workers and, during process teardown, by the synchronous fallback in enqueueTracedError.
+	//----------------------------------------------------------------------------------------------------------------------
+	FormattedEntry formatEntry(const TracedError& entry)
 	{
 		// The footer: a caller-supplied preformatted footer (an origin diagnostic relayed from another host) takes
 		// precedence and is written VERBATIM - its addresses belong to a different process/host and must not be
@@ -93,14 +139,6 @@ namespace
 		                         ? StackTrace::formatFrames(entry.frames.data(), static_cast<int>(entry.frames.size()))
 		                         : entry.preformattedFooter;
 
-		// INTENTIONALLY LEAKED (never destroyed): writeEntry runs on the background worker AND, once teardown has begun
-		// (g_shuttingDown), on the synchronous fallback path in enqueueTracedError - a LOGERR emitted during static
-		// destruction. A function-local static mutex would already have run its destructor by then, and locking a
-		// destroyed mutex is undefined (the same teardown use-after-free class as the symbolizer statics). Held as a
-		// never-freed process-lifetime object it is valid for the whole run and cannot be used-after-free; the leak is
-		// one mutex.
-		static std::mutex&                outputMutex = *new std::mutex;
-		const std::lock_guard<std::mutex> lock(outputMutex);
 		// Write the WHOLE entry as ONE string with the terminating newline LAST. A consumer that tees std::cout and
 		// dispatches a log record on each newline (e.g. the Qt log dock's LogStream) must see the message AND its trace
 		// footer as a SINGLE multi-line record - so the footer becomes the entry's expandable detail (the drop-down), not
@@ -115,44 +153,72 @@ namespace
 		// "\n" + the separator "\n" render as a spurious empty row between the error text and its stack trace.
 		while (!line.empty() && (line.back() == '\n' || line.back() == '\r'))
 			line.pop_back();
+		std::size_t footerStart = 0;
 		if (!footer.empty())
 		{
 			line += '\n';
+			footerStart = line.size();
 			line += footer;
 		}
 		// Exactly one terminal newline so the whole entry is one record ending cleanly (the tee dispatches on it).
 		while (!line.empty() && (line.back() == '\n' || line.back() == '\r'))
 			line.pop_back();
 		line += '\n';
-		std::cout << line << std::flush;
+
+		// The footer's fingerprint, for the file writer's repeated-stack collapse: the raw frames, hashed here on the
+		// worker (never on the logging thread), or the text of a relayed footer, which has no local frames.
+		std::uint64_t stack = 0;
+		if (footerStart != 0 && footerStart < line.size())
+		{
+			stack = entry.preformattedFooter.empty()
+			            ? StackTrace::fingerprint(entry.frames.data(), static_cast<int>(entry.frames.size()))
+			            : std::max<std::uint64_t>(std::hash<std::string>{}(footer), 1);
+		}
+		return {std::move(line), footerStart, stack, {}};
+	}
+
+	//----------------------------------------------------------------------------------------------------------------------
+	//      FUNCTION: writeEntry [static]
+	//----------------------------------------------------------------------------------------------------------------------
+	/// @brief		Symbolize one entry's frames and write the whole entry atomically, on the calling thread.
+	//----------------------------------------------------------------------------------------------------------------------
+	void writeEntry(const TracedError& entry)
+	{
+		const FormattedEntry formatted = formatEntry(entry);
+		writeLine(formatted.line, ::logerr::Level::Error, formatted.footer, formatted.stack);
 	}
 
-	// The process-lifetime worker. A single background thread drains the queue, symbolizes each entry's frames off the
-	// logging thread, and writes the whole entry (prefix + message, then the trace footer) as one unit under a mutex so
-	// entries never interleave. The thread is a logerr::thread (a std::jthread that catches escaping exceptions), so its
-	// stop_token is the sole exit signal: concurrent_queue::wait_pop returns queued data even after stop is requested,
-	// so requesting stop and joining drains everything accepted before shutdown.
+	// The process-lifetime worker. A small pool of background threads drains the queue and symbolizes entries off the
+	// logging thread, several at once: during an error storm of distinct stacks one slow trace no longer holds up the
+	// next. Each entry is numbered as it is taken from the queue, and an ordered output stage writes the finished
+	// entries strictly in that order, each whole entry (prefix + message, then the trace footer) as one unit, so the log
+	// reads exactly as it was enqueued and a message is never separated from its footer. The threads are logerr::threads
+	// (std::jthreads that catch escaping exceptions), so their stop_tokens are the sole exit signal:
+	// BoundedQueue::wait_pop returns queued data even after stop is requested, so requesting stop and joining drains
+	// everything accepted before shutdown.
 	class TraceLogWorker
 	{
 	public:
 		//----------------------------------------------------------------------------------------------------------------------
 		//      FUNCTION: TraceLogWorker [public]
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief		Start the background trace-log worker.
-		/// @details	The worker blocks on the queue and drains it until its stop_token is requested and the queue is
-		///				empty, symbolizing and writing each entry. The queue, its synchronization primitives, and the thread
+		/// @brief		Start the background trace-log workers.
+		/// @details	The workers block on the queue and drain it until their stop_tokens are requested and the queue is
+		///				empty, symbolizing and writing each entry. The queue, its synchronization primitives, and the threads
 		///				live behind a heap-owned Guts so a forked child can DISOWN them (abandon()) rather than destroy them.
 		//----------------------------------------------------------------------------------------------------------------------
 		TraceLogWorker()
 		    : m_guts(std::make_unique<Guts>())
 		{
-			m_guts->thread = logerr::thread([guts = m_guts.get()](std::stop_token stop) { run(guts, std::move(stop)); });
+			m_guts->threads.resize(symbolizerCount());
+			for (logerr::thread& thread : m_guts->threads)
+				thread = logerr::thread([guts = m_guts.get()](std::stop_token stop) { run(guts, std::move(stop)); });
 		}
 
 		//----------------------------------------------------------------------------------------------------------------------
 		//      FUNCTION: ~TraceLogWorker [public]
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief		Stop and join the worker, draining every remaining entry first, then destroy its queue/primitives.
+		/// @brief		Stop and join the workers, draining every remaining entry first, then destroy the queue/primitives.
 		/// @details	After the join no thread waits on the queue's condition variable, so destroying it is clean. In a
 		///				forked child abandon() has already released m_guts, so this leaks the (thread-less, phantom-waiter)
 		///				primitives instead of hanging in pthread_cond_destroy on a waiter that does not exist in the child.
@@ -161,9 +227,13 @@ namespace
 		{
 			if (!m_guts)
 				return;    // a forked child disowned the guts; nothing to join, nothing safe to destroy here
-			m_guts->thread.request_stop();
-			if (m_guts->thread.joinable())
-				m_guts->thread.join();
+			for (logerr::thread& thread : m_guts->threads)
+				thread.request_stop();
+			for (logerr::thread& thread : m_guts->threads)
+			{
+				if (thread.joinable())
+					thread.join();
+			}
 		}
 
 		TraceLogWorker(const TraceLogWorker&)            = delete;
@@ -172,11 +242,11 @@ namespace
 		//----------------------------------------------------------------------------------------------------------------------
 		//      FUNCTION: abandon [public]
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief		Disown the worker's thread, queue, and synchronization primitives, for a forked child.
-		/// @details	fork() duplicates only the calling thread, so the child inherits the worker's thread HANDLE (for a
-		///				thread that is not running there) and its condition variable with a waiter count frozen from the
+		/// @brief		Disown the worker's threads, queue, and synchronization primitives, for a forked child.
+		/// @details	fork() duplicates only the calling thread, so the child inherits the workers' thread HANDLES (for
+		///				threads that are not running there) and its condition variable with a waiter count frozen from the
 		///				parent (a waiter that also does not exist in the child). At the child's std::exit, ~TraceLogWorker
-		///				would then JOIN the absent thread AND ~concurrent_queue would call pthread_cond_destroy on a CV with a
+		///				would then JOIN the absent threads AND ~BoundedQueue would call pthread_cond_destroy on a CV with a
 		///				phantom waiter - both hang forever. Releasing (leaking) the heap-owned Guts makes ~TraceLogWorker a
 		///				no-op: the child, already diverted to the synchronous path, never touches them, and it is about to
 		///				exit anyway. Called only from the pthread_atfork child handler; never in the parent.
@@ -192,13 +262,25 @@ namespace
 		/// @brief		Hand a deferred error entry to the worker.
 		/// @param[in]	entry	the entry to symbolize and write off-thread.
 		//----------------------------------------------------------------------------------------------------------------------
-		void enqueue(TracedError entry) { m_guts->queue.push(std::move(entry)); }
+		void enqueue(TracedError entry)
+		{
+			const std::size_t bytes = entry.prefix.size() + entry.message.size() + entry.preformattedFooter.size()
+			                          + entry.frames.size() * sizeof(void*);
+			m_guts->queue.push(std::move(entry), bytes, ::logerr::Level::Error);
+		}
+
+		//----------------------------------------------------------------------------------------------------------------------
+		//      FUNCTION: setLimits [public]
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief		Bound the queue of entries waiting for symbolization (see logerr::setTracedErrorQueueLimits).
+		//----------------------------------------------------------------------------------------------------------------------
+		void setLimits(const QueueLimits& limits) { m_guts->queue.setLimits(limits); }
 
 		//----------------------------------------------------------------------------------------------------------------------
 		//      FUNCTION: flush [public]
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief		Block until the worker has drained every entry queued so far.
-		/// @details	Enqueues a barrier the worker signals once it has processed everything ahead of it, then waits on
+		/// @brief		Block until the workers have written every entry queued so far.
+		/// @details	Enqueues a barrier the output stage signals once it has written everything ahead of it, then waits on
 		///				that barrier. The worker keeps running afterward (the singleton is not torn down), so a later LOGERR
 		///				is still served asynchronously. Used by the per-statement test flush and the crash handler.
 		//----------------------------------------------------------------------------------------------------------------------
@@ -214,41 +296,108 @@ namespace
 				done = true;
 				barrierDone.notify_one();
 			};
-			m_guts->queue.push(std::move(barrierEntry));
+			m_guts->queue.pushPinned(std::move(barrierEntry));
 			std::unique_lock<std::mutex> lock(barrierMutex);
 			barrierDone.wait(lock, [&] { return done; });
 		}
 
 	private:
-		// The worker's queue, its synchronization primitives, and its thread. Heap-owned so a forked child can DISOWN the
-		// whole set (abandon()) instead of destroying it - destroying an inherited condition variable whose waiter lives
-		// only in the parent hangs in pthread_cond_destroy.
+		// The workers' queue, the ordered output stage, and the threads. Heap-owned so a forked child can DISOWN the whole
+		// set (abandon()) instead of destroying it - destroying an inherited condition variable whose waiter lives only in
+		// the parent hangs in pthread_cond_destroy.
 		struct Guts
 		{
-			concurrent_queue<TracedError> queue;
-			logerr::thread                thread;
+			BoundedQueue<TracedError> queue;
+			std::mutex                takeMutex;    ///< a pop and the number it is given are one step.
+			std::uint64_t             taken = 0;    ///< entries taken from the queue so far.
+
+			// the reorder buffer: entries finished out of order wait here for the ones numbered before them
+			std::mutex                              outputMutex;
+			std::map<std::uint64_t, FormattedEntry> finished;
+			std::uint64_t                           written = 0;        ///< the number of the next entry to write.
+			bool                                    writing = false;    ///< a worker is emptying the buffer.
+
+			std::vector<logerr::thread> threads;
 		};
 
+		//----------------------------------------------------------------------------------------------------------------------
+		//      FUNCTION: symbolizerCount [private, static]
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief		The number of symbolizer threads: one per core, at least 2 and at most 4.
+		/// @details	At least two, so a trace with a slow module never holds up the one behind it; at most four, because
+		///				frames in the same module still take turns (the BFD layer locks per module).
+		//----------------------------------------------------------------------------------------------------------------------
+		static std::size_t symbolizerCount() noexcept
+		{
+			return std::clamp<std::size_t>(std::thread::hardware_concurrency(), 2, 4);
+		}
+
 		//----------------------------------------------------------------------------------------------------------------------
 		//      FUNCTION: run [private, static]
 		//----------------------------------------------------------------------------------------------------------------------
-		/// @brief		The worker body: drain, symbolize, and write each entry until stopped and empty.
-		/// @param[in]	guts	the heap-owned queue/primitives the worker drains; outlives the loop (leaked in a forked
+		/// @brief		A worker body: take, number, and symbolize entries until stopped and empty.
+		/// @param[in]	guts	the heap-owned queue/primitives the workers drain; outlives the loop (leaked in a forked
 		///						child, joined-then-destroyed in the parent).
 		/// @param[in]	stop	the worker's stop token; requesting it drains the remaining queue then exits the loop.
 		//----------------------------------------------------------------------------------------------------------------------
 		static void run(Guts* guts, std::stop_token stop)
 		{
-			TracedError entry;
-			while (guts->queue.wait_pop(entry, stop))
+			for (;;)
 			{
+				TracedError   entry;
+				std::uint64_t number = 0;
+				{
+					// idle workers queue up here rather than on the queue; only the one holding the lock waits for an entry
+					const std::lock_guard<std::mutex> lock(guts->takeMutex);
+					if (!guts->queue.wait_pop(entry, stop))
+						return;
+					number = guts->taken++;
+				}
+
+				FormattedEntry formatted;
 				if (entry.barrier)
-					entry.barrier();    // a flush() barrier: signal the waiter, write nothing
+					formatted.barrier = std::move(entry.barrier);    // a flush() barrier: nothing to symbolize
 				else
-					writeEntry(entry);
+					formatted = formatEntry(entry);
+				write(guts, number, std::move(formatted));
 			}
 		}
 
+		//----------------------------------------------------------------------------------------------------------------------
+		//      FUNCTION: write [private, static]
+		//----------------------------------------------------------------------------------------------------------------------
+		/// @brief		The ordered output stage: hand in entry @p number, and write every entry that is now next in line.
+		/// @details	Whichever worker finds the buffer idle writes, outside the buffer's lock, until it reaches an entry
+		///				that is still being symbolized; a worker that finishes meanwhile just leaves its entry behind for it.
+		///				So entries are written one at a time and strictly in the order they were enqueued.
+		//----------------------------------------------------------------------------------------------------------------------
+		static void write(Guts* guts, std::uint64_t number, FormattedEntry formatted)
+		{
+			std::unique_lock<std::mutex> lock(guts->outputMutex);
+			guts->finished.emplace(number, std::move(formatted));
+			if (guts->writing)
+				return;
+			guts->writing = true;
+			for (auto next = guts->finished.find(guts->written); next != guts->finished.end(); next = guts->finished.find(guts->written))
+			{
+				const FormattedEntry ready = std::move(next->second);
+				guts->finished.erase(next);
+				++guts->written;
+				lock.unlock();
+
+				if (ready.barrier)
+					ready.barrier();    // a flush() barrier: signal the waiter, write nothing
+				else
+					writeLine(ready.line, ::logerr::Level::Error, ready.footer, ready.stack);
+
+				// caught up: account for any entries the queue's limits dropped in the meantime
+				if (const std::size_t dropped = guts->queue.takeDroppedIfEmpty())
+					writeLine(logerr::droppedLinesNotice(dropped, "error trace queue full"), ::logerr::Level::Warning);
+				lock.lock();
+			}
+			guts->writing = false;
+		}
+
 		std::unique_ptr<Guts> m_guts;
 	};
 
@@ -275,7 +424,7 @@ namespace
 	// the child inherits the worker object - a joinable thread HANDLE for the absent thread, and a queue condition
 	// variable whose waiter count is frozen from the parent (the waiter, the worker thread, is not there either). Three
 	// things would then hang the child: an enqueue/flush handing off to / waiting on the absent thread; the child's
-	// std::exit running ~TraceLogWorker, which JOINS that absent thread; and ~concurrent_queue calling
+	// std::exit running ~TraceLogWorker, which JOINS that absent thread; and ~BoundedQueue calling
 	// pthread_cond_destroy on a CV with a phantom waiter. This is the real path a consumer hits - a crash handler that
 	// runs after fork(), or a death test (EXPECT_EXIT/ASSERT_DEATH) that forks with the worker already spawned, then
 	// calls flushTracedErrors() or exits and never returns. The child handler fixes all three: flip g_shuttingDown so
@@ -399,9 +548,25 @@ namespace logerr
 	//----------------------------------------------------------------------------------------------------------------------
 	void logCaughtError(const StackTraceException& error)
 	{
-		std::ostringstream prefix;
-		prefix << '[' << TimestampLite() << "] [" << APPINFO::name() << "] [ERROR]    ";
-		enqueueTracedError(prefix.str(), error.errorMessage(), error.frames(), /*deduplicateByStack*/ true);
+		char        timestamp[TimestampLite::maxLength];
+		std::string prefix(1, '[');
+		prefix.append(timestamp, TimestampLite().write(timestamp));
+		prefix += levelPrefix(Level::Error);
+		enqueueTracedError(std::move(prefix), error.errorMessage(), error.frames(), /*deduplicateByStack*/ true);
+	}
+
+	//----------------------------------------------------------------------------------------------------------------------
+	//      FUNCTION: setTracedErrorQueueLimits [public]
+	//----------------------------------------------------------------------------------------------------------------------
+	/// @brief		Bound the queue of errors waiting for the worker.
+	/// @details	Starts the worker if it is not running yet. A no-op once teardown has begun.
+	//----------------------------------------------------------------------------------------------------------------------
+	void setTracedErrorQueueLimits(const QueueLimits& limits)
+	{
+		if (g_shuttingDown.load())
+			return;
+		const std::lock_guard<std::mutex> lock(g_workerMutex);
+		worker().setLimits(limits);
 	}
 
 	//----------------------------------------------------------------------------------------------------------------------
@@ -3,24 +3,41 @@
 //----------------------------
 
 #include "backtraceSymbols.h"
+#include <SymbolCache.h>
 #include <logerr>
 
 // C
 #include <bfd.h>
+#include <cerrno>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <cxxabi.h>
 #include <dlfcn.h>
 #include <execinfo.h>
+#include <fcntl.h>
 #include <link.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 // std
+#include <algorithm>
+#include <atomic>
+#include <deque>
 #include <iostream>
+#include <limits>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
 
 // NOTE: There are two different bfd interfaces, and you don't know which one you're going to have on your platform.
 // So, try to figure it out and call the right things.
@@ -63,11 +80,99 @@ public:
 	asymbol**    mSyms  = nullptr;
 };
 
+// One of a module's code sections. A return address always lies in code, so these are all a lookup searches.
+struct CodeSection
+{
+	bfd_vma   vma     = 0;
+	bfd_vma   end     = 0;
+	asection* section = nullptr;
+};
+
+// A module's functions, from its symbol table, as sorted [start, end) ranges: finding the function a frame lies in is a
+// binary search. Addresses are 32-bit offsets from the module's lowest function, and the function and source file names
+// are offsets into one pool of NUL-terminated strings, so the index of a large binary stays a few bytes per function.
+struct FunctionIndex
+{
+	static constexpr std::uint32_t none = std::numeric_limits<std::uint32_t>::max();
+
+	struct Function
+	{
+		std::uint32_t start = 0;
+		std::uint32_t end   = 0;
+		std::uint32_t name  = none;
+		std::uint32_t file  = none;    ///< the source file a local function came from, when the symbol table says.
+	};
+
+	bfd_vma               base     = 0;
+	std::vector<Function> functions;
+	std::string           names;
+	bool                  lineInfo = false;    ///< the module, or a separate debug file it links to, has DWARF.
+
+	[[nodiscard]] const Function* find(bfd_vma pc) const;
+	[[nodiscard]] const char*     name(std::uint32_t offset) const { return offset == none ? "" : names.c_str() + offset; }
+};
+
+// A parsed, symbol-table-loaded BFD for one module. Opening the file, matching the object format, and slurping the
+// symbol table is the dominant cost of symbolization - and it is identical for every address that resolves into the
+// same module. So do it ONCE per file and keep it for the process lifetime.
+struct OpenModule
+{
+	std::once_flag opened;
+	std::once_flag indexed;
+	std::mutex     lock;              ///< a bfd is not safe to use from two threads at once; held around every lookup.
+	const char*    fileName = nullptr;    ///< the cache's copy of the module's path.
+	bfd*           abfd     = nullptr;    ///< nullptr when the module could not be opened / has no usable symbols.
+	asymbol**      syms = nullptr;
+	long           symbolCount = 0;
+	unsigned int   symbolSize  = 0;    ///< bytes per entry of syms; sizeof(asymbol*) unless libbfd packed them.
+
+	std::vector<CodeSection>          code;                  ///< by address; filled when the module opens.
+	std::atomic<const FunctionIndex*> functions{nullptr};    ///< published by a background build; leaked, like the module.
+
+	[[nodiscard]] const CodeSection* sectionFor(bfd_vma pc) const;
+};
+
 static int                                              findMatchingFile(struct dl_phdr_info* info, size_t size, void* data);
-static asymbol**                                        kstSlurpSymtab(bfd* abfd, const char* fileName);
-static std::vector<std::pair<std::string, std::string>> translateAddressesBuf(bfd* abfd, bfd_vma* addr, int numAddr, asymbol** syms);
+static asymbol**                                        kstSlurpSymtab(bfd* abfd, const char* fileName, long& count, unsigned int& size);
+static std::vector<std::pair<std::string, std::string>> translateAddressesBuf(OpenModule& module, bfd_vma* addr, int numAddr);
 static std::vector<std::pair<std::string, std::string>> processFile(const char* fileName, bfd_vma* addr, int naddr);
-static void                                             findAddressInSection(bfd* abfd, asection* section, void* data);
+static void                                             collectCodeSection(bfd* abfd, asection* section, void* data);
+static void                                             buildFunctionIndex(OpenModule& module);
+static bool                                             hasLineInfo(const char* fileName);
+static void                                             indexModule(OpenModule& module);
+static void                                             queueIndexBuild(OpenModule& module);
+
+//--------------------------------------------------------------------------------------------------
+//	lockLibbfd (public ) [static ]
+//--------------------------------------------------------------------------------------------------
+// libbfd keeps process-wide state that no single bfd owns: the cache of open files a separate debug file is read through
+// (bfd_find_nearest_line opens one with bfd_openr), and bfd_error. Before binutils 2.42 nothing guards it, so every call
+// that can reach it - opening a module, looking up a line, following a debug link - is made under this one lock, while
+// SymbolCache hits and function-index lookups stay lock-free. From 2.42, bfd_thread_init hands libbfd the same mutex to
+// guard that state itself, and lookups in different modules run in parallel under their own module locks.
+// INTENTIONALLY LEAKED, like the module cache: a trace can be symbolized during static destruction.
+static std::recursive_mutex& libbfdMutex()
+{
+	static std::recursive_mutex& mutex = *new std::recursive_mutex;
+	return mutex;
+}
+
+static std::atomic_bool g_libbfdThreadSafe{false};    ///< bfd_thread_init accepted libbfdMutex().
+
+static std::unique_lock<std::recursive_mutex> lockLibbfd()
+{
+	if (g_libbfdThreadSafe.load(std::memory_order_acquire))
+		return {};
+	return std::unique_lock<std::recursive_mutex>(libbfdMutex());
+}
+
+// Format matching and the error state behind it are libbfd globals: one module file opens at a time. Leaked, like
+// libbfdMutex().
+static std::mutex& openMutex()
+{
+	static std::mutex& mutex = *new std::mutex;
+	return mutex;
+}
 
 //--------------------------------------------------------------------------------------------------
 //	findMatchingFile (public ) [static ]
@@ -98,7 +203,7 @@ int findMatchingFile(struct dl_phdr_info* info, size_t, void* data)
 //--------------------------------------------------------------------------------------------------
 //	kstSlurpSymtab (public ) [static ]
 //--------------------------------------------------------------------------------------------------
-asymbol** kstSlurpSymtab(bfd* abfd, const char* fileName)
+asymbol** kstSlurpSymtab(bfd* abfd, const char* fileName, long& count, unsigned int& size)
 {
 	if (!(bfd_get_file_flags(abfd) & HAS_SYMS))
 	{
@@ -106,8 +211,7 @@ asymbol** kstSlurpSymtab(bfd* abfd, const char* fileName)
 		return nullptr;
 	}
 
-	asymbol**    syms;
-	unsigned int size;
+	asymbol** syms;
 
 	long symcount = bfd_read_minisymbols(abfd, false, (void**) &syms, &size);
 	if (symcount == 0)
@@ -119,20 +223,40 @@ asymbol** kstSlurpSymtab(bfd* abfd, const char* fileName)
 		return nullptr;
 	}
 
+	count = symcount;
 	return syms;
 }
 
 //--------------------------------------------------------------------------------------------------
 //	translateAddressesBuf (public ) [static ]
 //--------------------------------------------------------------------------------------------------
-std::vector<std::pair<std::string, std::string>> translateAddressesBuf(bfd* abfd, bfd_vma* addr, int numAddr, asymbol** syms)
+std::vector<std::pair<std::string, std::string>> translateAddressesBuf(OpenModule& module, bfd_vma* addr, int numAddr)
 {
 	std::vector<std::pair<std::string, std::string>> addressBuffer;
 
+	const FunctionIndex* functions = module.functions.load(std::memory_order_acquire);
+
 	for (int32_t i = 0; i < numAddr; i++)
 	{
-		FileLineDesc desc(syms, addr[i]);
-		bfd_map_over_sections(abfd, findAddressInSection, (void*) &desc);
+		FileLineDesc desc(module.syms, addr[i]);
+		if (functions && !functions->lineInfo)
+		{
+			// no DWARF to read: bfd_find_nearest_line would only scan the symbol table for the enclosing function
+			if (const FunctionIndex::Function* function = functions->find(addr[i]))
+			{
+				desc.mFound        = true;
+				desc.mFunctionname = functions->name(function->name);
+				desc.mFilename     = functions->name(function->file);
+			}
+		}
+		else if (const CodeSection* section = module.sectionFor(addr[i]))
+		{
+			const auto libbfd = lockLibbfd();
+			desc.findAddressInSection(module.abfd, section->section);
+			if (desc.mFound && desc.mFunctionname.empty() && functions)
+				if (const FunctionIndex::Function* function = functions->find(addr[i]))
+					desc.mFunctionname = functions->name(function->name);
+		}
 
 		if (!desc.mFound)
 		{
@@ -163,14 +287,45 @@ std::vector<std::pair<std::string, std::string>> translateAddressesBuf(bfd* abfd
 	return addressBuffer;
 }
 
-// A parsed, symbol-table-loaded BFD for one module. Opening the file, matching the object format, and slurping the
-// symbol table is the dominant cost of symbolization - and it is identical for every address that resolves into the
-// same module. So do it ONCE per file and keep it for the process lifetime.
-struct OpenModule
+// The module's file, read with pread(2). bfd_openr would route every read through libbfd's process-wide cache of open
+// files - an unlocked LRU list before binutils 2.42 - so two modules could not be read from at the same time; an iovec
+// BFD reads its own descriptor. (A separate debug file is still opened through that cache: see lockLibbfd.)
+static void* openModuleFile(bfd*, void* fileName)
 {
-	bfd*      abfd = nullptr;    ///< nullptr when the module could not be opened / has no usable symbols.
-	asymbol** syms = nullptr;
-};
+	const int fd = ::open(static_cast<const char*>(fileName), O_RDONLY | O_CLOEXEC);
+	return fd >= 0 ? new int(fd) : nullptr;
+}
+
+static file_ptr readModuleFile(bfd*, void* stream, void* buffer, file_ptr bytes, file_ptr offset)
+{
+	const int fd   = *static_cast<int*>(stream);
+	file_ptr  done = 0;
+	while (done < bytes)
+	{
+		const ssize_t read = ::pread(fd, static_cast<char*>(buffer) + done, static_cast<size_t>(bytes - done), static_cast<off_t>(offset + done));
+		if (read < 0 && errno == EINTR)
+			continue;
+		if (read < 0)
+			return -1;
+		if (read == 0)
+			break;
+		done += read;
+	}
+	return done;
+}
+
+static int closeModuleFile(bfd*, void* stream)
+{
+	const int* fd     = static_cast<int*>(stream);
+	const int  result = ::close(*fd);
+	delete fd;
+	return result;
+}
+
+static int statModuleFile(bfd*, void* stream, struct stat* status)
+{
+	return ::fstat(*static_cast<int*>(stream), status);
+}
 
 //--------------------------------------------------------------------------------------------------
 //	openModuleCached (public ) [static ]
@@ -181,76 +336,366 @@ struct OpenModule
 // trace cost tens to hundreds of milliseconds on a large executable. The cache collapses that to one open+slurp per
 // module for the whole process. The handles are intentionally never closed - they are a small, bounded set (one per
 // loaded module) held for the lifetime of a diagnostic facility, and freeing them would only re-incur the cost.
-const OpenModule& openModuleCached(const char* fileName)
+// The cache lock is held only to find the entry; lookups then lock the module, and libbfd's shared state (see
+// lockLibbfd).
+OpenModule& openModuleCached(const char* fileName)
 {
-	// The cache and its mutex are INTENTIONALLY LEAKED (never destroyed): a stack trace can be symbolized on a
-	// background thread (the async trace-log worker) or on any thread during late/exit-time teardown, after
+	// The cache and its mutexes are INTENTIONALLY LEAKED (never destroyed): a stack trace can be symbolized on a
+	// background thread (the async trace-log workers) or on any thread during late/exit-time teardown, after
 	// function-local statics would already have run their destructors. A destroyed std::map/std::mutex touched by a
 	// still-running symbolizer is a use-after-free (observed: a SIGSEGV in _Rb_tree::find on a torn-down cache). Held as
 	// never-freed process-lifetime objects, they are valid for the entire program run and cannot be used-after-free; the
-	// leak is bounded (one map, one mutex) and is a diagnostic facility, the same rationale under which the cached BFD
-	// handles are never bfd_close'd.
+	// leak is bounded (one map, two mutexes, one entry per module) and is a diagnostic facility, the same rationale under
+	// which the cached BFD handles are never bfd_close'd.
 	static std::mutex&                        cacheMutex = *new std::mutex;
 	static std::map<std::string, OpenModule>& cache      = *new std::map<std::string, OpenModule>;
 
-	const std::lock_guard<std::mutex> lock(cacheMutex);
+	OpenModule* module = nullptr;
+	{
+		const std::lock_guard<std::mutex> lock(cacheMutex);
+		const auto entry = cache.try_emplace(fileName).first;    // map nodes never move
+		module           = &entry->second;
+		fileName         = entry->first.c_str();    // older libbfds keep the name rather than copy it
+	}
 
-	const std::string key(fileName);
-	if (const auto it = cache.find(key); it != cache.end())
-		return it->second;
+	std::call_once(module->opened, [&]
+	{
+		const std::lock_guard<std::mutex> lock(openMutex());
+		const auto                        libbfd = lockLibbfd();
+		bfd* abfd = bfd_openr_iovec(fileName, NULL, openModuleFile, const_cast<char*>(fileName), readModuleFile, closeModuleFile, statModuleFile);
+		if (!abfd)
+		{
+			LOGERR << "Error opening bfd file  " << fileName << std::endl;
+			return;
+		}
+		if (bfd_check_format(abfd, bfd_archive))
+		{
+			LOGERR << "Cannot get addresses from archive  " << fileName << std::endl;
+			bfd_close(abfd);
+			return;
+		}
+		char** matching;
+		if (!bfd_check_format_matches(abfd, bfd_object, &matching))
+		{
+			LOGERR << "Format does not match for archive  " << fileName << std::endl;
+			bfd_close(abfd);
+			return;
+		}
+		long         symbolCount = 0;
+		unsigned int symbolSize  = 0;
+		asymbol**    syms        = kstSlurpSymtab(abfd, fileName, symbolCount, symbolSize);
+		if (!syms)
+		{
+			LOGERR << "Failed to read symbol table for archive  " << fileName << std::endl;
+			bfd_close(abfd);
+			return;
+		}
 
-	OpenModule module;
-	bfd*       abfd = bfd_openr(fileName, NULL);
-	if (!abfd)
+		module->fileName    = fileName;
+		module->abfd        = abfd;
+		module->syms        = syms;
+		module->symbolCount = symbolCount;
+		module->symbolSize  = symbolSize;
+
+		// sorted once, so a lookup binary-searches the module's code rather than walking every section
+		bfd_map_over_sections(abfd, collectCodeSection, &module->code);
+		std::sort(module->code.begin(), module->code.end(), [](const CodeSection& a, const CodeSection& b) { return a.vma < b.vma; });
+
+		// the function index is built off the lookup path; the module is leaked, so the builder never outlives it
+		queueIndexBuild(*module);
+	});
+	return *module;
+}
+
+//--------------------------------------------------------------------------------------------------
+//	processFile (public ) [static ]
+//--------------------------------------------------------------------------------------------------
+std::vector<std::pair<std::string, std::string>> processFile(const char* fileName, bfd_vma* addr, int naddr)
+{
+	OpenModule& module = openModuleCached(fileName);
+	if (!module.abfd || !module.syms)
+		return {};
+
+	const std::lock_guard<std::mutex> lock(module.lock);
+	return translateAddressesBuf(module, addr, naddr);
+}
+
+//--------------------------------------------------------------------------------------------------
+//	collectCodeSection (public ) [static ]
+//--------------------------------------------------------------------------------------------------
+void collectCodeSection(bfd* abfd, asection* section, void* data)
+{
+#ifdef USE_OLD_BFD
+	if ((bfd_get_section_flags(abfd, section) & SEC_CODE) == 0)
+		return;
+	const bfd_vma       vma  = bfd_section_vma(abfd, section);
+	const bfd_size_type size = bfd_section_size(abfd, section);
+#else
+	static_cast<void>(abfd);
+	if ((bfd_section_flags(section) & SEC_CODE) == 0)
+		return;
+	const bfd_vma       vma  = bfd_section_vma(section);
+	const bfd_size_type size = bfd_section_size(section);
+#endif
+	static_cast<std::vector<CodeSection>*>(data)->push_back({vma, vma + size, section});
+}
+
+//--------------------------------------------------------------------------------------------------
+//	sectionFor (public ) []
+//--------------------------------------------------------------------------------------------------
+const CodeSection* OpenModule::sectionFor(bfd_vma pc) const
+{
+	auto after = std::upper_bound(code.begin(), code.end(), pc, [](bfd_vma address, const CodeSection& section) { return address < section.vma; });
+	if (after == code.begin() || pc >= std::prev(after)->end)
+		return nullptr;
+	return &*std::prev(after);
+}
+
+//--------------------------------------------------------------------------------------------------
+//	find (public ) []
+//--------------------------------------------------------------------------------------------------
+const FunctionIndex::Function* FunctionIndex::find(bfd_vma pc) const
+{
+	if (pc < base || pc - base > std::numeric_limits<std::uint32_t>::max())
+		return nullptr;
+	const auto offset = static_cast<std::uint32_t>(pc - base);
+	auto after = std::upper_bound(functions.begin(), functions.end(), offset, [](std::uint32_t address, const Function& function) { return address < function.start; });
+	if (after == functions.begin() || offset >= std::prev(after)->end)
+		return nullptr;
+	return &*std::prev(after);
+}
+
+//--------------------------------------------------------------------------------------------------
+//	buildFunctionIndex (public ) [static ]
+//--------------------------------------------------------------------------------------------------
+// Sort the module's function symbols into its FunctionIndex. Runs on the index builder thread (see queueIndexBuild),
+// queued when the module is opened: a large binary has hundreds of thousands of symbols, and the trace that first
+// touched the module should not wait on them. Until the index is published, lookups go to bfd_find_nearest_line as
+// before. Nothing here takes the module's lock: the symbol table and sections are read-only once it is open.
+void buildFunctionIndex(OpenModule& module)
+{
+	// libbfd hands back packed minisymbols for some object formats; ELF's are plain asymbol pointers
+	if (module.symbolSize != sizeof(asymbol*))
+		return;
+
+	auto index = std::make_unique<FunctionIndex>();
+
+	index->lineInfo = hasLineInfo(module.fileName);
+
+	struct Symbol
 	{
-		LOGERR << "Error opening bfd file  " << fileName << std::endl;
-		return cache.emplace(key, module).first->second;
+		bfd_vma     start;
+		bfd_vma     end;
+		const char* name;
+		const char* file;
+		bool        global;
+	};
+
+	// an ELF symbol table lists each file's local symbols after that file's FILE symbol, and the globals last
+	std::vector<Symbol> symbols;
+	const char*         file = nullptr;
+	for (long i = 0; i < module.symbolCount; ++i)
+	{
+		const asymbol* sym = module.syms[i];
+		if (!sym)
+			continue;
+		if (sym->flags & BSF_FILE)
+		{
+			file = bfd_asymbol_name(sym);
+			continue;
+		}
+		if (!(sym->flags & BSF_FUNCTION))
+			continue;
+		const bfd_vma      start   = bfd_asymbol_value(sym);
+		const CodeSection* section = module.sectionFor(start);
+		if (!section)
+			continue;
+		const bool global = sym->flags & (BSF_GLOBAL | BSF_WEAK);
+		symbols.push_back({start, section->end, bfd_asymbol_name(sym), global ? nullptr : file, global});
 	}
-	if (bfd_check_format(abfd, bfd_archive))
+	if (symbols.empty())
+		return;
+
+	// one function per address - the global name of an aliased one - ending where the next begins
+	std::sort(symbols.begin(), symbols.end(), [](const Symbol& a, const Symbol& b) { return a.start != b.start ? a.start < b.start : a.global > b.global; });
+	symbols.erase(std::unique(symbols.begin(), symbols.end(), [](const Symbol& a, const Symbol& b) { return a.start == b.start; }), symbols.end());
+	for (std::size_t i = 0; i + 1 < symbols.size(); ++i)
+		symbols[i].end = std::min(symbols[i].end, symbols[i + 1].start);
+
+	index->base = symbols.front().start;
+	if (symbols.back().end - index->base > std::numeric_limits<std::uint32_t>::max())
+		return;    // a module spanning more than 4 GiB keeps the section lookup alone
+
+	std::map<std::string_view, std::uint32_t> files;
+	const auto pool = [&](std::string_view text)
+	{
+		const auto offset = static_cast<std::uint32_t>(index->names.size());
+		index->names.append(text).push_back('\0');
+		return offset;
+	};
+	index->functions.reserve(symbols.size());
+	for (const Symbol& symbol : symbols)
 	{
-		LOGERR << "Cannot get addresses from archive  " << fileName << std::endl;
-		bfd_close(abfd);
-		return cache.emplace(key, module).first->second;
+		FunctionIndex::Function& function = index->functions.emplace_back();
+		function.start = static_cast<std::uint32_t>(symbol.start - index->base);
+		function.end   = static_cast<std::uint32_t>(symbol.end - index->base);
+		function.name  = pool(symbol.name);
+		if (symbol.file)
+		{
+			auto [found, added] = files.try_emplace(symbol.file, 0);
+			if (added)
+				found->second = pool(symbol.file);
+			function.file = found->second;
+		}
 	}
-	char** matching;
-	if (!bfd_check_format_matches(abfd, bfd_object, &matching))
+	index->functions.shrink_to_fit();
+	index->names.shrink_to_fit();
+
+	module.functions.store(index.release(), std::memory_order_release);
+}
+
+//--------------------------------------------------------------------------------------------------
+//	hasLineInfo (public ) [static ]
+//--------------------------------------------------------------------------------------------------
+// Whether bfd_find_nearest_line has line tables to read for the module, or would only search the symbol table again.
+// Asked of a bfd of its own rather than the module's: following a debug link checksums the whole debug file, and
+// lookups in the module must not wait on that. True when in doubt.
+bool hasLineInfo(const char* fileName)
+{
+	const std::lock_guard<std::mutex> lock(openMutex());
+	const auto                        libbfd = lockLibbfd();
+	bfd* abfd = bfd_openr_iovec(fileName, NULL, openModuleFile, const_cast<char*>(fileName), readModuleFile, closeModuleFile, statModuleFile);
+	if (!abfd)
+		return true;
+
+	bool lineInfo = true;
+	if (bfd_check_format(abfd, bfd_object))
 	{
-		LOGERR << "Format does not match for archive  " << fileName << std::endl;
-		bfd_close(abfd);
-		return cache.emplace(key, module).first->second;
+		lineInfo = bfd_get_section_by_name(abfd, ".debug_info") || bfd_get_section_by_name(abfd, ".debug_line");
+		if (!lineInfo)
+		{
+			char* debugFile = bfd_follow_gnu_debuglink(abfd, "/usr/lib/debug");
+			lineInfo        = debugFile != nullptr;
+			std::free(debugFile);
+		}
 	}
-	asymbol** syms = kstSlurpSymtab(abfd, fileName);
-	if (!syms)
+	bfd_close(abfd);
+	return lineInfo;
+}
+
+//--------------------------------------------------------------------------------------------------
+//	indexModule (public ) [static ]
+//--------------------------------------------------------------------------------------------------
+// Build the module's function index unless it is built already; a second caller waits for the first.
+void indexModule(OpenModule& module)
+{
+	std::call_once(module.indexed, buildFunctionIndex, std::ref(module));
+}
+
+//--------------------------------------------------------------------------------------------------
+//	queueIndexBuild (public ) [static ]
+//--------------------------------------------------------------------------------------------------
+// Queue the module's function index for the index builder: one thread, at a lowered priority, that builds the queued
+// indexes in turn and exits once the queue is empty; the next module opened starts it again. A trace touching a dozen
+// new modules queues a dozen builds rather than starting a dozen threads that compete with the application.
+// The queue is INTENTIONALLY LEAKED, like the module cache it points into.
+void queueIndexBuild(OpenModule& module)
+{
+	struct Queue
+	{
+		std::mutex              lock;
+		std::deque<OpenModule*> modules;
+		bool                    running = false;
+	};
+	static Queue& queue = *new Queue;
+
+	const std::lock_guard<std::mutex> lock(queue.lock);
+	queue.modules.push_back(&module);
+	if (queue.running)
+		return;
+
+	try
+	{
+		std::thread([]
+		{
+#if defined(__linux__)
+			// on Linux the nice value is per thread
+			::setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)), 10);
+#endif
+			std::unique_lock<std::mutex> lock(queue.lock);
+			while (!queue.modules.empty())
+			{
+				OpenModule& next = *queue.modules.front();
+				queue.modules.pop_front();
+				lock.unlock();
+				indexModule(next);
+				lock.lock();
+			}
+			queue.running = false;
+		}).detach();
+		queue.running = true;
+	}
+	catch (const std::system_error&)
 	{
-		LOGERR << "Failed to read symbol table for archive  " << fileName << std::endl;
-		bfd_close(abfd);
-		return cache.emplace(key, module).first->second;
+		// no thread to spare: the module is looked up through its sections alone
+		queue.modules.pop_back();
 	}
+}
 
-	module.abfd = abfd;
-	module.syms = syms;
-	return cache.emplace(key, module).first->second;
+//--------------------------------------------------------------------------------------------------
+//	listModule (public ) [static ]
+//--------------------------------------------------------------------------------------------------
+// Collect the file of every loaded module into a std::vector<std::string>, under the name a trace looks it up by.
+static int listModule(struct dl_phdr_info* info, size_t, void* data)
+{
+	auto&       modules  = *static_cast<std::vector<std::string>*>(data);
+	const char* fileName = info->dlpi_name && strlen(info->dlpi_name) ? info->dlpi_name : "/proc/self/exe";
+	// the vDSO is named but has no file behind it
+	if (fileName[0] == '/' && std::find(modules.begin(), modules.end(), fileName) == modules.end())
+		modules.emplace_back(fileName);
+	return 0;
 }
 
 //--------------------------------------------------------------------------------------------------
-//	processFile (public ) [static ]
+//	initializeBfd (public ) [static ]
 //--------------------------------------------------------------------------------------------------
-std::vector<std::pair<std::string, std::string>> processFile(const char* fileName, bfd_vma* addr, int naddr)
+// Initialize the bfd library, once: the symbolizer and prewarm threads call in concurrently.
+static void initializeBfd()
 {
-	const OpenModule& module = openModuleCached(fileName);
-	if (!module.abfd || !module.syms)
-		return {};
+	static const bool initialized = []
+	{
+		bfd_init();
+#if defined(LOGERR_HAS_BFD_THREAD_INIT)
+		const auto lock   = [](void* mutex) { static_cast<std::recursive_mutex*>(mutex)->lock(); return true; };
+		const auto unlock = [](void* mutex) { static_cast<std::recursive_mutex*>(mutex)->unlock(); return true; };
+		g_libbfdThreadSafe.store(bfd_thread_init(lock, unlock, &libbfdMutex()), std::memory_order_release);
+#endif
+		return true;
+	}();
+	static_cast<void>(initialized);
+}
 
-	return translateAddressesBuf(module.abfd, addr, naddr, module.syms);
+//--------------------------------------------------------------------------------------------------
+//	moduleKey (public ) [static ]
+//--------------------------------------------------------------------------------------------------
+// The SymbolCache's name for a loaded module: its path and load address together, so a library unloaded and another
+// mapped in its place never answers for the old one.
+static std::uint64_t moduleKey(const char* fileName, const void* base)
+{
+	return std::hash<std::string_view>{}(fileName) ^ (reinterpret_cast<std::uintptr_t>(base) * 0x9E3779B97F4A7C15ULL);
 }
 
 //--------------------------------------------------------------------------------------------------
-//	findAddressInSection (public ) [static ]
+//	demangle (public ) [static ]
 //--------------------------------------------------------------------------------------------------
-void findAddressInSection(bfd* abfd, asection* section, void* data)
+// The demangled form of a symbol name, or the name itself if it is not a mangled C++ name.
+static std::string demangle(const std::string& name)
 {
-	auto* desc = (FileLineDesc*) data;
-	return desc->findAddressInSection(abfd, section);
+	int   status    = 0;
+	char* demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+	std::string result(status == 0 && demangled ? demangled : name.c_str());
+	std::free(demangled);
+	return result;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -260,8 +705,9 @@ std::vector<std::pair<std::string, std::string>> backtraceSymbols(void* const* a
 {
 	std::vector<std::pair<std::string, std::string>> symbols;
 
-	// initialize the bfd library
-	bfd_init();
+	initializeBfd();
+
+	SymbolCache& cache = SymbolCache::instance();
 
 	uint32_t idx = numAddr;
 	for (int32_t i = 0; i < numAddr; i++)
@@ -275,19 +721,23 @@ std::vector<std::pair<std::string, std::string>> backtraceSymbols(void* const* a
 		auto addr = (bfd_vma)(addrList[idx]);
 		addr -= (bfd_vma)(match.mBase);
 
-		// lookup the symbol
-		if (match.mFile && strlen(match.mFile))
-		{
-			auto&& val = processFile(match.mFile, &addr, 1);
-			if (!val.empty())
-				symbols.insert(symbols.begin(), std::make_move_iterator(val.begin()), std::make_move_iterator(val.end()));
-		}
-		else
+		const char* fileName = match.mFile && strlen(match.mFile) ? match.mFile : "/proc/self/exe";
+
+		// most frames of most traces have been resolved before: the main loop, the dispatcher, the worker lambda
+		const SymbolCache::Key key{moduleKey(fileName, match.mBase), addr};
+		if (auto cached = cache.find(key))
 		{
-			auto&& val = processFile("/proc/self/exe", &addr, 1);
-			if (!val.empty())
-				symbols.insert(symbols.begin(), std::make_move_iterator(val.begin()), std::make_move_iterator(val.end()));
+			symbols.emplace(symbols.begin(), std::move(cached->location), std::move(cached->function));
+			continue;
 		}
+
+		// lookup the symbol
+		auto&& val = processFile(fileName, &addr, 1);
+		if (val.empty())
+			continue;
+		val.front().second = demangle(val.front().second);
+		cache.insert(key, {val.front().first, val.front().second});
+		symbols.insert(symbols.begin(), std::make_move_iterator(val.begin()), std::make_move_iterator(val.end()));
 	}
 
 	return symbols;
@@ -332,3 +782,25 @@ void FileLineDesc::findAddressInSection(bfd* abfd, asection* section)
 	if (pFilename) mFilename.assign(pFilename, strlen(pFilename));
 	if (pFunctionname) mFunctionname.assign(pFunctionname, strlen(pFunctionname));
 }
+
+//--------------------------------------------------------------------------------------------------
+//	prewarmSymbolTables (public ) []
+//--------------------------------------------------------------------------------------------------
+std::size_t prewarmSymbolTables()
+{
+	initializeBfd();
+
+	std::vector<std::string> modules;
+	dl_iterate_phdr(listModule, &modules);
+
+	std::size_t prewarmed = 0;
+	for (const std::string& fileName : modules)
+	{
+		OpenModule& module = openModuleCached(fileName.c_str());
+		if (!module.abfd || !module.syms)
+			continue;
+		indexModule(module);
+		++prewarmed;
+	}
+	return prewarmed;
+}
@@ -0,0 +1,56 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	DEFERRED FORMAT
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+
+//----------------------------
+//  INCLUDES
+//----------------------------
+
+#include <deferredFormat.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+//  formatDeferred
+//----------------------------------------------------------------------------------------------------------------------
+std::string logerr::formatDeferred(std::span<const std::byte> record)
+{
+	std::string line;
+	line.reserve(128);
+	formatDeferred(record, line);
+	return line;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  formatDeferred
+//----------------------------------------------------------------------------------------------------------------------
+void logerr::formatDeferred(std::span<const std::byte> record, std::string& line)
+{
+	DeferredHeader header{};
+	std::memcpy(&header, record.data(), sizeof(header));
+	const Site& site = *header.site;
+
+	const std::chrono::system_clock::time_point time(
+	    std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(header.timestamp)));
+
+	appendPrefix(line, site, time);
+	header.formatter(site, record.subspan(sizeof(header)), line);
+	line += '\n';
+}
@@ -0,0 +1,170 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LOG LEVEL
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+
+//----------------------------
+//  INCLUDES
+//----------------------------
+
+#include <logLevel.h>
+
+#include <array>
+#include <mutex>
+#include <string>
+
+namespace
+{
+	constexpr std::uint8_t noOverride = 0xFF;
+	constexpr std::size_t  tagSlots   = 64;    // a power of two
+
+	// One tag's override. A slot is claimed once (its name never changes again) and only its level is updated after
+	// that, so readers can probe the table without a lock.
+	struct TagSlot
+	{
+		std::atomic<const std::string*> name{nullptr};
+		std::atomic<std::uint8_t>       level{noOverride};
+	};
+
+	// Intentionally leaked, like the rest of logerr's process-lifetime state: a tagged log statement in a static
+	// destructor must never probe a destroyed table.
+	auto& tagTable = *new std::array<TagSlot, tagSlots>();
+	auto& tagMutex = *new std::mutex();    // serializes writers only
+
+	std::size_t hashOf(std::string_view tag) noexcept
+	{
+		std::uint64_t hash = 14695981039346656037ull;    // FNV-1a
+		for (const char c : tag)
+		{
+			hash ^= static_cast<unsigned char>(c);
+			hash *= 1099511628211ull;
+		}
+		return static_cast<std::size_t>(hash);
+	}
+
+	/// The slot holding @p tag, or nullptr. Lock-free.
+	TagSlot* findSlot(std::string_view tag) noexcept
+	{
+		const std::size_t start = hashOf(tag);
+		for (std::size_t probe = 0; probe < tagSlots; ++probe)
+		{
+			TagSlot&           slot = tagTable[(start + probe) & (tagSlots - 1)];
+			const std::string* name = slot.name.load(std::memory_order_acquire);
+			if (name == nullptr)
+				return nullptr;
+			if (*name == tag)
+				return &slot;
+		}
+		return nullptr;
+	}
+}    // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+//  tagEnabled
+//----------------------------------------------------------------------------------------------------------------------
+bool logerr::detail::tagEnabled(Level level, std::string_view tag) noexcept
+{
+	const std::uint8_t threshold = g_threshold.load(std::memory_order_relaxed);
+	if ((threshold & disabledBit) != 0)
+		return false;
+
+	if (const TagSlot* slot = findSlot(tag))
+	{
+		const std::uint8_t own = slot->level.load(std::memory_order_relaxed);
+		if (own != noOverride)
+			return static_cast<std::uint8_t>(level) >= own;
+	}
+	return static_cast<std::uint8_t>(level) >= threshold;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  setLevel
+//----------------------------------------------------------------------------------------------------------------------
+void logerr::setLevel(Level level) noexcept
+{
+	std::uint8_t threshold = detail::g_threshold.load(std::memory_order_relaxed);
+	while (!detail::g_threshold.compare_exchange_weak(
+	    threshold, static_cast<std::uint8_t>((threshold & detail::disabledBit) | static_cast<std::uint8_t>(level)),
+	    std::memory_order_relaxed))
+	{
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  level
+//----------------------------------------------------------------------------------------------------------------------
+logerr::Level logerr::level() noexcept
+{
+	return static_cast<Level>(detail::g_threshold.load(std::memory_order_relaxed) & ~detail::disabledBit);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  setTagLevel
+//----------------------------------------------------------------------------------------------------------------------
+bool logerr::setTagLevel(std::string_view tag, Level level)
+{
+	const std::lock_guard lock(tagMutex);
+
+	TagSlot* slot = findSlot(tag);
+	if (slot == nullptr)
+	{
+		const std::size_t start = hashOf(tag);
+		for (std::size_t probe = 0; probe < tagSlots && slot == nullptr; ++probe)
+		{
+			TagSlot& candidate = tagTable[(start + probe) & (tagSlots - 1)];
+			if (candidate.name.load(std::memory_order_relaxed) == nullptr)
+			{
+				slot = &candidate;
+				slot->name.store(new std::string(tag), std::memory_order_release);
+			}
+		}
+		if (slot == nullptr)
+			return false;
+	}
+
+	if (slot->level.exchange(static_cast<std::uint8_t>(level), std::memory_order_relaxed) == noOverride)
+		detail::g_tagOverrides.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  clearTagLevel
+//----------------------------------------------------------------------------------------------------------------------
+void logerr::clearTagLevel(std::string_view tag) noexcept
+{
+	const std::lock_guard lock(tagMutex);
+	if (TagSlot* slot = findSlot(tag))
+	{
+		if (slot->level.exchange(noOverride, std::memory_order_relaxed) != noOverride)
+			detail::g_tagOverrides.fetch_sub(1, std::memory_order_relaxed);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  setEnabled
+//----------------------------------------------------------------------------------------------------------------------
+void logerr::setEnabled(bool enabled) noexcept
+{
+	if (enabled)
+		detail::g_threshold.fetch_and(static_cast<std::uint8_t>(~detail::disabledBit), std::memory_order_relaxed);
+	else
+		detail::g_threshold.fetch_or(detail::disabledBit, std::memory_order_relaxed);
+}
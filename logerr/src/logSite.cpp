@@ -0,0 +1,157 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LOG SITE
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+
+//----------------------------
+//  INCLUDES
+//----------------------------
+
+#include <logSite.h>
+
+#include <appinfo.h>
+#include <timestampLite.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <ostream>
+
+namespace
+{
+	constexpr std::size_t locationSlots = 4096;    // a power of two
+
+	// A rendered location column, keyed by site address. A slot's key is claimed once with a CAS and its text is
+	// published after; a reader that finds the key before the text simply renders its own copy that time.
+	struct LocationSlot
+	{
+		std::atomic<const logerr::Site*> site{nullptr};
+		std::atomic<const std::string*>  text{nullptr};
+	};
+
+	// Intentionally leaked: logging from a static destructor must never probe a destroyed cache.
+	auto& locationCache = *new std::array<LocationSlot, locationSlots>();
+
+	std::string renderLocation(const logerr::Site& site)
+	{
+		std::string text;
+		text.reserve(64);
+		text += '[';
+		text += site.file;
+		text += ':';
+		text += std::to_string(site.line);
+		text += ' ';
+		text += site.function;
+		text += "]  ";
+		return text;
+	}
+}    // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+//  levelPrefix
+//----------------------------------------------------------------------------------------------------------------------
+std::string_view logerr::levelPrefix(Level level)
+{
+	// One entry per Level, built once and intentionally leaked, like the interned application name it comes from.
+	static const auto& prefixes = *[]
+	{
+		auto* table = new std::array<std::string, static_cast<std::size_t>(Level::Off) + 1>();
+		for (std::size_t index = 0; index < table->size(); ++index)
+			(*table)[index] = "] [" + APPINFO::name() + "] " + std::string(levelLabel(static_cast<Level>(index)));
+		return table;
+	}();
+	return prefixes[std::min(static_cast<std::size_t>(level), prefixes.size() - 1)];
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  appendLocation
+//----------------------------------------------------------------------------------------------------------------------
+void logerr::appendLocation(std::string& out, const Site& site)
+{
+	if (site.level != Level::Warning || site.file == nullptr)
+		return;
+
+	const std::size_t start = (reinterpret_cast<std::uintptr_t>(&site) >> 4) * 0x9E3779B97F4A7C15ull >> 20;
+	for (std::size_t probe = 0; probe < 16; ++probe)
+	{
+		LocationSlot&       slot = locationCache[(start + probe) & (locationSlots - 1)];
+		const logerr::Site* key = slot.site.load(std::memory_order_acquire);
+		if (key == &site)
+		{
+			if (const std::string* text = slot.text.load(std::memory_order_acquire))
+			{
+				out += *text;
+				return;
+			}
+			break;
+		}
+		if (key == nullptr)
+		{
+			const logerr::Site* expected = nullptr;
+			if (slot.site.compare_exchange_strong(expected, &site, std::memory_order_acq_rel))
+			{
+				auto text = std::make_unique<std::string>(renderLocation(site));
+				out += *text;
+				slot.text.store(text.release(), std::memory_order_release);
+				return;
+			}
+			if (expected == &site)
+				break;
+		}
+	}
+
+	// the cache neighbourhood is full (or the site is mid-publication): render this one uncached
+	out += renderLocation(site);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  appendPrefix
+//----------------------------------------------------------------------------------------------------------------------
+void logerr::appendPrefix(std::string& out, const Site& site, std::chrono::system_clock::time_point time)
+{
+	char timestamp[TimestampLite::maxLength];
+	out += '[';
+	out.append(timestamp, TimestampLite(time).write(timestamp));
+	if (site.tag != nullptr)
+	{
+		out += "] [";
+		out += site.tag;
+		out += "] ";
+		out += levelLabel(site.level);
+	}
+	else
+	{
+		out += levelPrefix(site.level);
+	}
+	appendLocation(out, site);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  operator<<
+//----------------------------------------------------------------------------------------------------------------------
+std::ostream& logerr::operator<<(std::ostream& os, const Prefix& prefix)
+{
+	std::string text;
+	text.reserve(128);
+	appendPrefix(text, prefix.site, std::chrono::system_clock::now());
+	return os.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
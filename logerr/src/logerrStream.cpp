@@ -0,0 +1,194 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LOGERR STREAM
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+
+//----------------------------
+//  INCLUDES
+//----------------------------
+
+#include <logerrStream.h>
+#include <LineBuffer.h>
+#include <LogStream.h>
+#include <logerrMacros.h>
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <utility>
+
+namespace
+{
+	//------------------------------------------------------------------------------------------------------------------
+	//      FUNCTION: publishLine [static]
+	//------------------------------------------------------------------------------------------------------------------
+	/// @brief		Hand everything pending in @p line, logged at @p level, to the pipeline and empty it.
+	/// @details	When a LogStream captures std::cout the text goes straight into it (LogStream::write), skipping
+	///				std::cout's sentry and its per-character path. Otherwise it is written to std::cout, flushed too
+	///				when @p flush is set, the way std::endl on std::cout would have.
+	//------------------------------------------------------------------------------------------------------------------
+	void publishLine(LineBuffer& line, logerr::Level level, bool flush)
+	{
+		const std::string_view text = line.pending();
+		if (text.empty())
+			return;
+
+		if (auto* capture = dynamic_cast<LogStream*>(std::cout.rdbuf()))
+		{
+			capture->write(line, level);
+			return;
+		}
+
+		std::cout.write(text.data(), static_cast<std::streamsize>(text.size()));
+		line.discard(text.size());
+		if (flush)
+			std::cout.flush();
+	}
+
+	/// A LineBuffer for one level's stream that publishes on std::flush / std::endl.
+	class StreamBuffer : public LineBuffer
+	{
+	public:
+		explicit StreamBuffer(logerr::Level level)
+		    : m_level(level)
+		{
+		}
+
+		[[nodiscard]] logerr::Level level() const noexcept { return m_level; }
+
+	protected:
+		int sync() override
+		{
+			publishLine(*this, m_level, true);
+			return 0;
+		}
+
+	private:
+		logerr::Level m_level;
+	};
+
+	/// One thread's stream for one level.
+	struct ThreadStream
+	{
+		explicit ThreadStream(logerr::Level level)
+		    : buffer(level)
+		{
+		}
+
+		StreamBuffer buffer;
+		std::ostream stream{&buffer};
+	};
+
+	constexpr std::size_t streamCount = static_cast<std::size_t>(logerr::Level::Error) + 1;
+
+	// The thread's streams, indexed by level. Deliberately trivially destructible: the pointers stay valid to read for
+	// the whole life of the thread, including after its thread_local destructors have run, which is when a LOGERR from
+	// static destruction (the async trace log's synchronous fallback) still reaches stream().
+	thread_local std::array<ThreadStream*, streamCount> t_streams{};
+	thread_local bool                                  t_reaped = false;
+
+	// Frees the thread's streams when it exits. Text still pending by then was never flushed and is dropped, as it would
+	// be from any unflushed stream: the LogStream it would go to keeps its own per-thread state, which may already be
+	// gone. A stream requested after this has run (during the thread's teardown) is never freed.
+	struct StreamReaper
+	{
+		~StreamReaper()
+		{
+			for (ThreadStream*& stream : t_streams)
+				delete std::exchange(stream, nullptr);
+			t_reaped = true;
+		}
+	};
+}    // namespace
+
+namespace logerr
+{
+	//----------------------------------------------------------------------------------------------------------------------
+	//      FUNCTION: stream
+	//----------------------------------------------------------------------------------------------------------------------
+	std::ostream& stream(Level level)
+	{
+		const std::size_t index   = std::min(static_cast<std::size_t>(level), streamCount - 1);
+		ThreadStream*&    current = t_streams[index];
+		if (!current)
+		{
+			if (!t_reaped)
+			{
+				thread_local StreamReaper reaper;
+				(void)reaper;
+			}
+			current = new ThreadStream(static_cast<Level>(index));
+		}
+		return current->stream;
+	}
+
+	//----------------------------------------------------------------------------------------------------------------------
+	//      FUNCTION: publish
+	//----------------------------------------------------------------------------------------------------------------------
+	void publish(Level level)
+	{
+		const std::size_t index = std::min(static_cast<std::size_t>(level), streamCount - 1);
+		if (ThreadStream* current = t_streams[index])
+			publishLine(current->buffer, current->buffer.level(), false);
+	}
+
+	//----------------------------------------------------------------------------------------------------------------------
+	//      FUNCTION: publishTraced
+	//----------------------------------------------------------------------------------------------------------------------
+	void publishTraced(std::string_view entry, Level level, std::size_t footer, std::uint64_t stack)
+	{
+		if (auto* capture = dynamic_cast<LogStream*>(std::cout.rdbuf()))
+		{
+			capture->write(entry, {.stack = stack, .offset = static_cast<std::uint32_t>(footer)}, level);
+			return;
+		}
+
+		std::cout.write(entry.data(), static_cast<std::streamsize>(entry.size()));
+		std::cout.flush();
+	}
+
+	//----------------------------------------------------------------------------------------------------------------------
+	//      FUNCTION: tagCoutLine
+	//----------------------------------------------------------------------------------------------------------------------
+	void tagCoutLine(Level level) noexcept
+	{
+		if (auto* capture = dynamic_cast<LogStream*>(std::cout.rdbuf()))
+			capture->tagLine(level);
+	}
+
+	//----------------------------------------------------------------------------------------------------------------------
+	//      Statement
+	//----------------------------------------------------------------------------------------------------------------------
+	Statement::~Statement()
+	{
+		try
+		{
+			publish(m_level);
+			m_stream.clear();    // a failed statement must not silence the rest of this thread's lines
+		}
+		catch (...)
+		{
+			// A sink threw while the statement was handed over. A destructor cannot propagate it; surface it through
+			// LOGERR_RETHROW() like any other background failure.
+			captureException(std::current_exception());
+		}
+	}
+}    // namespace logerr
@@ -4,6 +4,9 @@
 
 #include "timestampLite.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <ctime>
 #include <cwctype>
 
@@ -21,6 +24,11 @@ TimestampLite::TimestampLite()
 {
 }
 
+TimestampLite::TimestampLite(std::chrono::system_clock::time_point time)
+    : m_now(time)
+{
+}
+
 TimestampLite::operator std::time_t() const
 {
 	return std::chrono::system_clock::to_time_t(m_now);
@@ -31,56 +39,188 @@ TimestampLite::operator std::chrono::system_clock::time_point() const
 	return m_now;
 }
 
-TimestampLite::operator std::string() const
+namespace
 {
-	char          buffer[128]{};
-	const auto    now_c = static_cast<std::time_t>(*this);
-	std::tm       localTime{};
+	/// One thread's rendering of the current second: "YYYY-mm-dd HH:MM:SS" and the timezone name.
+	struct SecondCache
+	{
+		std::time_t second = 0;
+		bool        valid  = false;
+		char        prefix[19]{};
+		char        timezone[32]{};
+		std::size_t timezoneLength = 0;
+	};
+
+	/// Render @p second into @p cache. The only place that calls localtime_r / strftime.
+	bool renderSecond(SecondCache& cache, std::time_t second)
+	{
+		std::tm localTime{};
 #ifdef _WIN32
-	if (localtime_s(&localTime, &now_c) != 0)
+		if (localtime_s(&localTime, &second) != 0)
 #else
-	if (localtime_r(&now_c, &localTime) == nullptr)
+		if (localtime_r(&second, &localTime) == nullptr)
 #endif
-		return {};
-	if (std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &localTime) == 0)
-		return {};
+			return false;
+
+		char buffer[sizeof(cache.prefix) + 1]{};
+		if (std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &localTime) != sizeof(cache.prefix))
+			return false;
+		std::memcpy(cache.prefix, buffer, sizeof(cache.prefix));
+
 #if __has_include(<timezoneapi.h>)
-	// Windows + timezones is annoying
-	DYNAMIC_TIME_ZONE_INFORMATION timeZoneInformation{};
-	const auto timeZoneId = GetDynamicTimeZoneInformation(&timeZoneInformation);
-	const auto* timeZoneName = timeZoneId == TIME_ZONE_ID_DAYLIGHT ? timeZoneInformation.DaylightName
-	                                                             : timeZoneInformation.StandardName;
-	std::string timezone;
-	bool        atWordStart = true;
-	for (const auto* character = timeZoneName; *character != L'\0'; ++character)
-	{
-		if (std::iswspace(static_cast<std::wint_t>(*character)) != 0)
-			atWordStart = true;
-		else if (atWordStart)
+		// Windows + timezones is annoying
+		DYNAMIC_TIME_ZONE_INFORMATION timeZoneInformation{};
+		const auto timeZoneId = GetDynamicTimeZoneInformation(&timeZoneInformation);
+		const auto* timeZoneName = timeZoneId == TIME_ZONE_ID_DAYLIGHT ? timeZoneInformation.DaylightName
+		                                                             : timeZoneInformation.StandardName;
+		cache.timezoneLength = 0;
+		bool atWordStart     = true;
+		for (const auto* character = timeZoneName; *character != L'\0'; ++character)
 		{
-			if (*character <= 0x7f)
-				timezone.push_back(static_cast<char>(*character));
-			atWordStart = false;
+			if (std::iswspace(static_cast<std::wint_t>(*character)) != 0)
+				atWordStart = true;
+			else if (atWordStart)
+			{
+				if (*character <= 0x7f && cache.timezoneLength < sizeof(cache.timezone))
+					cache.timezone[cache.timezoneLength++] = static_cast<char>(*character);
+				atWordStart = false;
+			}
 		}
-	}
 #else
-	char timezone[32]{};
-	std::strftime(timezone, sizeof(timezone), "%Z", &localTime);
+		cache.timezoneLength = std::strftime(cache.timezone, sizeof(cache.timezone), "%Z", &localTime);
 #endif
 
-	const std::string seconds(buffer);
-	std::string nanoseconds = std::to_string(std::chrono::duration_cast<std::chrono::nanoseconds>(m_now.time_since_epoch()).count() % 1000000000);
+		cache.second = second;
+		cache.valid  = true;
+		return true;
+	}
+}    // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+//  write
+//----------------------------------------------------------------------------------------------------------------------
+std::size_t TimestampLite::write(char* buffer) const
+{
+	thread_local SecondCache cache;
+
+	const auto seconds  = std::chrono::floor<std::chrono::seconds>(m_now);
+	const auto fraction = std::chrono::duration_cast<std::chrono::nanoseconds>(m_now - seconds).count();
+	const auto second   = static_cast<std::time_t>(seconds.time_since_epoch().count());
+	if ((!cache.valid || cache.second != second) && !renderSecond(cache, second))
+		return 0;
+
+	char* out = buffer;
+	std::memcpy(out, cache.prefix, sizeof(cache.prefix));
+	out += sizeof(cache.prefix);
+	*out++ = '.';
+
+	// nine digits, leading zeros included
+	auto digits = static_cast<std::uint32_t>(fraction);
+	for (int i = 8; i >= 0; --i)
+	{
+		out[i] = static_cast<char>('0' + digits % 10);
+		digits /= 10;
+	}
+	out += 9;
+	*out++ = ' ';
+
+	std::memcpy(out, cache.timezone, cache.timezoneLength);
+	out += cache.timezoneLength;
+	return static_cast<std::size_t>(out - buffer);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+//  parse
+//----------------------------------------------------------------------------------------------------------------------
+std::optional<std::chrono::system_clock::time_point> TimestampLite::parse(std::string_view text)
+{
+	constexpr std::string_view shape = "0000-00-00 00:00:00.000000000";
+	if (text.size() < shape.size())
+		return std::nullopt;
+	for (std::size_t i = 0; i < shape.size(); ++i)
+	{
+		const bool digit = text[i] >= '0' && text[i] <= '9';
+		if (shape[i] == '0' ? !digit : text[i] != shape[i])
+			return std::nullopt;
+	}
+
+	const auto number = [text](std::size_t at, std::size_t digits)
+	{
+		int value = 0;
+		for (std::size_t i = 0; i < digits; ++i)
+			value = value * 10 + (text[at + i] - '0');
+		return value;
+	};
+
+	// the timezone name write() appends, if it is there
+	std::string_view zone;
+	if (text.size() > shape.size() + 1 && text[shape.size()] == ' ')
+	{
+		zone = text.substr(shape.size() + 1);
+		zone = zone.substr(0, std::min(zone.find_first_of(" ]\n"), zone.size()));
+	}
 
-	// have to add any leading zeros back in
-	nanoseconds = std::string(9 - nanoseconds.length(), '0') + nanoseconds;
+	struct ParsedSecond
+	{
+		char        text[19]{};
+		char        timezone[32]{};
+		std::size_t timezoneLength = 0;
+		std::time_t second         = -1;
+	};
+	thread_local ParsedSecond cache;
 
-	return seconds + '.' + nanoseconds + ' ' + timezone;
+	if (cache.second == -1 || std::memcmp(cache.text, text.data(), sizeof(cache.text)) != 0 ||
+	    zone != std::string_view(cache.timezone, cache.timezoneLength))
+	{
+		std::tm local{};
+		local.tm_year = number(0, 4) - 1900;
+		local.tm_mon  = number(5, 2) - 1;
+		local.tm_mday = number(8, 2);
+		local.tm_hour = number(11, 2);
+		local.tm_min  = number(14, 2);
+		local.tm_sec  = number(17, 2);
+
+		// Let the library pick daylight saving, then take the other reading if that is the one the name says.
+		std::tm     guess  = local;
+		guess.tm_isdst     = -1;
+		std::time_t second = std::mktime(&guess);
+		if (second == -1)
+			return std::nullopt;
+		if (!zone.empty())
+		{
+			SecondCache rendered;
+			if (renderSecond(rendered, second) && zone != std::string_view(rendered.timezone, rendered.timezoneLength))
+			{
+				std::tm other  = local;
+				other.tm_isdst = guess.tm_isdst > 0 ? 0 : 1;
+				if (const std::time_t alternative = std::mktime(&other);
+				    alternative != -1 && renderSecond(rendered, alternative) &&
+				    zone == std::string_view(rendered.timezone, rendered.timezoneLength))
+					second = alternative;
+			}
+		}
+
+		std::memcpy(cache.text, text.data(), sizeof(cache.text));
+		cache.timezoneLength = std::min(zone.size(), sizeof(cache.timezone));
+		std::memcpy(cache.timezone, zone.data(), cache.timezoneLength);
+		cache.second = second;
+	}
+	return std::chrono::system_clock::from_time_t(cache.second) +
+	       std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(number(20, 9)));
 }
+
+TimestampLite::operator std::string() const
+{
+	char buffer[maxLength];
+	return std::string(buffer, write(buffer));
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 //  operator<<
 //----------------------------------------------------------------------------------------------------------------------
 std::ostream& operator<<(std::ostream& os, const TimestampLite& timestamp)
 {
-	os << static_cast<std::string>(timestamp);
+	char buffer[TimestampLite::maxLength];
+	os.write(buffer, static_cast<std::streamsize>(timestamp.write(buffer)));
 	return os;
 }
@@ -45,6 +45,7 @@
 //	INCLUDES
 //-------------------------
 
+#include <LogRecord.h>
 #include <QEventThread.h>
 
 #include <deque>
@@ -97,6 +98,9 @@ public:
 	virtual void appendRow(const QString& value);
 	virtual void appendRow(const std::string& value);
 
+	/// Queue a record for parsing. The parser thread shares the record's text; nothing is copied until it is parsed.
+	void queueLogRecord(LogRecord record);
+
 public slots:
 
 	void   queueLogEntry(std::string string);
@@ -104,7 +108,7 @@ public slots:
 	void   setScrollbackBufferSize(size_t size);
 
 private:
-	QStringList parse(const std::string& value) const;
+	QStringList parse(const LogRecord& value) const;
 	void        appendRows();
 
 protected:
@@ -116,7 +120,7 @@ protected:
 
 	QTimer* m_updateTimer;
 	// Declared last: joins before parser state is destroyed.
-	QEventThread<std::string, QStringList> m_parserThread;
+	QEventThread<LogRecord, QStringList> m_parserThread;
 };
 
 #endif    // LogModel_h_
@@ -45,6 +45,7 @@
 //	INCLUDES
 //-------------------------
 
+#include <LogRecord.h>
 #include <concurrent_queue.h>
 #include <string>
 
@@ -79,6 +80,9 @@ public:
 	LogDock();
 	~LogDock() override;
 
+	/// Queue a record for display, sharing its text with the other sinks.
+	void queueLogRecord(LogRecord record) const;
+
 public slots:
 
 	void queueLogEntry(std::string str) const;
@@ -54,8 +54,10 @@
 #include <QTimer>
 
 #include <Application.h>
+#include <FlightRecorder.h>
 #include <LogFileWriter.h>
 #include <LogStream.h>
+#include <StackTrace.h>
 #include <StackTraceException.h>
 #include <StackTraceSIGSEGVQt.h>
 #include <appinfo.h>
@@ -135,6 +137,7 @@ namespace logerr
 	int code          = 0;                                                                                                      \
 	g_mainThreadID    = std::this_thread::get_id();                                                                             \
 	g_mainThreadIDSet = true;                                                                                                   \
+	LOGERR_START_SYMBOL_PREWARM();                                                                                              \
                                                                                                                                 \
 	Application app(argc, argv);                                                                                                \
 	app.setOrganizationName(QAPPINFO::organization());                                                                          \
@@ -142,14 +145,16 @@ namespace logerr
 	app.setApplicationName(QAPPINFO::name());                                                                                   \
 	app.setApplicationVersion(QAPPINFO::version());                                                                             \
                                                                                                                                 \
-	LogFileWriter logFileWriter;                                                                                                \
+	LogFileWriter  logFileWriter;                                                                                               \
+	FlightRecorder flightRecorder;                                                                                              \
 	logerr::setLiveLogFilePath(logFileWriter.filePath());                                                                       \
-	LogDock*      logDock = new LogDock;                                                                                        \
-	LogReceiver   logReceiver;                                                                                                  \
-	LogStream     logStream(std::cout);                                                                                         \
+	LogDock*       logDock = new LogDock;                                                                                       \
+	LogReceiver    logReceiver;                                                                                                 \
+	LogStream      logStream(std::cout);                                                                                        \
                                                                                                                                 \
-	logStream.registerLogFunction("logFileWriter", [&logFileWriter](std::string str) { logFileWriter.write(std::move(str)); }); \
-	logStream.registerLogFunction("logDock", [&logDock](std::string str) { logDock->queueLogEntry(std::move(str)); });          \
+	logStream.registerLogFunction("logFileWriter", [&logFileWriter](const LogRecord& record) { logFileWriter.write(record); }); \
+	logStream.registerLogFunction("flightRecorder", [&flightRecorder](const LogRecord& line) { flightRecorder.record(line); }); \
+	logStream.registerLogFunction("logDock", [&logDock](const LogRecord& record) { logDock->queueLogRecord(record); });         \
                                                                                                                                 \
 	QObject::connect(&logReceiver, &LogReceiver::readyRead, logDock, &LogDock::queueLogEntry);                                  \
                                                                                                                                 \
@@ -186,7 +191,7 @@ namespace logerr
 		code = 2;                                                                     \
 	}                                                                                 \
                                                                                       \
-	if (code == 0) LOGINFO << APPINFO::name() << " Exited Successfully" << std::endl; \
+	if (code == 0) { LOGINFO << APPINFO::name() << " Exited Successfully" << std::endl; } \
                                                                                       \
 	return code;
 #endif
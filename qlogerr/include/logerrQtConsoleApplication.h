@@ -50,6 +50,7 @@
 #include <string_view>
 #include <thread>
 
+#include <FlightRecorder.h>
 #include <LogFileWriter.h>
 #include <LogStream.h>
 #include <StackTraceException.h>
@@ -78,11 +79,13 @@
 	g_mainThreadID    = std::this_thread::get_id();                                                                             \
 	g_mainThreadIDSet = true;                                                                                                   \
                                                                                                                                 \
-	LogFileWriter logFileWriter;                                                                                                \
-	LogBlaster    logBlaster;                                                                                                   \
-	LogStream     logStream(std::cout);                                                                                         \
+	LogFileWriter  logFileWriter;                                                                                               \
+	FlightRecorder flightRecorder;                                                                                              \
+	LogBlaster     logBlaster;                                                                                                  \
+	LogStream      logStream(std::cout);                                                                                        \
                                                                                                                                 \
-	logStream.registerLogFunction("logFileWriter", [&logFileWriter](std::string str) { logFileWriter.write(std::move(str)); }); \
+	logStream.registerLogFunction("logFileWriter", [&logFileWriter](const LogRecord& record) { logFileWriter.write(record); }); \
+	logStream.registerLogFunction("flightRecorder", [&flightRecorder](const LogRecord& line) { flightRecorder.record(line); }); \
 	logStream.registerLogFunction("logBlaster", [&logBlaster](std::string str) { logBlaster.blast(std::move(str)); });          \
                                                                                                                                 \
 	LOGINFO << APPINFO::name() << ' ' << APPINFO::version() << " Started." << std::endl;                                        \
@@ -129,7 +132,7 @@
 		code = 4;                                                                                   \
 	}                                                                                               \
                                                                                                     \
-	if (code == 0) LOGINFO << APPINFO::name() << " Exited Successfully" << std::endl;               \
+	if (code == 0) { LOGINFO << APPINFO::name() << " Exited Successfully" << std::endl; }           \
                                                                                                     \
 	return code;
 #endif
@@ -283,7 +283,15 @@ void LogModel::appendRow(const std::string& value)
 //--------------------------------------------------------------------------------------------------
 void LogModel::queueLogEntry(std::string string)
 {
-	m_parserThread.enqueue(std::move(string));
+	queueLogRecord(LogRecord(std::move(string)));
+}
+
+//--------------------------------------------------------------------------------------------------
+//	queueLogRecord (public ) []
+//--------------------------------------------------------------------------------------------------
+void LogModel::queueLogRecord(LogRecord record)
+{
+	m_parserThread.enqueue(std::move(record));
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -316,9 +324,9 @@ void LogModel::setScrollbackBufferSize(size_t size)
 //--------------------------------------------------------------------------------------------------
 //	parse (private ) []
 //--------------------------------------------------------------------------------------------------
-QStringList LogModel::parse(const std::string& str) const
+QStringList LogModel::parse(const LogRecord& record) const
 {
-	const QString value = QString::fromStdString(str);
+	const QString value = QString::fromUtf8(record.data(), static_cast<qsizetype>(record.size()));
 
 	// don't put whitespace lines into the model
 	if (value.trimmed().isEmpty())
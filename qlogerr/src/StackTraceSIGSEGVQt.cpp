@@ -3,6 +3,7 @@
 //----------------------------
 
 #include <ExceptionDialog.h>
+#include <FlightRecorder.h>
 #include <QApplication>
 #include <QDateTime>
 #include <QDir>
@@ -44,6 +45,14 @@ void stackTraceSIGSEGVQt(int)
 	if (QFile crashDumpFile(QAPPINFO::crashDumpDir() + '/' + crashdumpFileName); crashDumpFile.open(QIODevice::WriteOnly))
 	{
 		crashDumpFile.write(sDetails.toLocal8Bit());
+
+		// what the log file writer and the trace worker may not get to write: the flight recorder has it
+		if (const FlightRecorder* recorder = FlightRecorder::active())
+		{
+			const std::string recent = "\n\nRECENT LOG (last 30 seconds, from " + recorder->path() + "):\n\n" +
+			                           recorder->recent(std::chrono::seconds(30));
+			crashDumpFile.write(recent.data(), static_cast<qint64>(recent.size()));
+		}
 		crashDumpFile.close();
 	}
 
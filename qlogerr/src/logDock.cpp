@@ -239,6 +239,14 @@ void LogDock::queueLogEntry(std::string str) const
 	m_logModel->queueLogEntry(std::move(str));
 }
 
+//--------------------------------------------------------------------------------------------------
+//	queueLogRecord (public ) []
+//--------------------------------------------------------------------------------------------------
+void LogDock::queueLogRecord(LogRecord record) const
+{
+	m_logModel->queueLogRecord(std::move(record));
+}
+
 //--------------------------------------------------------------------------------------------------
 //	on_scrollbackBufferSize_changed (private ) []
 //--------------------------------------------------------------------------------------------------
@@ -1,10 +1,15 @@
 #define _CONCURRENT_QUEUE_NO_WARNINGS
 
+#include <FlightRecorder.h>
+#include <LogBinary.h>
+#include <LogBlocks.h>
 #include <LogFileWriter.h>
+#include <LogIndex.h>
 #include <LogStream.h>
 #include <StackTrace.h>
 #include <StackTraceException.h>
 #include <StackTraceSIGSEGV.h>
+#include <SymbolCache.h>
 #include <appinfo.h>
 #include <asyncTraceLog.h>
 #include <concurrent_queue.h>
@@ -20,10 +25,12 @@
 #include <barrier>
 #include <chrono>
 #include <cstdint>
+#include <ctime>
 #include <filesystem>
 #include <fstream>
 #include <future>
 #include <iterator>
+#include <map>
 #include <optional>
 #include <sstream>
 #include <string>
@@ -39,7 +46,12 @@ namespace
 	{
 	protected:
 		void SetUp() override { static_cast<void>(logerr::takeException()); }
-		void TearDown() override { static_cast<void>(logerr::takeException()); }
+		void TearDown() override
+		{
+			static_cast<void>(logerr::takeException());
+			logerr::setLevel(logerr::Level::Debug);
+			logerr::setEnabled(true);
+		}
 
 		static std::filesystem::path uniquePath(std::string_view suffix)
 		{
@@ -99,6 +111,12 @@ namespace
 		int value;
 	};
 
+	struct Streamable
+	{
+		int value;
+		friend std::ostream& operator<<(std::ostream& os, const Streamable& streamable) { return os << 'S' << streamable.value; }
+	};
+
 	class LogStreamProbe : public LogStream
 	{
 	public:
@@ -106,6 +124,67 @@ namespace
 		using LogStream::overflow;
 		using LogStream::xsputn;
 	};
+
+	// A LogFileWriter output that behaves like a hung disk: every write blocks until release(). What reaches it is kept
+	// in memory for the test to inspect.
+	class SlowDisk
+	{
+	public:
+		LogFileWriter::Options options(QueueLimits limits)
+		{
+			LogFileWriter::Options options;
+			options.queueLimits = limits;
+			options.openOutput  = [this](const std::string&) { return std::make_unique<Device>(*this); };
+			return options;
+		}
+
+		/// Block until the writer is stuck inside a write.
+		void waitUntilStalled()
+		{
+			std::unique_lock lock(m_mutex);
+			m_changed.wait(lock, [this] { return m_stalled; });
+		}
+
+		void release()
+		{
+			const std::lock_guard lock(m_mutex);
+			m_released = true;
+			m_changed.notify_all();
+		}
+
+		std::string contents()
+		{
+			const std::lock_guard lock(m_mutex);
+			return m_written;
+		}
+
+	private:
+		class Device : public LogFileWriter::Output
+		{
+		public:
+			explicit Device(SlowDisk& disk) : m_disk(disk) {}
+			bool isOpen() const noexcept override { return true; }
+			bool sync() noexcept override { return true; }
+			bool write(std::string_view batch) noexcept override
+			{
+				std::unique_lock lock(m_disk.m_mutex);
+				m_disk.m_stalled = true;
+				m_disk.m_changed.notify_all();
+				m_disk.m_changed.wait(lock, [this] { return m_disk.m_released; });
+				m_disk.m_written += batch;
+				return true;
+			}
+
+		private:
+			SlowDisk& m_disk;
+		};
+
+		std::mutex              m_mutex;
+		std::condition_variable m_changed;
+		bool                    m_stalled  = false;
+		bool                    m_released = false;
+		std::string             m_written;
+	};
 }
 
 TEST_F(LogerrCoreFixture, ConcurrentQueueConstructorsAssignmentsAndOrdering)
@@ -278,6 +357,277 @@ TEST_F(LogerrCoreFixture, LogStreamDestructorContainsCallbackFailuresAndRestores
 	EXPECT_EQ(stream.str(), "restored");
 }
 
+TEST_F(LogerrCoreFixture, LogStreamDeliversEveryThreadsLinesInOrderThroughItsRing)
+{
+	std::ostringstream stream;
+	constexpr int producerCount = 4;
+	constexpr int linesPerProducer = 500;
+	std::vector<std::vector<int>> received(producerCount);
+	{
+		LogStream logger(stream);
+		logger.registerLogFunction("collector", [&](std::string text) {
+			const auto colon = text.find(':');
+			received[std::stoul(text.substr(0, colon))].push_back(std::stoi(text.substr(colon + 1)));
+		});
+
+		std::vector<std::jthread> producers;
+		for (int producer = 0; producer < producerCount; ++producer)
+		{
+			producers.emplace_back([&, producer] {
+				for (int line = 0; line < linesPerProducer; ++line)
+					stream << std::to_string(producer) + ':' + std::to_string(line) + '\n';
+			});
+		}
+		producers.clear();
+
+		// a line larger than any ring travels out of band, in order with the rest
+		stream << "0:" + std::string(LogRing::defaultCapacity, ' ') + std::to_string(linesPerProducer) + '\n';
+		logger.flush();
+		EXPECT_EQ(received[0].size(), static_cast<std::size_t>(linesPerProducer + 1));
+	}
+
+	for (const auto& lines : received)
+	{
+		ASSERT_GE(lines.size(), static_cast<std::size_t>(linesPerProducer));
+		for (int line = 0; line < linesPerProducer; ++line)
+			EXPECT_EQ(lines[line], line);
+	}
+}
+
+TEST_F(LogerrCoreFixture, LogStreamContainsSinkFailuresAndReentrantSinkOutput)
+{
+	std::ostringstream stream;
+	std::vector<std::string> delivered;
+	{
+		LogStream logger(stream);
+		logger.registerLogFunction("a-throwing", [](const std::string&) { throw std::runtime_error("sink failure"); });
+		logger.registerLogFunction("b-echo", [&](std::string text) {
+			stream << "echo " << text;
+			logger.flush();
+			delivered.push_back(std::move(text));
+		});
+		stream << "line\n";
+		logger.flush();
+	}
+
+	EXPECT_EQ(delivered, (std::vector<std::string>{"line\n"}));
+	EXPECT_EQ(stream.str(), "echo line\n");
+	auto failure = logerr::takeException();
+	ASSERT_NE(failure, nullptr);
+	EXPECT_THROW(std::rethrow_exception(failure), std::runtime_error);
+}
+
+TEST_F(LogerrCoreFixture, LogStreamSharesOneRecordAcrossSinksWithoutCopying)
+{
+	const std::string large = std::string(100'000, 'x') + '\n';    // too large for a ring: travels indirectly
+	std::ostringstream stream;
+	std::vector<LogRecord> first;
+	std::vector<LogRecord> second;
+	std::vector<const char*> viewed;
+	std::vector<std::string> copied;
+	{
+		LogStream logger(stream);
+		logger.registerLogFunction("first", [&](const LogRecord& record) { first.push_back(record); });
+		logger.registerLogFunction("second", [&](const LogRecord& record) { second.push_back(record); });
+		logger.registerLogFunction("view", [&](std::string_view text) { viewed.push_back(text.data()); });
+		logger.registerLogFunction("copy", [&](std::string text) { copied.push_back(std::move(text)); });
+		stream << "small\n" << large;
+		logger.flush();
+	}
+
+	ASSERT_EQ(first.size(), 2u);
+	ASSERT_EQ(second.size(), 2u);
+	ASSERT_EQ(viewed.size(), 2u);
+	for (std::size_t i = 0; i < first.size(); ++i)
+	{
+		EXPECT_EQ(first[i].data(), second[i].data());
+		EXPECT_EQ(first[i].data(), viewed[i]);
+		EXPECT_EQ(first[i].useCount(), 2u);
+	}
+	EXPECT_EQ(first[0].view(), "small\n");
+	EXPECT_EQ(first[1].view(), large);
+	EXPECT_NE(first[0].thread(), 0u);
+	EXPECT_EQ(first[1].thread(), first[0].thread()) << "a record that travels indirectly is stamped with its thread too";
+	EXPECT_EQ(copied, (std::vector<std::string>{"small\n", large}));
+	EXPECT_EQ(stream.str(), "");
+
+	const auto path = uniquePath(".log");
+	{
+		LogFileWriter writer(path.string());
+		writer.write(first[0]);
+		writer.write(LogRecord("adopted\n"));
+	}
+	std::ifstream input(path);
+	EXPECT_EQ(std::string(std::istreambuf_iterator<char>(input), {}), "small\nadopted\n");
+	input.close();
+	std::error_code ignored;
+	std::filesystem::remove(path, ignored);
+}
+
+TEST_F(LogerrCoreFixture, LogRecordsCarryTheLevelTheirStatementWasLoggedAt)
+{
+	std::ostringstream captured;
+	auto* const        originalBuffer = std::cout.rdbuf(captured.rdbuf());
+	std::vector<std::pair<logerr::Level, std::string>> records;
+	{
+		LogStream logger(std::cout);
+		logger.registerLogFunction("levels", [&](const LogRecord& record) { records.emplace_back(record.level(), record.view()); });
+		LOGINFO << "info" << ENDL;
+		LOGWARNING << "warning " << std::string(100'000, 'w') << ENDL;    // too large for a ring: travels indirectly
+		LOGWARNING_FMT("deferred {}", 1);
+		LOGERR << "error" << ENDL;
+		logerr::flushTracedErrors();
+		std::cout << "[ts] [app] [ERROR]    raw output is INFO whatever it says\n";
+		logger.flush();
+	}
+	std::cout.rdbuf(originalBuffer);
+
+	const auto levelOf = [&](std::string_view text)
+	{
+		const auto found = std::ranges::find_if(records, [&](const auto& record) { return record.second.find(text) != std::string::npos; });
+		return found != records.end() ? std::optional(found->first) : std::nullopt;
+	};
+	EXPECT_EQ(levelOf("info"), logerr::Level::Info);
+	EXPECT_EQ(levelOf("warning "), logerr::Level::Warning);
+	EXPECT_EQ(levelOf("deferred 1"), logerr::Level::Warning);
+	EXPECT_EQ(levelOf("error"), logerr::Level::Error);
+	EXPECT_EQ(levelOf("raw output"), logerr::Level::Info);
+}
+
+TEST_F(LogerrCoreFixture, LogStreamSinksCanChangeWhileLinesAreDispatched)
+{
+	std::ostringstream stream;
+	std::atomic<int> steady{0};
+	int produced = 0;
+	std::vector<std::string> late;
+	{
+		LogStream logger(stream);
+		logger.registerLogFunction("steady", [&](std::string_view) { ++steady; });
+
+		// a sink may change the sink set itself; the change applies from the next record on
+		logger.registerLogFunction("installer", [&](const LogRecord& record) {
+			if (record.view() == "install\n")
+				logger.registerLogFunction("late", [&](std::string text) { late.push_back(std::move(text)); });
+		});
+
+		std::jthread producer([&](std::stop_token stop) {
+			while (!stop.stop_requested())
+			{
+				stream << "tick\n";
+				++produced;
+			}
+		});
+
+		// a removed sink's state may be destroyed as soon as unregisterLogFunction returns
+		for (int i = 0; i < 50; ++i)
+		{
+			auto state = std::make_unique<int>(0);
+			logger.registerLogFunction("transient", [counter = state.get()](std::string_view) { ++*counter; });
+			std::this_thread::yield();
+			logger.unregisterLogFunction("transient");
+			state.reset();
+		}
+		producer.request_stop();
+		producer.join();
+
+		stream << "install\n" << "after\n";
+		logger.flush();
+	}
+
+	EXPECT_EQ(steady.load(), produced + 2);    // the steady sink saw every line throughout
+	EXPECT_EQ(late, (std::vector<std::string>{"after\n"}));
+	EXPECT_EQ(stream.str(), "");
+}
+
+TEST_F(LogerrCoreFixture, LineBufferStagesWritesInAGrowingPutArea)
+{
+	struct CountingBuffer : LineBuffer
+	{
+		using LineBuffer::LineBuffer;
+		int overflows = 0;
+
+		int_type overflow(int_type v) override
+		{
+			++overflows;
+			return LineBuffer::overflow(v);
+		}
+	};
+
+	CountingBuffer buffer(16);
+	std::ostream   os(&buffer);
+	for (int i = 0; i < 1000; ++i)
+		os << static_cast<char>('a' + i % 26);
+	os << std::string(5000, '-') << '\n';
+
+	EXPECT_LE(buffer.overflows, 8);    // geometric growth: single characters almost never leave the put area
+	ASSERT_EQ(buffer.pending().size(), 6001u);
+	EXPECT_EQ(buffer.pending().substr(0, 3), "abc");
+
+	buffer.discard(1000);
+	EXPECT_EQ(buffer.pending(), std::string(5000, '-') + '\n');
+	EXPECT_EQ(buffer.take(2), "--");
+	const char* staged = buffer.pending().data();
+	const std::string rest = buffer.take(buffer.pending().size());
+	EXPECT_EQ(rest.data(), staged);    // taking everything hands the buffer over
+	EXPECT_EQ(rest, std::string(4998, '-') + '\n');
+	EXPECT_TRUE(buffer.pending().empty());
+	os << "next";
+	EXPECT_EQ(buffer.pending(), "next");
+}
+
+TEST_F(LogerrCoreFixture, LogMacrosStreamThroughThePerThreadStreamNotCout)
+{
+	std::vector<std::string> records;
+	{
+		LogStream logger(std::cout);
+		logger.registerLogFunction("collect", [&](std::string text) { records.push_back(std::move(text)); });
+
+		// std::cout's formatting state belongs to whoever else writes to it; the statements never see it
+		std::cout << std::hex;
+		LOGINFO << 255 << '\n';
+		std::cout << std::dec;
+
+		// a statement that does not end its line joins whatever this thread writes next
+		LOGWARNING << "one, ";
+		std::cout << "two\n";
+
+		std::ostream& direct = logerr::stream(logerr::Level::Debug);
+		EXPECT_EQ(&direct, &logerr::stream(logerr::Level::Debug));
+		direct << "raw" << std::flush;
+		direct << '\n' << std::flush;
+
+		std::ostream* other = nullptr;
+		std::thread([&] { other = &logerr::stream(logerr::Level::Debug); }).join();
+		EXPECT_NE(other, &direct);
+		logger.flush();
+	}
+
+	ASSERT_EQ(records.size(), 3u);
+	EXPECT_TRUE(records[0].ends_with("[INFO]     255\n")) << records[0];
+	EXPECT_TRUE(records[1].ends_with("]  one, two\n")) << records[1];
+	EXPECT_EQ(records[2], "raw\n");
+}
+
+TEST_F(LogerrCoreFixture, TextLeftUnflushedWhenAThreadExitsIsDropped)
+{
+	std::vector<std::string> records;
+	{
+		LogStream logger(std::cout);
+		logger.registerLogFunction("collect", [&](std::string text) { records.push_back(std::move(text)); });
+
+		std::thread([] {
+			logerr::stream(logerr::Level::Info) << "flushed\n" << std::flush;
+			logerr::stream(logerr::Level::Info) << "never flushed";
+		}).join();
+		std::thread([] { logerr::stream(logerr::Level::Info) << "next thread\n" << std::flush; }).join();
+		logger.flush();
+	}
+
+	ASSERT_EQ(records.size(), 2u);
+	EXPECT_EQ(records[0], "flushed\n");
+	EXPECT_EQ(records[1], "next thread\n");
+}
+
 TEST_F(LogerrCoreFixture, LogFileWriterDrainsConcurrentProducersBeforeDestruction)
 {
 	const auto path = uniquePath(".log");
@@ -304,6 +654,727 @@ TEST_F(LogerrCoreFixture, LogFileWriterDrainsConcurrentProducersBeforeDestructio
 	std::filesystem::remove(path, ignored);
 }
 
+TEST_F(LogerrCoreFixture, LogFileWriterGroupCommitsInOrderUnderEveryDurabilityPolicy)
+{
+	using Durability = LogFileWriter::Durability;
+	for (const Durability durability : {Durability::None, Durability::Flush, Durability::SyncBatch, Durability::SyncOnError, Durability::ByLevel})
+	{
+		const auto path = uniquePath(".log");
+		constexpr int lineCount = 5000;
+		std::string expected;
+		{
+			// small batches with a time threshold, so a run spans many group commits of varying size
+			LogFileWriter writer(path.string(), {.batchBytes = 4096, .flushInterval = std::chrono::milliseconds(1), .durability = durability});
+			for (int line = 0; line < lineCount; ++line)
+			{
+				const bool  error = line % 1000 == 0;
+				std::string text  = (error ? "[ERROR]    line " : "line ") + std::to_string(line) + '\n';
+				expected += text;
+				writer.write(std::move(text), error ? logerr::Level::Error : logerr::Level::Info);
+			}
+		}
+
+		std::ifstream input(path);
+		EXPECT_EQ(std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()), expected)
+		    << "durability " << static_cast<int>(durability);
+		std::error_code ignored;
+		std::filesystem::remove(path, ignored);
+	}
+}
+
+TEST_F(LogerrCoreFixture, ErrorsAreSyncedAtOnceWhileLowerLevelsWaitForTheLazyCommit)
+{
+	// an output that keeps what was written, and how much of it had been synced
+	struct Disk
+	{
+		std::mutex  mutex;
+		std::string written;
+		std::size_t synced = 0;
+		int         syncs  = 0;
+	};
+	class Device : public LogFileWriter::Output
+	{
+	public:
+		explicit Device(Disk& disk) : m_disk(disk) {}
+		bool isOpen() const noexcept override { return true; }
+		bool write(std::string_view batch) noexcept override
+		{
+			const std::lock_guard lock(m_disk.mutex);
+			m_disk.written += batch;
+			return true;
+		}
+		bool sync() noexcept override
+		{
+			const std::lock_guard lock(m_disk.mutex);
+			m_disk.synced = m_disk.written.size();
+			++m_disk.syncs;
+			return true;
+		}
+
+	private:
+		Disk& m_disk;
+	};
+
+	Disk disk;
+	const auto contents = [&disk]
+	{
+		const std::lock_guard lock(disk.mutex);
+		return std::pair(disk.written, disk.synced);
+	};
+	const auto waitFor = [&](std::size_t bytes)
+	{
+		for (int wait = 0; wait < 500 && contents().first.size() < bytes; ++wait)
+			std::this_thread::sleep_for(10ms);
+	};
+
+	LogFileWriter::Options options;
+	options.durability         = LogFileWriter::Durability::ByLevel;
+	options.lazyCommitInterval = std::chrono::hours(1);
+	options.openOutput         = [&disk](const std::string&) { return std::make_unique<Device>(disk); };
+	// the level is the one each record was logged at: an INFO line quoting an error label is still INFO
+	std::string expected = "[INFO]     one: [ERROR]    quoted\n[DEBUG]    two\n[WARNING]  three\n";
+	{
+		LogFileWriter writer(uniquePath(".log").string(), options);
+		writer.write(std::string("[INFO]     one: [ERROR]    quoted\n"), logerr::Level::Info);
+		writer.write(std::string("[DEBUG]    two\n"), logerr::Level::Debug);
+		writer.write(std::string("[WARNING]  three\n"), logerr::Level::Warning);
+		std::this_thread::sleep_for(50ms);
+		EXPECT_EQ(contents().first, "");    // below ERROR: held for the lazy commit
+
+		// the error goes out at once, synced, with everything queued ahead of it
+		expected += "[ERROR]    four\n";
+		writer.write(std::string("[ERROR]    four\n"), logerr::Level::Error);
+		waitFor(expected.size());
+		EXPECT_EQ(contents(), std::pair(expected, expected.size()));
+
+		writer.write(std::string("[INFO]     five\n"), logerr::Level::Info);
+		std::this_thread::sleep_for(50ms);
+		EXPECT_EQ(contents().first, expected);
+		expected += "[INFO]     five\n";
+	}
+	EXPECT_EQ(contents(), std::pair(expected, expected.size() - std::strlen("[INFO]     five\n")));    // written on close, not synced
+	EXPECT_EQ(disk.syncs, 1);
+
+	// with a short interval, lower levels are written (not synced) once it passes
+	disk.written.clear();
+	disk.synced                = 0;
+	disk.syncs                 = 0;
+	options.lazyCommitInterval = 20ms;
+	{
+		LogFileWriter writer(uniquePath(".log").string(), options);
+		writer.write(std::string("[INFO]     lazy\n"));
+		waitFor(1);
+		EXPECT_EQ(contents(), std::pair(std::string("[INFO]     lazy\n"), std::size_t{0}));
+	}
+	EXPECT_EQ(disk.syncs, 0);
+
+	// a record logged at ERROR is synced at once whatever its text says
+	disk.written.clear();
+	disk.synced                = 0;
+	options.lazyCommitInterval = std::chrono::hours(1);
+	{
+		LogFileWriter writer(uniquePath(".log").string(), options);
+		writer.write(std::string("no label\n"), logerr::Level::Error);
+		waitFor(1);
+		EXPECT_EQ(contents(), std::pair(std::string("no label\n"), std::string("no label\n").size()));
+	}
+	EXPECT_EQ(disk.syncs, 1);
+}
+
+#ifndef _WIN32
+TEST_F(LogerrCoreFixture, MappedLogFileSpansExtentsAndRecoversFromACrashedWriter)
+{
+	const auto path = uniquePath(".log");
+
+	// what a crashed mapped writer leaves behind: its lines, then the rest of its preallocated extent, still NUL
+	std::string expected = "before the crash\n";
+	{
+		std::ofstream crashed(path, std::ios::binary);
+		crashed << expected << std::string(10000, '\0');
+	}
+
+	LogFileWriter::Options options;
+	options.backend            = LogFileWriter::Backend::Mapped;
+	options.mappedExtentBytes  = 4096;    // small extents, so the run crosses many windows
+	options.mappedSyncInterval = 1ms;
+	options.durability         = LogFileWriter::Durability::SyncOnError;
+	{
+		LogFileWriter writer(path.string(), options);
+		for (int line = 0; line < 2000; ++line)
+		{
+			const bool  error = line % 500 == 0;
+			std::string text  = (error ? "[ERROR]    line " : "line ") + std::to_string(line) + '\n';
+			expected += text;
+			writer.write(std::move(text), error ? logerr::Level::Error : logerr::Level::Info);
+		}
+	}
+
+	EXPECT_EQ(std::filesystem::file_size(path), expected.size());    // truncated to the true length on close
+	std::ifstream input(path, std::ios::binary);
+	EXPECT_EQ(std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()), expected);
+	std::error_code ignored;
+	std::filesystem::remove(path, ignored);
+}
+#endif
+
+TEST_F(LogerrCoreFixture, UringLogFileKeepsBatchesInOrderOrFallsBackToAppend)
+{
+	const auto path = uniquePath(".log");
+	std::string expected = "already there\n";
+	{
+		std::ofstream existing(path, std::ios::binary);
+		existing << expected;
+	}
+
+	// tiny batches, each synced, so writes and linked syncs are in flight together and buffers get recycled; where
+	// the ring is unavailable the writer appends instead, and the file must come out the same
+	LogFileWriter::Options options;
+	options.backend    = LogFileWriter::Backend::Uring;
+	options.batchBytes = 256;
+	options.durability = LogFileWriter::Durability::SyncBatch;
+	{
+		LogFileWriter writer(path.string(), options);
+		for (int line = 0; line < 3000; ++line)
+		{
+			std::string text = "line " + std::to_string(line) + '\n';
+			expected += text;
+			writer.write(std::move(text));
+		}
+	}
+
+	std::ifstream input(path, std::ios::binary);
+	EXPECT_EQ(std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()), expected);
+	input.close();
+	std::error_code ignored;
+	std::filesystem::remove(path, ignored);
+}
+
+TEST_F(LogerrCoreFixture, UringLogFileSyncsOnlyOnceEveryWriteOfTheBatchHasCompleted)
+{
+	// batches several buffers long, each synced: when writeAndSync returns, every byte of the batch and of the ones
+	// before it is already in the file, so the sync it waited for covered them
+	class Checked : public LogFileWriter::Output
+	{
+	public:
+		Checked(std::unique_ptr<LogFileWriter::Output> file, std::filesystem::path path, std::uint64_t& incomplete)
+		    : m_file(std::move(file))
+		    , m_path(std::move(path))
+		    , m_incomplete(incomplete)
+		{
+			std::error_code ignored;
+			m_written = std::filesystem::file_size(m_path, ignored);
+		}
+
+		[[nodiscard]] bool isOpen() const noexcept override { return m_file->isOpen(); }
+		bool write(std::string_view batch) noexcept override
+		{
+			m_written += batch.size();
+			return m_file->write(batch);
+		}
+		bool sync() noexcept override { return m_file->sync(); }
+		bool writeAndSync(std::string_view batch) noexcept override
+		{
+			m_written += batch.size();
+			const bool ok = m_file->writeAndSync(batch);
+			std::error_code ignored;
+			if (ok && std::filesystem::file_size(m_path, ignored) != m_written)
+				++m_incomplete;
+			return ok;
+		}
+
+	private:
+		std::unique_ptr<LogFileWriter::Output> m_file;
+		std::filesystem::path                  m_path;
+		std::uint64_t&                         m_incomplete;
+		std::uint64_t                          m_written = 0;
+	};
+
+	const auto    path       = uniquePath(".log");
+	std::uint64_t incomplete = 0;
+	std::string   expected;
+
+	LogFileWriter::Options options;
+	options.backend    = LogFileWriter::Backend::Uring;
+	options.batchBytes = 4096;    // the ring's buffer size; a batch holding a long line spans several
+	options.durability = LogFileWriter::Durability::SyncBatch;
+	options.openOutput = [&](const std::string& outputPath)
+	{
+		LogFileWriter::Options file = options;
+		file.openOutput             = nullptr;
+		return std::make_unique<Checked>(LogFileWriter::openFile(outputPath, file), outputPath, incomplete);
+	};
+	{
+		LogFileWriter writer(path.string(), options);
+		for (int line = 0; line < 20000; ++line)
+		{
+			std::string text = "line " + std::to_string(line) + ' ' + std::string(line % 100 == 0 ? 10000 : 40, 'x') + '\n';
+			expected += text;
+			writer.write(std::move(text));
+		}
+	}
+
+	EXPECT_EQ(incomplete, 0u) << "a sync returned before the writes it covers had completed";
+	std::ifstream input(path, std::ios::binary);
+	EXPECT_EQ(std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()), expected);
+	input.close();
+	std::error_code ignored;
+	std::filesystem::remove(path, ignored);
+}
+
+TEST_F(LogerrCoreFixture, RotatingLogFileKeepsItsNewestSegmentsInOrder)
+{
+	const auto directory = uniquePath("-rotation");
+	ASSERT_TRUE(std::filesystem::create_directories(directory));
+	const auto first = directory / "service.log";
+	{
+		std::ofstream otherService(directory / "other.log");    // not in the series: retention leaves it alone
+		otherService << "other\n";
+	}
+
+	LogFileWriter::Options options;
+	options.batchBytes  = 256;
+	options.rotateBytes = 1000;
+	options.compression = Compression::None;
+	options.retention   = {.maxFiles = 3};
+	std::string written;
+	{
+		LogFileWriter writer(first.string(), options);
+		EXPECT_EQ(writer.filePath(), first.string());
+		for (int line = 0; line < 2000; ++line)
+		{
+			std::string text = "line " + std::to_string(line) + '\n';
+			written += text;
+			writer.write(std::move(text));
+			if (line % 50 == 49)
+				std::this_thread::sleep_for(2ms);    // let the worker commit smaller batches than the whole run
+		}
+		for (int wait = 0; wait < 500 && writer.filePath() == first.string(); ++wait)
+			std::this_thread::sleep_for(10ms);
+		EXPECT_NE(writer.filePath(), first.string());    // the current segment, not the first
+	}
+
+	// the live segment and the three before it survive, and together they end the log
+	std::map<int, std::string> segments;
+	for (const auto& entry : std::filesystem::directory_iterator(directory))
+	{
+		const std::string name = entry.path().filename().string();
+		if (name == "other.log")
+			continue;
+		ASSERT_TRUE(name.starts_with("service.") && name.ends_with(".log")) << name;
+		std::ifstream input(entry.path(), std::ios::binary);
+		segments[name == "service.log" ? 0 : std::stoi(name.substr(8))] = std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+	}
+	ASSERT_EQ(segments.size(), 4u);
+	EXPECT_EQ(segments.rbegin()->first - segments.begin()->first, 3);
+	std::string tail;
+	for (const auto& [index, contents] : segments)
+	{
+		EXPECT_TRUE(contents.starts_with("line ")) << index;    // rotation falls between batches, never inside a line
+		tail += contents;
+	}
+	EXPECT_TRUE(written.ends_with(tail));
+	EXPECT_TRUE(std::filesystem::exists(directory / "other.log"));
+
+	// a closed segment is compressed in the background, when this build has a compressor
+	const auto plain = directory / "plain.log";
+	{
+		std::ofstream output(plain);
+		output << tail;
+	}
+	const Compression compression = LogArchiver::available(Compression::Gzip);
+	const auto        archived    = LogArchiver::compress(plain, compression);
+	if (compression == Compression::None)
+	{
+		EXPECT_EQ(archived, plain);
+	}
+	else
+	{
+		EXPECT_EQ(archived.string(), plain.string() + ".gz");
+		EXPECT_FALSE(std::filesystem::exists(plain));
+		std::ifstream input(archived, std::ios::binary);
+		EXPECT_EQ(input.get(), 0x1f);    // the gzip magic
+		EXPECT_EQ(input.get(), 0x8b);
+	}
+
+	std::error_code ignored;
+	std::filesystem::remove_all(directory, ignored);
+}
+
+TEST_F(LogerrCoreFixture, RetentionNeverDeletesALiveSegment)
+{
+	// the first retention pass runs while the writer has its (oldest) file open, and another instance is writing a
+	// segment of the same series; neither may go, however far over the limit the series is
+	const auto directory = uniquePath("-retention");
+	ASSERT_TRUE(std::filesystem::create_directories(directory));
+	const auto live  = directory / "app.log.txt";
+	const auto other = directory / "app.3.log.txt";
+	const auto now   = std::filesystem::file_time_type::clock::now();
+	int        age   = 5;
+	for (const auto& path : {live, other, directory / "app.1.log.txt", directory / "app.2.log.txt"})
+	{
+		{
+			std::ofstream output(path);
+			output << "earlier\n";
+		}
+		std::filesystem::last_write_time(path, now - std::chrono::hours(--age));
+	}
+	const LogArchiver::SegmentLock otherWriter(other);
+
+	LogFileWriter::Options options;
+	options.compression = Compression::None;
+	options.retention   = {.maxFiles = 1};
+	{
+		LogFileWriter writer(live.string(), options);
+		writer.write(std::string("[ERROR]    kept\n"), logerr::Level::Error);
+	}
+
+	std::ifstream input(live, std::ios::binary);
+	EXPECT_EQ(std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()), "earlier\n[ERROR]    kept\n");
+	input.close();
+#if !defined(_WIN32)
+	EXPECT_TRUE(std::filesystem::exists(other));
+#endif
+	EXPECT_FALSE(std::filesystem::exists(directory / "app.1.log.txt"));    // the oldest closed segment
+	EXPECT_TRUE(std::filesystem::exists(directory / "app.2.log.txt"));
+
+	std::error_code ignored;
+	std::filesystem::remove_all(directory, ignored);
+}
+
+TEST_F(LogerrCoreFixture, BlockLogReadsBackATimeWindowAndSurvivesReopeningAndATornFooter)
+{
+	const auto path  = uniquePath(".logz");
+	const auto start = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now()) - 1h;
+	const auto record = [&](int second)
+	{
+		std::string text = '[' + std::string(TimestampLite(start + std::chrono::seconds(second))) + "] [INFO]     record " +
+		                   std::to_string(second) + '\n';
+		if (second % 100 == 0)
+			text += "    [0  ]   0x" + std::to_string(second) + ": file.cpp:1 | frame\n";    // travels with its record
+		return text;
+	};
+	const auto writeRecords = [&](int first, int last)
+	{
+		LogFileWriter::Options options;
+		options.format     = LogFileWriter::Format::Blocks;
+		options.blockBytes = 4096;
+		options.batchBytes = 1024;
+		std::string text;
+		{
+			LogFileWriter writer(path.string(), options);
+			for (int second = first; second < last; ++second)
+			{
+				text += record(second);
+				writer.write(record(second));
+			}
+		}
+		return text;
+	};
+
+	std::string expected = writeRecords(0, 3000);
+	expected += writeRecords(3000, 3010);    // reopened: the footer is replaced, the blocks continue
+
+	LogBlockReader reader(path);
+	ASSERT_TRUE(reader.isOpen());
+	ASSERT_GT(reader.blocks().size(), 10u);
+	EXPECT_EQ(reader.readAll(), expected);
+	if (LogArchiver::available(Compression::Gzip) != Compression::None)
+	{
+		EXPECT_LT(std::filesystem::file_size(path) * 3, expected.size());
+	}
+
+	std::string window;
+	for (int second = 1000; second <= 1100; ++second)
+		window += record(second);
+	EXPECT_EQ(reader.read(start + 1000s, start + 1100s), window);
+
+	// a writer that died mid-footer: the blocks are still found by walking their headers
+	std::filesystem::resize_file(path, std::filesystem::file_size(path) - 5);
+	LogBlockReader torn(path);
+	ASSERT_TRUE(torn.isOpen());
+	EXPECT_EQ(torn.blocks().size(), reader.blocks().size());
+	EXPECT_EQ(torn.readAll(), expected);
+
+	std::error_code ignored;
+	std::filesystem::remove(path, ignored);
+}
+
+TEST_F(LogerrCoreFixture, SidecarIndexedQueryMatchesAFullScanAndSkipsBlocks)
+{
+	const auto path  = uniquePath(".log.txt");
+	const auto start = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now()) - 1h;
+	const auto level = [](int second) { return second % 250 == 0 ? "[ERROR]    " : second % 50 == 0 ? "[WARNING]  " : "[INFO]     "; };
+	const auto record = [&](int second)
+	{
+		std::string text = '[' + std::string(TimestampLite(start + std::chrono::seconds(second))) + "] [" +
+		                   (second % 3 == 0 ? "net" : "app") + "] " + level(second) + "record " + std::to_string(second) + '\n';
+		if (second % 250 == 0)
+			text += "    [0  ]   0x" + std::to_string(second) + ": file.cpp:1 | frame\n";    // travels with its record
+		return text;
+	};
+	const auto writeRecords = [&](int first, int last)
+	{
+		LogFileWriter::Options options;
+		options.sidecarIndex    = true;
+		options.indexBlockBytes = 4096;
+		options.batchBytes      = 1024;
+		LogFileWriter writer(path.string(), options);
+		for (int second = first; second < last; ++second)
+			writer.write(record(second));
+	};
+	writeRecords(0, 3000);
+	writeRecords(3000, 3010);    // reopened: the index continues
+
+	const auto logBytes = std::filesystem::file_size(path);
+	const auto entries  = LogQuery::readIndex(path, logBytes);
+	ASSERT_GT(entries.size(), 20u);
+	EXPECT_EQ(entries.front().offset, 0u);
+	EXPECT_EQ(entries.back().offset + entries.back().bytes, logBytes) << "a closed writer leaves the whole log indexed";
+	EXPECT_EQ(std::count_if(entries.begin(), entries.end(), [](const LogIndexEntry& entry) { return entry.levels & LogQuery::levelBit(logerr::Level::Error); }), 13)
+	    << "the level bitmap names the blocks holding an ERROR";
+
+	const auto run = [&](const LogQuery& query)
+	{
+		std::string matches;
+		query.run(path, [&](std::string_view text) { matches.append(text); });
+		return matches;
+	};
+
+	// the first ERROR from a point in time on, with its trace
+	LogQuery firstError;
+	firstError.from   = start + 1001s;
+	firstError.levels = LogQuery::levelBit(logerr::Level::Error);
+	firstError.limit  = 1;
+	EXPECT_EQ(run(firstError), record(1250));
+
+	// a window, a tag, levels and a substring together, against the same criteria checked record by record
+	LogQuery combined;
+	combined.from   = start + 500s;
+	combined.to     = start + 2500s;
+	combined.levels = LogQuery::levelBit(logerr::Level::Warning) | LogQuery::levelBit(logerr::Level::Error);
+	combined.tag    = "net";
+	combined.text   = "record 1";
+	std::string expected;
+	for (int second = 500; second <= 2500; ++second)
+	{
+		const std::string text = record(second);
+		if (second % 3 == 0 && second % 50 == 0 && text.find("record 1") != std::string::npos)
+			expected += text;
+	}
+	ASSERT_FALSE(expected.empty());
+	EXPECT_EQ(run(combined), expected);
+
+	LogQuery footer;
+	footer.text = "0x2750:";
+	EXPECT_EQ(run(footer), record(2750)) << "a match in a continuation line yields its whole record";
+
+	// the index only prunes: a torn index, and then none at all, give the same answers
+	const auto index = LogIndexWriter::sidecarPath(path);
+	std::filesystem::resize_file(index, std::filesystem::file_size(index) / 2 + 3);
+	EXPECT_EQ(run(firstError), record(1250));
+	EXPECT_EQ(run(combined), expected);
+	std::filesystem::remove(index);
+	EXPECT_EQ(run(firstError), record(1250));
+	EXPECT_EQ(run(combined), expected);
+
+	std::error_code ignored;
+	std::filesystem::remove(path, ignored);
+}
+
+TEST_F(LogerrCoreFixture, BinaryLogDecodesToTheExactTextAtAFractionOfItsSize)
+{
+	const auto path = uniquePath(".logb");
+
+	std::ostringstream captured;
+	auto* const        originalBuffer = std::cout.rdbuf(captured.rdbuf());
+	std::string        text;
+	{
+		LogFileWriter::Options options;
+		options.format = LogFileWriter::Format::Binary;
+		LogFileWriter writer(path.string(), options);
+		{
+			LogStream logger(std::cout);
+			logger.registerLogFunction("file",
+			                           [&](const LogRecord& record)
+			                           {
+				                           text += record.view();
+				                           writer.write(record);
+			                           });
+			for (int request = 0; request < 2000; ++request)
+			{
+				LOGINFO_FMT("request {} took {} us", request, request % 97);
+				if (request % 500 == 0)
+				{
+					LOGWARNING_FMT("slow {} {:>6} {}", std::string_view("path"), -request, request % 2 == 0);
+					LOGWARNING << "streamed " << request << ENDL;
+				}
+			}
+			std::cout << "a line with no prefix\n";
+			logger.flush();
+		}
+	}
+	std::cout.rdbuf(originalBuffer);
+
+	std::ifstream     file(path, std::ios::binary);
+	const std::string binary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	ASSERT_TRUE(binary.starts_with(LogBinaryEncoder::magic));
+	EXPECT_LT(binary.size() * 5, text.size()) << binary.size() << " bytes for " << text.size() << " bytes of text";
+
+	// decoded a chunk at a time, an entry cut off by one chunk is finished by the next
+	LogBinaryDecoder decoder;
+	std::string      decoded;
+	std::string      pending;
+	for (std::size_t offset = 0; offset < binary.size(); offset += 1000)
+	{
+		pending += binary.substr(offset, 1000);
+		pending.erase(0, decoder.decode(pending, decoded));
+		ASSERT_TRUE(decoder.ok());
+	}
+	EXPECT_TRUE(pending.empty());
+	EXPECT_EQ(decoded, text);
+
+	std::error_code ignored;
+	std::filesystem::remove(path, ignored);
+}
+
+TEST_F(LogerrCoreFixture, FlightRecorderKeepsTheNewestRecordsThroughWrapsAndRestarts)
+{
+	const auto path = uniquePath(".flight");
+	std::string recorded;
+	{
+		FlightRecorder recorder(path.string(), 4096);
+		ASSERT_TRUE(recorder.isOpen());
+		EXPECT_EQ(FlightRecorder::active(), &recorder);
+		EXPECT_FALSE(FlightRecorder(path.string(), 4096).isOpen()) << "a second writer must not share the ring";
+
+		for (int line = 0; line < 500; ++line)
+			recorder.record("line " + std::to_string(line) + '\n');
+		std::this_thread::sleep_for(50ms);
+		recorder.record("last\n");
+
+		// the ring wrapped many times: what is left is a contiguous run of the newest records
+		recorded = recorder.recent(std::chrono::nanoseconds::max());
+		ASSERT_TRUE(recorded.ends_with("line 499\nlast\n")) << recorded;
+		ASSERT_TRUE(recorded.starts_with("line "));
+		EXPECT_LT(recorded.size(), 4096u);
+		const int first = std::stoi(recorded.substr(5));
+		std::string expected;
+		for (int line = first; line < 500; ++line)
+			expected += "line " + std::to_string(line) + '\n';
+		EXPECT_EQ(recorded, expected + "last\n");
+
+		EXPECT_EQ(recorder.recent(10ms), "last\n");
+		EXPECT_EQ(FlightRecorder::recover(path, std::chrono::nanoseconds::max()), recorded) << "readable while it is live";
+	}
+	EXPECT_EQ(FlightRecorder::active(), nullptr);
+
+	// after the process is gone the records are still there, and a restart sets them aside instead of recording over them
+	EXPECT_EQ(FlightRecorder::recover(path, std::chrono::nanoseconds::max()), recorded);
+	const auto previous = path.string() + std::string(FlightRecorder::previousSuffix);
+	{
+		FlightRecorder reopened(path.string(), 4096);
+		ASSERT_TRUE(reopened.isOpen());
+		EXPECT_EQ(reopened.path(), path.string());
+		reopened.record("after restart\n");
+		EXPECT_EQ(reopened.recent(std::chrono::nanoseconds::max()), "after restart\n");
+		EXPECT_EQ(FlightRecorder::recover(previous, std::chrono::nanoseconds::max()), recorded);
+	}
+	{
+		FlightRecorder again(path.string(), 8192);
+		EXPECT_EQ(FlightRecorder::recover(previous, std::chrono::nanoseconds::max()), "after restart\n");
+	}
+
+	std::error_code ignored;
+	std::filesystem::remove(path, ignored);
+	std::filesystem::remove(previous, ignored);
+}
+
+TEST_F(LogerrCoreFixture, LogFileWriterAppliesItsOverflowPolicyWhileTheDiskStalls)
+{
+	const auto lines = [](int first, int last, std::string_view label = "")
+	{
+		std::string text;
+		for (int line = first; line < last; ++line)
+			text += std::string(label) + "line " + std::to_string(line) + '\n';
+		return text;
+	};
+
+	// Each run: one record gets the worker stuck in a write, then 100 more arrive for a queue that holds 8.
+	const auto run = [&](QueueLimits limits, const std::function<void(LogFileWriter&, SlowDisk&)>& whileStalled = {})
+	{
+		SlowDisk disk;
+		{
+			LogFileWriter writer(uniquePath(".log").string(), disk.options(limits));
+			writer.write("first\n");
+			disk.waitUntilStalled();
+			for (int line = 0; line < 100; ++line)
+				writer.write("line " + std::to_string(line) + '\n');
+			if (whileStalled)
+				whileStalled(writer, disk);
+			disk.release();
+		}
+		return disk.contents();
+	};
+
+	std::string written = run({.maxEntries = 8, .policy = OverflowPolicy::DropNewest});
+	EXPECT_TRUE(written.starts_with("first\n" + lines(0, 8))) << written;
+	EXPECT_TRUE(written.ends_with("[WARNING]  92 lines dropped (log file queue full)\n")) << written;
+
+	written = run({.maxEntries = 8, .policy = OverflowPolicy::DropOldest});
+	EXPECT_TRUE(written.starts_with("first\n" + lines(92, 100))) << written;
+	EXPECT_TRUE(written.ends_with("92 lines dropped (log file queue full)\n")) << written;
+
+	written = run({.maxEntries = 8, .policy = OverflowPolicy::Block, .blockTimeout = 1ms});
+	EXPECT_TRUE(written.starts_with("first\n" + lines(0, 8))) << written;
+	EXPECT_TRUE(written.ends_with("92 lines dropped (log file queue full)\n")) << written;
+
+	// INFO is dropped, and a WARNING once its wait for room times out, but an ERROR is queued past the limits at once.
+	written = run({.maxEntries = 8, .policy = OverflowPolicy::DropBelowLevel, .blockTimeout = 1ms, .keepFrom = logerr::Level::Warning},
+	              [](LogFileWriter& writer, SlowDisk&)
+	              {
+		              writer.write("[WARNING]  timed out\n", logerr::Level::Warning);
+		              writer.write("[ERROR]    still here\n", logerr::Level::Error);
+	              });
+	EXPECT_TRUE(written.starts_with("first\n" + lines(0, 8))) << written;
+	EXPECT_EQ(written.find("[WARNING]  timed out\n"), std::string::npos) << written;
+	EXPECT_NE(written.find("[ERROR]    still here\n"), std::string::npos) << written;
+	EXPECT_NE(written.find("93 lines dropped (log file queue full)\n"), std::string::npos) << written;
+}
+
+TEST_F(LogerrCoreFixture, AStalledLogFileDoesNotStallTheOtherSinks)
+{
+	// The file writer is a sink on the LogStream backend: however long its disk hangs, the backend must keep going.
+	constexpr int      lineCount = 1000;
+	SlowDisk           disk;
+	std::atomic<int>   received{0};
+	std::ostringstream captured;
+	auto* const        originalBuffer = std::cout.rdbuf(captured.rdbuf());
+	{
+		LogFileWriter writer(uniquePath(".log").string(),
+		                     disk.options({.maxEntries = 8, .policy = OverflowPolicy::DropBelowLevel, .blockTimeout = 10ms}));
+		LogStream logger(std::cout);
+		logger.registerLogFunction("file", [&writer](const LogRecord& record) { writer.write(record); });
+		logger.registerLogFunction("other", [&received](const LogRecord&) { ++received; });
+		{
+			std::jthread producer(
+			    [&]
+			    {
+				    LOGWARNING << "stalls the disk" << ENDL;
+				    disk.waitUntilStalled();
+				    for (int line = 0; line < lineCount; ++line)
+					    LOGWARNING << "warning " << line << ENDL;
+			    });
+			for (int wait = 0; wait < 1000 && received < lineCount + 1; ++wait)
+				std::this_thread::sleep_for(10ms);
+			EXPECT_EQ(received, lineCount + 1) << "the other sink stopped receiving while the file's disk hung";
+			disk.release();
+		}
+		logger.flush();
+	}
+	std::cout.rdbuf(originalBuffer);
+	EXPECT_TRUE(disk.contents().ends_with("lines dropped (log file queue full)\n")) << disk.contents();
+}
+
 TEST_F(LogerrCoreFixture, LogFileWriterReportsAnUnopenableDestinationWithoutThrowing)
 {
 	const auto directory = uniquePath("-directory");
@@ -521,6 +1592,35 @@ TEST_F(LogerrCoreFixture, TimestampAndSourceFilenameArePortable)
 	EXPECT_EQ(logerr::sourceFilename("source.cpp"), std::string_view("source.cpp"));
 }
 
+TEST_F(LogerrCoreFixture, CachedTimestampRenderingMatchesLocalTime)
+{
+	using namespace std::chrono;
+	const auto second = floor<seconds>(system_clock::now());
+	const auto time_c = system_clock::to_time_t(second);
+	std::tm    localTime{};
+#ifdef _WIN32
+	ASSERT_EQ(localtime_s(&localTime, &time_c), 0);
+#else
+	ASSERT_NE(localtime_r(&time_c, &localTime), nullptr);
+#endif
+	char expected[32]{};
+	ASSERT_EQ(std::strftime(expected, sizeof(expected), "%Y-%m-%d %H:%M:%S", &localTime), 19U);
+
+	// two renders in the same second share the cached prefix; only the fraction differs
+	const auto first  = static_cast<std::string>(TimestampLite(second + nanoseconds(123)));
+	const auto later = static_cast<std::string>(TimestampLite(second + nanoseconds(987654321)));
+	EXPECT_EQ(first.substr(0, 30), std::string(expected) + ".000000123 ") << first;
+	EXPECT_EQ(later.substr(0, 30), std::string(expected) + ".987654321 ") << later;
+	EXPECT_EQ(first.substr(30), later.substr(30)) << "same timezone";
+
+	// a different second re-renders, and write() never exceeds maxLength
+	char       buffer[TimestampLite::maxLength];
+	const auto length = TimestampLite(second - hours(24 * 400)).write(buffer);
+	ASSERT_GT(length, 30U);
+	EXPECT_NE(std::string_view(buffer, 19), std::string_view(expected));
+	EXPECT_EQ(std::string_view(buffer + 19, 11), ".000000000 ");
+}
+
 TEST_F(LogerrCoreFixture, ErrorLoggingAddsSourceContextAndOptionalTrace)
 {
 	std::ostringstream captured;
@@ -562,6 +1662,137 @@ TEST_F(LogerrCoreFixture, ErrorLoggingAddsSourceContextAndOptionalTrace)
 	static_cast<void>(traceLine);
 }
 
+TEST_F(LogerrCoreFixture, DeferredFormatIsRenderedByTheBackendLikeTheStreamingMacros)
+{
+	std::ostringstream       captured;
+	auto* const              originalBuffer = std::cout.rdbuf(captured.rdbuf());
+	std::vector<std::string> lines;
+	int                      warningLine = 0;
+	{
+		LogStream logger(std::cout);
+		logger.registerLogFunction("collector", [&](std::string text) { lines.push_back(std::move(text)); });
+
+		std::string text = "two";
+		LOGINFO_FMT("x={} y={} z={} {{literal}} {}", 1, text, 2.5, Streamable{7});
+		text = "changed after the call";
+		warningLine = __LINE__ + 1;
+		LOGWARNING_FMT("no arguments");
+		logger.flush();
+	}
+	std::cout.rdbuf(originalBuffer);
+
+	ASSERT_EQ(lines.size(), 2U);
+	EXPECT_EQ(lines[0].front(), '[');
+	EXPECT_NE(lines[0].find("] [" + APPINFO::name() + "] [INFO]     x=1 y=two z=2.5 {literal} S7\n"), std::string::npos) << lines[0];
+	EXPECT_NE(lines[1].find("[WARNING]  [test_logerr.cpp:" + std::to_string(warningLine) + ' '), std::string::npos) << lines[1];
+	EXPECT_TRUE(lines[1].ends_with("]  no arguments\n")) << lines[1];
+	EXPECT_TRUE(captured.str().empty());
+}
+
+TEST_F(LogerrCoreFixture, DeferredFormatFallsBackToSynchronousOutputWithoutALogStream)
+{
+	std::ostringstream captured;
+	auto* const        originalBuffer = std::cout.rdbuf(captured.rdbuf());
+	const char*        missing        = nullptr;
+	LOGDEBUG_FMT("{1}-{0} {} {}", "a", std::string_view("b"), missing, true);
+	std::cout.rdbuf(originalBuffer);
+
+	EXPECT_NE(captured.str().find("[DEBUG]    b-a (null) true\n"), std::string::npos) << captured.str();
+}
+
+TEST_F(LogerrCoreFixture, SuppressedLevelsSkipArgumentEvaluation)
+{
+	int evaluations = 0;
+	const auto counted = [&evaluations] { return ++evaluations; };
+
+	std::ostringstream captured;
+	auto* const        originalBuffer = std::cout.rdbuf(captured.rdbuf());
+	logerr::setLevel(logerr::Level::Warning);
+	EXPECT_EQ(logerr::level(), logerr::Level::Warning);
+	LOGDEBUG << "debug " << counted() << ENDL;
+	LOGINFO << "info " << counted() << ENDL;
+	LOGINFO_FMT("info fmt {}", counted());
+	if (evaluations == 0)
+		LOGWARNING << "warning " << counted() << ENDL;
+	else
+		ADD_FAILURE() << "a suppressed statement evaluated its arguments";
+
+	LOGERR_DISABLE;
+	LOGWARNING << "disabled " << counted() << ENDL;
+	LOGERR << "disabled " << counted() << ENDL;
+	LOGERR_ENABLE;
+	EXPECT_EQ(logerr::level(), logerr::Level::Warning) << "disabling must not forget the level";
+
+	logerr::setLevel(logerr::Level::Off);
+	LOGERR << "off " << counted() << ENDL;
+	std::cout.rdbuf(originalBuffer);
+
+	EXPECT_EQ(evaluations, 1);
+	EXPECT_NE(captured.str().find("[WARNING]"), std::string::npos);
+	EXPECT_EQ(captured.str().find("[INFO]"), std::string::npos);
+	EXPECT_EQ(captured.str().find("[DEBUG]"), std::string::npos);
+}
+
+TEST_F(LogerrCoreFixture, TagLevelsOverrideTheGlobalLevel)
+{
+	std::ostringstream captured;
+	auto* const        originalBuffer = std::cout.rdbuf(captured.rdbuf());
+	logerr::setLevel(logerr::Level::Info);
+	ASSERT_TRUE(logerr::setTagLevel("chatty", logerr::Level::Error));
+	ASSERT_TRUE(logerr::setTagLevel("verbose", logerr::Level::Debug));
+
+	LOGINFO_TAG("chatty") << "hidden chatty info" << ENDL;
+	LOGDEBUG_TAG("verbose") << "shown verbose debug" << ENDL;
+	LOGDEBUG_TAG("other") << "hidden other debug" << ENDL;
+	LOGINFO_TAG("other") << "shown other info" << ENDL;
+
+	logerr::clearTagLevel("chatty");
+	LOGINFO_TAG("chatty") << "shown chatty info" << ENDL;
+	logerr::clearTagLevel("verbose");
+	logerr::clearTagLevel("never-set");
+	LOGDEBUG_TAG("verbose") << "hidden verbose debug" << ENDL;
+	std::cout.rdbuf(originalBuffer);
+
+	const std::string output = captured.str();
+	EXPECT_EQ(output.find("hidden"), std::string::npos) << output;
+	EXPECT_NE(output.find("] [verbose] [DEBUG]    shown verbose debug"), std::string::npos) << output;
+	EXPECT_NE(output.find("] [other] [INFO]     shown other info"), std::string::npos) << output;
+	EXPECT_NE(output.find("] [chatty] [INFO]     shown chatty info"), std::string::npos) << output;
+}
+
+TEST_F(LogerrCoreFixture, EachStatementHasOneStaticSiteDescriptorRenderedOnce)
+{
+	std::ostringstream captured;
+	auto* const        originalBuffer = std::cout.rdbuf(captured.rdbuf());
+	std::vector<const logerr::Site*> sites;
+	int                              warningLine = 0;
+	for (int i = 0; i < 3; ++i)
+	{
+		warningLine = __LINE__ + 1;
+		LOGWARNING_TAG("sited") << "pass " << i << (sites.push_back(&logerrSite_), "") << ENDL;
+	}
+	std::cout.rdbuf(originalBuffer);
+
+	ASSERT_EQ(sites.size(), 3U);
+	EXPECT_EQ(sites[0], sites[2]) << "one descriptor per expansion, not per call";
+	EXPECT_STREQ(sites[0]->file, "test_logerr.cpp");
+	EXPECT_EQ(sites[0]->line, static_cast<std::uint32_t>(warningLine));
+	EXPECT_STREQ(sites[0]->tag, "sited");
+	EXPECT_EQ(sites[0]->level, logerr::Level::Warning);
+
+	const std::string location = "[sited] [WARNING]  [test_logerr.cpp:" + std::to_string(warningLine) + ' ';
+	const std::string output = captured.str();
+	std::size_t       count  = 0;
+	for (std::size_t pos = output.find(location); pos != std::string::npos; pos = output.find(location, pos + 1))
+		++count;
+	EXPECT_EQ(count, 3U) << output;
+
+	std::string rendered;
+	logerr::appendLocation(rendered, *sites[0]);
+	logerr::appendLocation(rendered, *sites[0]);
+	EXPECT_EQ(rendered.substr(0, rendered.size() / 2), rendered.substr(rendered.size() / 2));
+}
+
 TEST_F(LogerrCoreFixture, TimestampFormattingIsSafeUnderConcurrency)
 {
 	constexpr int workerCount = 8;
@@ -616,6 +1847,19 @@ TEST_F(LogerrCoreFixture, AppInfoAccessorsAreCallableAndSystemDetailsAreStructur
 	EXPECT_NE(APPINFO::systemDetails().find("APPLICATION INFO:"), std::string::npos);
 }
 
+TEST_F(LogerrCoreFixture, AppInfoIdentityIsInternedAndLevelPrefixesArePrecomputed)
+{
+	EXPECT_EQ(&APPINFO::name(), &APPINFO::name());
+	EXPECT_EQ(&APPINFO::hostName(), &APPINFO::hostUniqueID());
+	EXPECT_EQ(&APPINFO::version(), &APPINFO::version());
+
+	const std::string_view info = logerr::levelPrefix(logerr::Level::Info);
+	EXPECT_EQ(info, "] [" + APPINFO::name() + "] [INFO]     ");
+	EXPECT_EQ(info.data(), logerr::levelPrefix(logerr::Level::Info).data()) << "built once";
+	EXPECT_EQ(logerr::levelPrefix(logerr::Level::Error), "] [" + APPINFO::name() + "] [ERROR]    ");
+	EXPECT_EQ(logerr::levelPrefix(logerr::Level::Off), "] [" + APPINFO::name() + "] ");
+}
+
 // --- LOGERR always logs a stack trace, deduped per call site (logerr 1.2.2) -------------------------------------------
 // Capture std::cout for the duration of a block, restoring the original buffer on scope exit (RAII, exception-safe).
 namespace
@@ -803,6 +2047,41 @@ TEST_F(LogerrCoreFixture, EnqueueTracedErrorWritesAnExternalFooterVerbatim)
 	EXPECT_LT(output.find("executable not found on the buoy host"), output.find("origin: str-lin-7381"));
 }
 
+TEST_F(LogerrCoreFixture, TracedErrorsSymbolizedInParallelAreWrittenInEnqueueOrder)
+{
+	// The workers symbolize several entries at once and finish them out of order - a relayed footer is ready at once, a
+	// captured stack takes a symbolizer pass - yet the stream must read exactly as enqueued, each footer right under
+	// its own message.
+	CoutCapture capture;
+	void*       frames[16];
+	const int   captured = StackTrace::captureFramesSafely(frames, 16);
+	constexpr int entryCount = 200;
+	for (int i = 0; i < entryCount; ++i)
+	{
+		const std::string message = "ordered entry " + std::to_string(i) + '\n';
+		if (i % 3 == 0)
+			logerr::enqueueTracedError("[ts] [ERROR]    ", message, std::vector<void*>(frames, frames + captured), false);
+		else
+			logerr::enqueueTracedError("[ts] [ERROR]    ", message, "  relayed footer " + std::to_string(i));
+	}
+	logerr::flushTracedErrors();
+
+	const std::string output   = capture.str();
+	std::size_t       position = 0;
+	for (int i = 0; i < entryCount; ++i)
+	{
+		const std::size_t message = output.find("ordered entry " + std::to_string(i) + '\n', position);
+		ASSERT_NE(message, std::string::npos) << "entry " << i << " is missing or out of order";
+		const std::size_t next = output.find("ordered entry ", message + 1);
+		const std::string body = output.substr(message, next == std::string::npos ? std::string::npos : next - message);
+		if (i % 3 == 0)
+			EXPECT_NE(body.find("0x"), std::string::npos) << "entry " << i << " carries its symbolized trace";
+		else
+			EXPECT_NE(body.find("  relayed footer " + std::to_string(i) + '\n'), std::string::npos) << "entry " << i << " carries its own footer";
+		position = message + 1;
+	}
+}
+
 TEST_F(LogerrCoreFixture, LogErrEmitsTheFullTraceForEveryOccurrenceInTheStream)
 {
 	logerr::resetTracedSites();
@@ -924,6 +2203,78 @@ TEST_F(LogerrCoreFixture, CapturedTraceRetainsItsRawFrames)
 	EXPECT_NE(reFormatted.find("0x"), std::string::npos);
 }
 
+TEST_F(LogerrCoreFixture, SymbolCacheServesRepeatedFramesAndStaysBounded)
+{
+	// bounded, least recently used out first, with hits and misses counted
+	SymbolCache cache(16);    // one frame per shard
+	const SymbolCache::Key first{1, 0x10};
+	cache.insert(first, {"a.cpp:1", "alpha()"});
+	EXPECT_FALSE(cache.find({1, 0x20}).has_value());
+	const auto found = cache.find(first);
+	ASSERT_TRUE(found.has_value());
+	EXPECT_EQ(found->location, "a.cpp:1");
+	EXPECT_EQ(found->function, "alpha()");
+	for (std::uint64_t offset = 0; offset < 1000; ++offset)
+		cache.insert({2, offset}, {"b.cpp:" + std::to_string(offset), "beta()"});
+	SymbolCache::Stats stats = cache.stats();
+	EXPECT_LE(stats.entries, 16u);
+	EXPECT_GE(stats.evictions, 1000u - 16u);
+	EXPECT_EQ(stats.hits, 1u);
+	EXPECT_EQ(stats.misses, 1u);
+	EXPECT_DOUBLE_EQ(stats.hitRate(), 0.5);
+	cache.setCapacity(0);
+	EXPECT_EQ(cache.stats().entries, 0u);
+
+	// the symbolizer's: a trace symbolized again resolves every frame from the cache, to the same text
+	SymbolCache::instance().clear();
+	void*                    frames[32];
+	const int                count     = StackTrace::captureFramesSafely(frames, 32);
+	const std::string        cold      = StackTrace::formatFrames(frames, count);
+	const SymbolCache::Stats afterCold = SymbolCache::instance().stats();
+	const std::string        warm      = StackTrace::formatFrames(frames, count);
+	stats = SymbolCache::instance().stats();
+	EXPECT_EQ(warm, cold);
+#ifndef _WIN32
+	EXPECT_GT(afterCold.misses, 0u);
+	EXPECT_EQ(stats.misses, afterCold.misses) << "no frame is looked up twice";
+	EXPECT_EQ(stats.hits - afterCold.hits, afterCold.misses);
+#endif
+}
+
+TEST_F(LogerrCoreFixture, FramesResolveTheSameBeforeAndAfterTheFunctionIndexIsBuilt)
+{
+	// each module's function index is built in the background the first time the module is touched; a trace looked up
+	// before it is published and one looked up after must not tell the difference
+	void*     frames[32];
+	const int count = StackTrace::captureFramesSafely(frames, 32);
+	SymbolCache::instance().clear();
+	const std::string early = StackTrace::formatFrames(frames, count);
+	std::this_thread::sleep_for(std::chrono::milliseconds(500));
+	SymbolCache::instance().clear();
+	const std::string late = StackTrace::formatFrames(frames, count);
+	EXPECT_EQ(late, early);
+	EXPECT_FALSE(late.empty());
+}
+
+TEST_F(LogerrCoreFixture, PrewarmedSymbolsBecomeReadyInTheBackground)
+{
+	// prewarming returns at once, finishes on its own thread, and a second start is harmless
+	void*     frames[32];
+	const int count = StackTrace::captureFramesSafely(frames, 32);
+	SymbolCache::instance().clear();
+	const std::string before = StackTrace::formatFrames(frames, count);
+
+	logerr::prewarmSymbols();
+	logerr::prewarmSymbols();
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+	while (!logerr::symbolsReady() && std::chrono::steady_clock::now() < deadline)
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	ASSERT_TRUE(logerr::symbolsReady());
+
+	SymbolCache::instance().clear();
+	EXPECT_EQ(StackTrace::formatFrames(frames, count), before);
+}
+
 TEST_F(LogerrCoreFixture, SuppressedDuplicateTraceStillRetainsItsFrames)
 {
 	// A trace collapsed as a duplicate stack (empty formatted value) must STILL retain its frames, so a caller can
@@ -1216,3 +2567,63 @@ TEST_F(LogerrCoreFixture, SymbolizationStaysSafeAfterFlushingTheWorker)
 		EXPECT_NE(output.find("0x"), std::string::npos) << "and still carries its trace";
 	}
 }
+
+TEST_F(LogerrCoreFixture, TracedErrorsReachTheFileOncePerStackByTheirFingerprint)
+{
+	// The trace worker stamps every traced error with where its footer starts and a fingerprint of the raw stack, so the
+	// file writer collapses a repeat without scanning the text. The SAME LOGERR line hit in a loop is the same stack.
+	logerr::resetTracedSites();
+	std::ostringstream     captured;
+	auto* const            originalBuffer = std::cout.rdbuf(captured.rdbuf());
+	std::vector<LogRecord> records;
+	{
+		LogStream logger(std::cout);
+		logger.registerLogFunction("collector", [&](const LogRecord& record) { records.push_back(record); });
+		LOGINFO << "plain line" << ENDL;
+		for (int i = 0; i < 2; ++i)
+			LOGERR << "fingerprinted failure " << i << ENDL;
+		logerr::flushTracedErrors();
+		logger.flush();
+	}
+	std::cout.rdbuf(originalBuffer);
+
+	ASSERT_EQ(records.size(), 3U);
+	EXPECT_EQ(records[0].trace().stack, 0U) << "an untraced line carries no trace";
+	for (const LogRecord& record : {records[1], records[2]})
+	{
+		const LogRecord::Trace trace = record.trace();
+		ASSERT_NE(trace.stack, 0U) << record.view();
+		ASSERT_LT(trace.offset, record.size());
+		EXPECT_EQ(record.view().substr(0, trace.offset).find("0x"), std::string_view::npos) << "the message precedes the footer";
+		EXPECT_NE(record.view().substr(trace.offset).find("0x"), std::string_view::npos) << "the footer holds the frames";
+	}
+	EXPECT_EQ(records[1].trace().stack, records[2].trace().stack) << "the same stack fingerprints the same";
+
+	// The writer remembers only the most recent stacks: with room for one, a stack displaced by another traces again.
+	const auto path  = uniquePath(".log");
+	const auto entry = [](const std::string& message, const std::string& frame, std::uint64_t stack)
+	{
+		return LogRecord(message + "    [0  ]   0x1: " + frame + '\n', {.stack = stack, .offset = static_cast<std::uint32_t>(message.size())},
+		                 logerr::Level::Error);
+	};
+	{
+		LogFileWriter::Options options;
+		options.traceDedupStacks = 1;
+		LogFileWriter writer(path.string(), options);
+		writer.write(entry("[ERROR]    a first\n", "a.cpp:1", 0xA));
+		writer.write(entry("[ERROR]    a again\n", "a.cpp:1", 0xA));
+		writer.write(entry("[ERROR]    b first\n", "b.cpp:2", 0xB));
+		writer.write(entry("[ERROR]    a after b\n", "a.cpp:1", 0xA));
+		writer.write("[INFO]     [0  ]   0x2: looks like a frame, but carries no trace\n");
+		writer.write("[INFO]     [0  ]   0x2: looks like a frame, but carries no trace\n");
+	}
+	std::ifstream     input(path);
+	const std::string contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+	EXPECT_EQ(occurrences(contents, "a.cpp:1"), 2U) << contents;
+	EXPECT_EQ(occurrences(contents, "b.cpp:2"), 1U) << contents;
+	EXPECT_EQ(occurrences(contents, "trace deduplicated"), 1U) << contents;
+	EXPECT_NE(contents.find("a again\n    (trace deduplicated"), std::string::npos) << contents;
+	EXPECT_EQ(occurrences(contents, "carries no trace"), 2U) << "text is never scanned for a footer";
+	std::error_code ignored;
+	std::filesystem::remove(path, ignored);
+}
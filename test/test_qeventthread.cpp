@@ -286,20 +286,24 @@ namespace
 	{
 		const auto path = std::filesystem::temp_directory_path() /
 		                  ("logerr-dedup-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".txt");
-		// A frame line matches the "[<n>] ... 0x..." shape formatFrames emits; two entries carry the IDENTICAL footer,
-		// one carries a DIFFERENT footer. The file writer must record the first full, collapse the repeat to the note,
-		// and record the different footer in full - the on-disk dedup contract (the GUI dock, a separate sink, is
-		// unaffected: it never sees the file writer).
+		// Two entries carry the IDENTICAL stack, one carries a DIFFERENT stack; each record says where its footer starts
+		// and which stack it is, as the trace worker stamps them. The file writer must record the first full, collapse
+		// the repeat to the note, and record the different footer in full - the on-disk dedup contract (the GUI dock, a
+		// separate sink, is unaffected: it never sees the file writer).
 		const std::string footerA =
 		    "    [0  ]   0x00007ff000000001: a.cpp:10                | foo\n"
 		    "    [1  ]   0x00007ff000000002: b.cpp:20                | bar\n";
 		const std::string footerB =
 		    "    [0  ]   0x00007ff000000003: c.cpp:30                | baz\n";
+		const auto traced = [](const std::string& message, const std::string& footer, std::uint64_t stack)
+		{
+			return LogRecord(message + footer, {.stack = stack, .offset = static_cast<std::uint32_t>(message.size())}, logerr::Level::Error);
+		};
 		{
 			LogFileWriter writer(path.string());
-			writer.write("[t] [m] [ERROR]    boom\n" + footerA);    // first: full
-			writer.write("[t] [m] [ERROR]    boom again\n" + footerA);    // repeat of footerA: collapsed
-			writer.write("[t] [m] [ERROR]    different\n" + footerB);    // new footer: full
+			writer.write(traced("[t] [m] [ERROR]    boom\n", footerA, 0xA));          // first: full
+			writer.write(traced("[t] [m] [ERROR]    boom again\n", footerA, 0xA));    // repeat of footerA: collapsed
+			writer.write(traced("[t] [m] [ERROR]    different\n", footerB, 0xB));     // new footer: full
 		}
 		std::ifstream    file(path);
 		const std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
@@ -0,0 +1,91 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LOGERR DECODE
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+//
+/// @file	logerrDecode.cpp
+/// @brief	Prints a binary log (LogFileWriter::Format::Binary) in the text layout.
+/// @details
+///		Usage: `logerr-decode <file.logb> [output]`. Writes to standard output when no output path is
+///		given. Timestamps are rendered in the local time zone, so run it with the TZ the log was written
+///		in. A torn last entry (the writer was killed mid-batch) is reported and skipped.
+//
+//--------------------------------------------------------------------------------------------------
+
+//----------------------------
+//  INCLUDES
+//----------------------------
+
+#include <LogBinary.h>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, const char* argv[])
+{
+	if (argc < 2 || argc > 3)
+	{
+		std::cerr << "usage: logerr-decode <file.logb> [output]\n";
+		return 2;
+	}
+
+	std::ifstream input(argv[1], std::ios::binary);
+	if (!input)
+	{
+		std::cerr << "logerr-decode: cannot open " << argv[1] << '\n';
+		return 1;
+	}
+
+	std::ofstream file;
+	if (argc == 3)
+	{
+		file.open(argv[2], std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			std::cerr << "logerr-decode: cannot create " << argv[2] << '\n';
+			return 1;
+		}
+	}
+	std::ostream& output = argc == 3 ? static_cast<std::ostream&>(file) : std::cout;
+
+	LogBinaryDecoder  decoder;
+	std::vector<char> chunk(1024 * 1024);
+	std::string       pending;    // the start of an entry the previous chunk cut off
+	std::string       text;
+	while (input.read(chunk.data(), static_cast<std::streamsize>(chunk.size())).gcount() > 0)
+	{
+		pending.append(chunk.data(), static_cast<std::size_t>(input.gcount()));
+		text.clear();
+		pending.erase(0, decoder.decode(pending, text));
+		output.write(text.data(), static_cast<std::streamsize>(text.size()));
+		if (!decoder.ok())
+		{
+			std::cerr << "logerr-decode: " << argv[1] << " is damaged, or not a binary log\n";
+			return 1;
+		}
+	}
+
+	if (!pending.empty())
+		std::cerr << "logerr-decode: skipped a torn last entry (" << pending.size() << " bytes)\n";
+	return output.flush() ? 0 : 1;
+}
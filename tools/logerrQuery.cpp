@@ -0,0 +1,195 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LOGERR QUERY
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+//
+/// @file	logerrQuery.cpp
+/// @brief	Prints the records of a text log that match a time window, levels, a tag and a substring.
+/// @details
+///		Usage: `logerr-query <file.log.txt> [options]`
+///
+///			--from TIME       records stamped at or after TIME
+///			--to TIME         records stamped at or before TIME
+///			--level LEVELS    comma-separated debug, info, warning, error; "warning+" for that level and above
+///			--tag TAG         records whose [tag] (or application) field is TAG
+///			--grep TEXT       records containing TEXT, trace footers included
+///			--first           stop at the first match; --limit N to stop at the N-th
+///			--count           print the number of matches instead of the records
+///
+///		TIME is "YYYY-mm-dd HH:MM[:SS[.fraction]]", or "HH:MM[:SS[.fraction]]" on the day of the log's
+///		first record, in the local time zone the log was written in. The log's sidecar index
+///		(LogFileWriter::Options::sidecarIndex) lets the query skip the blocks that cannot match; without
+///		one the whole log is scanned.
+//
+//--------------------------------------------------------------------------------------------------
+
+//----------------------------
+//  INCLUDES
+//----------------------------
+
+#include <LogIndex.h>
+#include <logSite.h>
+#include <timestampLite.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace
+{
+	constexpr std::string_view usage =
+	    "usage: logerr-query <file.log.txt> [--from TIME] [--to TIME] [--level LEVELS] [--tag TAG] [--grep TEXT]\n"
+	    "                    [--first | --limit N] [--count]\n";
+
+	/// @brief		TIME as a moment, the date taken from the log's first record when TIME has none.
+	std::optional<LogQuery::time_point> parseTime(std::string_view time, const char* log)
+	{
+		constexpr std::string_view shape = "0000-00-00 00:00:00.000000000";
+		std::string                complete(time);
+		if (time.size() >= 5 && time[2] == ':')
+		{
+			std::ifstream file(log, std::ios::binary);
+			std::string   firstLine;
+			std::getline(file, firstLine);
+			if (firstLine.size() < 11 || firstLine.front() != '[')
+				return std::nullopt;
+			complete = firstLine.substr(1, 10) + ' ' + complete;
+		}
+		if (complete.size() < 16 || complete.size() > shape.size())
+			return std::nullopt;
+		complete += shape.substr(complete.size());
+		return TimestampLite::parse(complete);
+	}
+
+	/// @brief		LEVELS as LogQuery::levels.
+	std::optional<std::uint32_t> parseLevels(std::string_view levels)
+	{
+		using logerr::Level;
+		constexpr std::pair<std::string_view, Level> names[] = {
+		    {"debug", Level::Debug}, {"info", Level::Info}, {"warning", Level::Warning}, {"error", Level::Error}};
+
+		std::uint32_t bits = 0;
+		while (!levels.empty())
+		{
+			std::string_view name = levels.substr(0, levels.find(','));
+			levels.remove_prefix(std::min(levels.size(), name.size() + 1));
+			const bool andAbove = name.ends_with('+');
+			if (andAbove)
+				name.remove_suffix(1);
+
+			const auto* found = std::find_if(std::begin(names), std::end(names), [name](const auto& entry) { return entry.first == name; });
+			if (found == std::end(names))
+				return std::nullopt;
+			for (const auto* level = found; level != (andAbove ? std::end(names) : found + 1); ++level)
+				bits |= LogQuery::levelBit(level->second);
+		}
+		if (bits == 0)
+			return std::nullopt;
+		return bits;
+	}
+}    // namespace
+
+int main(int argc, const char* argv[])
+{
+	if (argc < 2)
+	{
+		std::cerr << usage;
+		return 2;
+	}
+
+	const char* log   = argv[1];
+	LogQuery    query;
+	bool        count = false;
+	for (int i = 2; i < argc; ++i)
+	{
+		const std::string_view option = argv[i];
+		if (option == "--first")
+		{
+			query.limit = 1;
+			continue;
+		}
+		if (option == "--count")
+		{
+			count = true;
+			continue;
+		}
+		if (i + 1 == argc)
+		{
+			std::cerr << usage;
+			return 2;
+		}
+
+		const std::string_view value = argv[++i];
+		bool                   ok    = true;
+		if (option == "--from" || option == "--to")
+		{
+			const auto time = parseTime(value, log);
+			ok              = time.has_value();
+			(option == "--from" ? query.from : query.to) = time;
+		}
+		else if (option == "--level")
+		{
+			const auto levels = parseLevels(value);
+			ok                = levels.has_value();
+			query.levels      = levels.value_or(LogQuery::allLevels);
+		}
+		else if (option == "--tag")
+			query.tag = value;
+		else if (option == "--grep")
+			query.text = value;
+		else if (option == "--limit")
+			ok = std::from_chars(value.data(), value.data() + value.size(), query.limit).ptr == value.data() + value.size();
+		else
+			ok = false;
+
+		if (!ok)
+		{
+			std::cerr << "logerr-query: bad option: " << option << ' ' << value << '\n' << usage;
+			return 2;
+		}
+	}
+
+	try
+	{
+		const std::size_t matches = query.run(log,
+		                                      [count](std::string_view record)
+		                                      {
+			                                      if (!count)
+				                                      std::cout.write(record.data(), static_cast<std::streamsize>(record.size()));
+		                                      });
+		if (count)
+			std::cout << matches << '\n';
+		return std::cout.flush() ? 0 : 1;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "logerr-query: " << e.what() << '\n';
+		return 1;
+	}
+}
@@ -0,0 +1,80 @@
+//--------------------------------------------------------------------------------------------------
+//
+//	LOGERR RECOVER
+//
+//--------------------------------------------------------------------------------------------------
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2026 Nic Holthaus
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the "Software"), to deal in the Software without
+// restriction, including without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.
+//
+//--------------------------------------------------------------------------------------------------
+//
+/// @file	logerrRecover.cpp
+/// @brief	Prints the records a crashed process left in its flight recorder (see FlightRecorder.h).
+/// @details
+///		Usage: `logerr-recover <file.flight> [seconds]`. Prints the records stamped within the given
+///		number of seconds of the newest one, or every record still in the ring when none is given.
+///		A restarted application sets the crashed run's file aside as `<file.flight>.prev`; pass
+///		that to read it. Given the live file, the tool points at the `.prev` one beside it.
+//
+//--------------------------------------------------------------------------------------------------
+
+//----------------------------
+//  INCLUDES
+//----------------------------
+
+#include <FlightRecorder.h>
+
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+int main(int argc, const char* argv[])
+{
+	if (argc < 2 || argc > 3)
+	{
+		std::cerr << "usage: logerr-recover <file.flight> [seconds]\n";
+		return 2;
+	}
+
+	auto window = std::chrono::nanoseconds::max();
+	if (argc == 3)
+	{
+		double      seconds = 0;
+		const char* end     = argv[2] + std::strlen(argv[2]);
+		if (std::from_chars(argv[2], end, seconds).ptr != end || seconds < 0)
+		{
+			std::cerr << "logerr-recover: not a number of seconds: " << argv[2] << '\n';
+			return 2;
+		}
+		window = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(seconds));
+	}
+
+	const std::string records  = FlightRecorder::recover(argv[1], window);
+	const std::string previous = argv[1] + std::string(FlightRecorder::previousSuffix);
+	if (!std::string_view(argv[1]).ends_with(FlightRecorder::previousSuffix) && std::filesystem::exists(previous))
+		std::cerr << "logerr-recover: the run before this one left its records in " << previous << '\n';
+	if (records.empty())
+	{
+		std::cerr << "logerr-recover: " << argv[1] << " holds no records, or is not a flight recorder\n";
+		return 1;
+	}
+	std::cout.write(records.data(), static_cast<std::streamsize>(records.size()));
+	return std::cout.flush() ? 0 : 1;
+}